@@ -37,17 +37,101 @@
 
 #include "PdfCanvas.h"
 #include "PdfInputDevice.h"
-#include "PdfOutputStream.h"
+#include "PdfInputStream.h"
 #include "PdfStream.h"
 #include "PdfVecObjects.h"
 #include "PdfData.h"
 #include "PdfDefinesPrivate.h"
 
 #include <iostream>
+#include <unordered_map>
 
 using namespace std;
 using namespace PoDoFo;
 
+static const unordered_map<string_view, EPdfContentsOperator> s_operators = {
+    { "w", EPdfContentsOperator::w },
+    { "J", EPdfContentsOperator::J },
+    { "j", EPdfContentsOperator::j },
+    { "M", EPdfContentsOperator::M },
+    { "d", EPdfContentsOperator::d },
+    { "ri", EPdfContentsOperator::ri },
+    { "i", EPdfContentsOperator::i },
+    { "gs", EPdfContentsOperator::gs },
+    { "q", EPdfContentsOperator::q },
+    { "Q", EPdfContentsOperator::Q },
+    { "cm", EPdfContentsOperator::cm },
+    { "m", EPdfContentsOperator::m },
+    { "l", EPdfContentsOperator::l },
+    { "c", EPdfContentsOperator::c },
+    { "v", EPdfContentsOperator::v },
+    { "y", EPdfContentsOperator::y },
+    { "h", EPdfContentsOperator::h },
+    { "re", EPdfContentsOperator::re },
+    { "S", EPdfContentsOperator::S },
+    { "s", EPdfContentsOperator::s },
+    { "f", EPdfContentsOperator::f },
+    { "F", EPdfContentsOperator::F },
+    { "f*", EPdfContentsOperator::f_Star },
+    { "B", EPdfContentsOperator::B },
+    { "B*", EPdfContentsOperator::B_Star },
+    { "b", EPdfContentsOperator::b },
+    { "b*", EPdfContentsOperator::b_Star },
+    { "n", EPdfContentsOperator::n },
+    { "W", EPdfContentsOperator::W },
+    { "W*", EPdfContentsOperator::W_Star },
+    { "BT", EPdfContentsOperator::BT },
+    { "ET", EPdfContentsOperator::ET },
+    { "Tc", EPdfContentsOperator::Tc },
+    { "Tw", EPdfContentsOperator::Tw },
+    { "Tz", EPdfContentsOperator::Tz },
+    { "TL", EPdfContentsOperator::TL },
+    { "Tf", EPdfContentsOperator::Tf },
+    { "Tr", EPdfContentsOperator::Tr },
+    { "Ts", EPdfContentsOperator::Ts },
+    { "Td", EPdfContentsOperator::Td },
+    { "TD", EPdfContentsOperator::TD },
+    { "Tm", EPdfContentsOperator::Tm },
+    { "T*", EPdfContentsOperator::T_Star },
+    { "Tj", EPdfContentsOperator::Tj },
+    { "TJ", EPdfContentsOperator::TJ },
+    { "'", EPdfContentsOperator::Quote },
+    { "\"", EPdfContentsOperator::DoubleQuote },
+    { "d0", EPdfContentsOperator::d0 },
+    { "d1", EPdfContentsOperator::d1 },
+    { "CS", EPdfContentsOperator::CS },
+    { "cs", EPdfContentsOperator::cs },
+    { "SC", EPdfContentsOperator::SC },
+    { "SCN", EPdfContentsOperator::SCN },
+    { "sc", EPdfContentsOperator::sc },
+    { "scn", EPdfContentsOperator::scn },
+    { "G", EPdfContentsOperator::G },
+    { "g", EPdfContentsOperator::g },
+    { "RG", EPdfContentsOperator::RG },
+    { "rg", EPdfContentsOperator::rg },
+    { "K", EPdfContentsOperator::K },
+    { "k", EPdfContentsOperator::k },
+    { "sh", EPdfContentsOperator::sh },
+    { "BI", EPdfContentsOperator::BI },
+    { "ID", EPdfContentsOperator::ID },
+    { "EI", EPdfContentsOperator::EI },
+    { "Do", EPdfContentsOperator::Do },
+    { "MP", EPdfContentsOperator::MP },
+    { "DP", EPdfContentsOperator::DP },
+    { "BMC", EPdfContentsOperator::BMC },
+    { "BDC", EPdfContentsOperator::BDC },
+    { "EMC", EPdfContentsOperator::EMC },
+    { "BX", EPdfContentsOperator::BX },
+    { "EX", EPdfContentsOperator::EX },
+};
+
+static bool hasOperandData(EPdfContentsOperandType eType)
+{
+    return eType == EPdfContentsOperandType::Name
+        || eType == EPdfContentsOperandType::String
+        || eType == EPdfContentsOperandType::HexString;
+}
+
 PdfContentsTokenizer::PdfContentsTokenizer(const PdfRefCountedInputDevice& device)
     : m_device(device), m_readingInlineImgData(false)
 {
@@ -107,13 +191,11 @@ bool PdfContentsTokenizer::tryReadNextToken(string_view& pszToken , EPdfTokenTyp
             return false;
         }
 
+        // The contents stream is decoded while it is tokenized, so
+        // only a window of the decoded data is held in memory
         PdfStream& pStream = m_lstContents.front()->GetOrCreateStream();
-        PdfRefCountedBuffer buffer;
-        PdfBufferOutputStream stream(&buffer);
-        pStream.GetFilteredCopy(&stream);
-
-        // TODO: Optimize me, the following copy the buffer
-        m_device = PdfRefCountedInputDevice(buffer.GetBuffer(), buffer.GetSize());
+        m_device = PdfRefCountedInputDevice(new PdfStreamInputDevice(
+            unique_ptr<PdfInputStream>(new PdfFilteredInputStream(pStream))));
 
 		m_lstContents.pop_front();
         hasToken = PdfTokenizer::TryReadNextToken(m_device, pszToken, peType);
@@ -203,6 +285,17 @@ bool PdfContentsTokenizer::TryReadNext(EPdfContentsType& reType, string_view& rp
 }
 
 bool PdfContentsTokenizer::ReadInlineImgData( EPdfContentsType& reType, PdfVariant & rVariant )
+{
+    string_view data;
+    if (!readInlineImgData(data))
+        return false;
+
+    rVariant = PdfData(data);
+    reType = EPdfContentsType::ImageData;
+    return true;
+}
+
+bool PdfContentsTokenizer::readInlineImgData(string_view& rData)
 {
     int  c;
     int64_t  counter  = 0;
@@ -229,8 +322,7 @@ bool PdfContentsTokenizer::ReadInlineImgData( EPdfContentsType& reType, PdfVaria
                 // EI is followed by whitespace => stop
                 m_device.Device()->Seek(-2, std::ios::cur); // put back "EI" 
                 GetBuffer().GetBuffer()[counter] = '\0';
-                rVariant = PdfData(string_view(GetBuffer().GetBuffer(), static_cast<size_t>(counter)));
-                reType = EPdfContentsType::ImageData;
+                rData = string_view(GetBuffer().GetBuffer(), static_cast<size_t>(counter));
                 m_readingInlineImgData = false;
                 return true;
             }
@@ -257,3 +349,206 @@ bool PdfContentsTokenizer::ReadInlineImgData( EPdfContentsType& reType, PdfVaria
     
     return false;
 }
+
+bool PdfContentsTokenizer::TryReadNextOperation(PdfContentsOperation& rOperation)
+{
+    m_operands.clear();
+    m_operandsData.clear();
+
+    EPdfTokenType eTokenType;
+    string_view pszToken;
+    while (tryReadNextToken(pszToken, &eTokenType))
+    {
+        if (eTokenType == EPdfTokenType::Delimiter)
+        {
+            switch (pszToken[0])
+            {
+                case '[':
+                    pushOperand(EPdfContentsOperandType::ArrayStart);
+                    continue;
+                case ']':
+                    pushOperand(EPdfContentsOperandType::ArrayEnd);
+                    continue;
+                case '<':
+                {
+                    if (pszToken.length() == 2)
+                    {
+                        pushOperand(EPdfContentsOperandType::DictionaryStart);
+                        continue;
+                    }
+
+                    // Decode the hex digits in place
+                    readHexString(m_device, m_vecBuffer);
+                    size_t lLen = m_vecBuffer.size() / 2;
+                    for (size_t i = 0; i < lLen; i++)
+                    {
+                        m_vecBuffer[i] = static_cast<char>((PdfTokenizer::GetHexValue(m_vecBuffer[2 * i]) << 4)
+                            | PdfTokenizer::GetHexValue(m_vecBuffer[2 * i + 1]));
+                    }
+
+                    pushOperand(EPdfContentsOperandType::HexString, m_vecBuffer.data(), lLen);
+                    continue;
+                }
+                case '>':
+                    if (pszToken.length() == 2)
+                    {
+                        pushOperand(EPdfContentsOperandType::DictionaryEnd);
+                        continue;
+                    }
+                    break;
+                case '(':
+                    readString(m_device, m_vecBuffer);
+                    pushOperand(EPdfContentsOperandType::String, m_vecBuffer.data(), m_vecBuffer.size());
+                    continue;
+                case '/':
+                {
+                    string_view name;
+                    readName(name);
+                    pushOperand(EPdfContentsOperandType::Name, name.data(), name.length());
+                    continue;
+                }
+                default:
+                    break;
+            }
+        }
+        else if (pszToken == "null")
+        {
+            pushOperand(EPdfContentsOperandType::Null);
+            continue;
+        }
+        else if (pszToken == "true" || pszToken == "false")
+        {
+            pushOperand(EPdfContentsOperandType::Bool, pszToken == "true" ? 1 : 0);
+            continue;
+        }
+        else
+        {
+            // Numbers are recognized as in DetermineDataType()
+            bool bNumber = true;
+            bool bReal = false;
+            for (char ch : pszToken)
+            {
+                if (ch == '.')
+                {
+                    bReal = true;
+                }
+                else if (!(isdigit(static_cast<unsigned char>(ch)) || ch == '-' || ch == '+'))
+                {
+                    bNumber = false;
+                    break;
+                }
+            }
+
+            if (bNumber)
+            {
+                pushOperand(EPdfContentsOperandType::Number,
+                    bReal ? ParseReal(pszToken) : static_cast<double>(ParseInteger(pszToken)));
+                continue;
+            }
+        }
+
+        // Anything else is an operator
+        auto found = s_operators.find(pszToken);
+        if (found == s_operators.end())
+        {
+            rOperation.Operator = EPdfContentsOperator::Unknown;
+            rOperation.Keyword = pszToken;
+        }
+        else
+        {
+            rOperation.Operator = found->second;
+            rOperation.Keyword = found->first;
+        }
+
+        rOperation.ImageData = { };
+        if (rOperation.Operator == EPdfContentsOperator::ID
+            && !readInlineImgData(rOperation.ImageData))
+        {
+            return false;
+        }
+
+        rOperation.Operands = m_operands.data();
+        rOperation.OperandCount = m_operands.size();
+        return true;
+    }
+
+    return false;
+}
+
+void PdfContentsTokenizer::readName(string_view& rName)
+{
+    // Empty names are handled as in ReadName()
+    int c = m_device.Device()->Look();
+    if (IsWhitespace(c))
+    {
+        rName = { };
+        return;
+    }
+
+    EPdfTokenType eType;
+    string_view pszToken;
+    bool gotToken = this->TryReadNextToken(m_device, pszToken, &eType);
+    if (!gotToken || eType != EPdfTokenType::Literal)
+    {
+        rName = { };
+        if (gotToken)
+            EnqueueToken(pszToken, eType);
+
+        return;
+    }
+
+    if (pszToken.find('#') == string_view::npos)
+    {
+        rName = pszToken;
+        return;
+    }
+
+    // Unescape #xx sequences
+    m_vecBuffer.clear();
+    for (size_t i = 0; i < pszToken.length(); i++)
+    {
+        unsigned int nHigh;
+        unsigned int nLow;
+        if (pszToken[i] == '#' && i + 2 < pszToken.length()
+            && (nHigh = PdfTokenizer::GetHexValue(pszToken[i + 1])) != HEX_NOT_FOUND
+            && (nLow = PdfTokenizer::GetHexValue(pszToken[i + 2])) != HEX_NOT_FOUND)
+        {
+            m_vecBuffer.push_back(static_cast<char>((nHigh << 4) | nLow));
+            i += 2;
+        }
+        else
+        {
+            m_vecBuffer.push_back(pszToken[i]);
+        }
+    }
+
+    rName = string_view(m_vecBuffer.data(), m_vecBuffer.size());
+}
+
+void PdfContentsTokenizer::pushOperand(EPdfContentsOperandType eType, double dNumber)
+{
+    m_operands.push_back({ eType, dNumber, { } });
+}
+
+void PdfContentsTokenizer::pushOperand(EPdfContentsOperandType eType, const char* pData, size_t lLen)
+{
+    size_t lOffset = m_operandsData.size();
+    if (lOffset + lLen > m_operandsData.capacity())
+    {
+        // The buffer will move: the data of the operands is stored
+        // in sequence, so their views can be fixed by their lengths
+        m_operandsData.reserve(std::max(lOffset + lLen, 2 * m_operandsData.capacity()));
+        size_t lDataOffset = 0;
+        for (PdfContentsOperand& rOperand : m_operands)
+        {
+            if (hasOperandData(rOperand.Type))
+            {
+                rOperand.Data = string_view(m_operandsData.data() + lDataOffset, rOperand.Data.length());
+                lDataOffset += rOperand.Data.length();
+            }
+        }
+    }
+
+    m_operandsData.insert(m_operandsData.end(), pData, pData + lLen);
+    m_operands.push_back({ eType, 0, string_view(m_operandsData.data() + lOffset, lLen) });
+}
@@ -39,6 +39,7 @@
 #include "PdfVariant.h"
 
 #include <list>
+#include <vector>
 
 namespace PoDoFo {
 
@@ -55,6 +56,86 @@ enum class EPdfContentsType
     ImageData /**< The "token" is raw inline image data found between ID and EI tags (see PDF ref section 4.8.6) */
 };
 
+/** The operators of content streams, see
+ *  PDF Reference, Appendix A "Operators"
+ */
+enum class EPdfContentsOperator
+{
+    Unknown = 0,
+    // General graphics state
+    w, J, j, M, d, ri, i, gs,
+    // Special graphics state
+    q, Q, cm,
+    // Path construction
+    m, l, c, v, y, h, re,
+    // Path painting
+    S, s, f, F, f_Star, B, B_Star, b, b_Star, n,
+    // Clipping paths
+    W, W_Star,
+    // Text objects
+    BT, ET,
+    // Text state
+    Tc, Tw, Tz, TL, Tf, Tr, Ts,
+    // Text positioning
+    Td, TD, Tm, T_Star,
+    // Text showing
+    Tj, TJ, Quote, DoubleQuote,
+    // Type 3 fonts
+    d0, d1,
+    // Color
+    CS, cs, SC, SCN, sc, scn, G, g, RG, rg, K, k,
+    // Shading patterns
+    sh,
+    // Inline images
+    BI, ID, EI,
+    // XObjects
+    Do,
+    // Marked content
+    MP, DP, BMC, BDC, EMC,
+    // Compatibility
+    BX, EX,
+};
+
+/** The type of an operand read by PdfContentsTokenizer::TryReadNextOperation()
+ */
+enum class EPdfContentsOperandType
+{
+    Null,
+    Bool,            ///< The value is in Number, 1 for true and 0 for false
+    Number,          ///< The value is in Number
+    Name,            ///< The unescaped name is in Data
+    String,          ///< The unescaped bytes of the string are in Data
+    HexString,       ///< The decoded bytes of the string are in Data
+    ArrayStart,      ///< The following operands are items of an array
+    ArrayEnd,
+    DictionaryStart, ///< The following operands are key/value pairs of a dictionary
+    DictionaryEnd,
+};
+
+/** An operand read by PdfContentsTokenizer::TryReadNextOperation()
+ */
+struct PdfContentsOperand
+{
+    EPdfContentsOperandType Type;
+    double Number;
+    std::string_view Data;
+};
+
+/** An operator and its operands read by PdfContentsTokenizer::TryReadNextOperation()
+ *
+ *  All views and the operands point to memory owned by the
+ *  PdfContentsTokenizer, which stays valid until the next
+ *  operation is read.
+ */
+struct PdfContentsOperation
+{
+    EPdfContentsOperator Operator;
+    std::string_view Keyword;            ///< The operator as written in the stream
+    const PdfContentsOperand* Operands;  ///< Operands in stream order, with arrays and dictionaries flattened
+    size_t OperandCount;
+    std::string_view ImageData;          ///< Raw data of an inline image, for the ID operator
+};
+
 /** This class is a parser for content streams in PDF documents.
  *
  *  The parsed content stream can be used and modified in various ways.
@@ -111,14 +192,38 @@ public:
     void ReadNextVariant(PdfVariant& rVariant);
     bool TryReadNextVariant(PdfVariant& rVariant);
 
+    /** Read the next operator together with all its operands.
+     *
+     *  Unlike TryReadNext() no PdfVariant is created: numbers are
+     *  returned as doubles, and names and strings as views of
+     *  buffers that are reused for all operations, so that no
+     *  memory is allocated once the buffers have grown enough.
+     *
+     *  The inline image data following the ID operator is returned
+     *  in the ImageData of the ID operation. Operands not followed
+     *  by an operator at the end of the contents are ignored.
+     *
+     *  \param[out] rOperation the read operation. It's undefined if
+     *              false is returned
+     *  \returns false if the end of the contents has been reached
+     */
+    bool TryReadNextOperation(PdfContentsOperation& rOperation);
+
 private:
     bool tryReadNextToken(std::string_view& pszToken, EPdfTokenType* peType);
     bool ReadInlineImgData(EPdfContentsType& reType, PdfVariant & rVariant);
+    bool readInlineImgData(std::string_view& rData);
+    void readName(std::string_view& rName);
+    void pushOperand(EPdfContentsOperandType eType, double dNumber = 0);
+    void pushOperand(EPdfContentsOperandType eType, const char* pData, size_t lLen);
 
 private:
     PdfRefCountedInputDevice m_device;
     std::list<PdfObject*> m_lstContents;  // A list containing pointers to all contents objects
     bool m_readingInlineImgData;  // A state of reading inline image data
+    std::vector<PdfContentsOperand> m_operands;  // Operands of the last operation
+    std::vector<char> m_operandsData;            // Names and strings of the last operation
+    std::vector<char> m_vecBuffer;               // Buffer to read strings
 };
 
 };
@@ -139,6 +139,11 @@ enum class EPdfWriteMode
 
 const EPdfWriteMode PdfWriteModeDefault = EPdfWriteMode::Compact;
 
+/** The default number of decimal digits used
+ *  when writing real numbers
+ */
+constexpr unsigned short PdfRealPrecisionDefault = 6;
+
 /**
  * Every PDF datatype that can occur in a PDF file
  * is referenced by an own enum (e.g. Bool or String).
@@ -183,6 +188,67 @@ enum class EPdfFilter
     Crypt
 };
 
+/**
+ * Strategies that can be used to tune the Flate compression
+ * of streams. They map to the corresponding ZLib deflate strategies.
+ *
+ * \see PdfFlateSettings
+ */
+enum class EPdfFlateStrategy
+{
+    Default,                   /**< Normal deflate compression, suitable for most data */
+    Filtered,                  /**< Tuned for data produced by a predictor (e.g. PNG filtered images) */
+    HuffmanOnly,               /**< Huffman coding only, no string matching. Very fast, poor ratio */
+    Rle,                       /**< Limit match distances to one, fast run length encoding */
+    Fixed                      /**< Don't use dynamic Huffman codes */
+};
+
+/**
+ * Predictors that can be applied to the data of Flate
+ * encoded streams, improving the compression of image
+ * data and other tables of fixed size rows. The values are
+ * the ones of the /Predictor key of the /DecodeParms dictionary.
+ *
+ * \see PdfFlateSettings
+ */
+enum class EPdfPredictor
+{
+    None = 1,                  /**< No prediction */
+    PngNone = 10,              /**< PNG rows, all with the None filter */
+    PngSub = 11,               /**< PNG rows, all with the Sub filter */
+    PngUp = 12,                /**< PNG rows, all with the Up filter */
+    PngAverage = 13,           /**< PNG rows, all with the Average filter */
+    PngPaeth = 14,             /**< PNG rows, all with the Paeth filter */
+    PngOptimum = 15            /**< PNG rows, with the filter chosen per row to minimize the encoded size */
+};
+
+/**
+ * Settings used by the Flate filter when encoding stream data.
+ * They can be set per document (PdfVecObjects::SetFlateSettings)
+ * or per stream (PdfStream::SetFlateSettings).
+ */
+struct PdfFlateSettings
+{
+    /** Compression level from 0 (no compression) to 9 (best compression),
+     *  1 is the fastest. -1 selects the ZLib default, currently 6.
+     */
+    int Level = -1;
+
+    EPdfFlateStrategy Strategy = EPdfFlateStrategy::Default;
+
+    /** Predictor applied to the data before compression. It can be set
+     *  only per stream, as it depends on the layout of the stream data.
+     *  It's used only if Flate is the only filter of the stream, and the
+     *  corresponding /DecodeParms are set on the stream dictionary.
+     *  The data must be made of whole rows of Columns samples.
+     */
+    EPdfPredictor Predictor = EPdfPredictor::None;
+
+    int Colors = 1;             ///< Number of color components per sample, used by the predictor
+    int BitsPerComponent = 8;   ///< Bits of each color component: 1, 2, 4, 8 or 16
+    int Columns = 1;            ///< Number of samples in each row
+};
+
 
 /**
  * Enum for the different font formats supported by PoDoFo
@@ -308,9 +374,15 @@ enum class EPdfAlignment
     Right   = 2
 };
 
+/**
+ * Options to use when saving a document
+ */
 enum class PdfSaveOptions
 {
-    None,
+    None = 0,
+    ObjectStreams = 1,      ///< Pack objects without streams into Flate compressed object streams. Requires PDF 1.5 and implies a XRef stream
+    ParallelCompression = 2, ///< Encode the streams whose encoding was deferred on a pool of threads before writing. \see PdfVecObjects::SetDeferStreamEncoding
+    SplitFlateStreams = 4,  ///< With ParallelCompression, split very large Flate streams in blocks encoded concurrently, at the cost of a slightly lower compression ratio
 };
 
 /**
@@ -471,6 +543,7 @@ static const char s_cDelimiters[] = {
 
 ENABLE_BITMASK_OPERATORS(PoDoFo::EPdfWriteMode);
 ENABLE_BITMASK_OPERATORS(PoDoFo::EPdfInfoInitial);
+ENABLE_BITMASK_OPERATORS(PoDoFo::PdfSaveOptions);
 
 /**
  * \mainpage
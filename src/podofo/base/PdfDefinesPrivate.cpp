@@ -36,6 +36,7 @@
 #include "PdfDefinesPrivate.h"
 #include "PdfDefines.h"
 #include <utfcpp/utf8.h>
+#include <charconv>
 
 #ifndef WIN32
 // NOTE: There's no <cstrings>, <strings.h> is a posix header
@@ -72,6 +73,34 @@ int compat::strncasecmp(const char* s1, const char* s2, size_t n)
 #endif
 }
 
+string_view utls::FormatTo(char* buffer, int64_t value)
+{
+    auto result = std::to_chars(buffer, buffer + FormatBufferSize, value);
+    PODOFO_ASSERT(result.ec == errc());
+    return string_view(buffer, result.ptr - buffer);
+}
+
+string_view utls::FormatTo(char* buffer, double value, unsigned short precision, bool trimZeros)
+{
+    if (precision > MaxRealPrecision)
+        precision = MaxRealPrecision;
+
+    // NOTE: std::to_chars rounds as printf() does, so the
+    // output matches "%f" with the classic locale
+    auto result = std::to_chars(buffer, buffer + FormatBufferSize, value, chars_format::fixed, precision);
+    PODOFO_ASSERT(result.ec == errc());
+    size_t len = result.ptr - buffer;
+    if (trimZeros && precision != 0 && std::isfinite(value))
+    {
+        while (buffer[len - 1] == '0')
+            len--;
+        if (buffer[len - 1] == '.')
+            len--;
+    }
+
+    return string_view(buffer, len);
+}
+
 size_t io::FileSize(const string_view& filename)
 {
     streampos fbegin;
@@ -84,6 +84,31 @@ namespace io
     FILE* fopen(const std::string_view& view, const std::string_view& mode);
 }
 
+namespace utls
+{
+    /** The size of the buffers used by FormatTo(). It's enough
+     *  for any integer and any real number written with up to
+     *  MaxRealPrecision decimal digits
+     */
+    constexpr size_t FormatBufferSize = 352;
+    constexpr unsigned short MaxRealPrecision = 20;
+
+    /** Format an integer in a buffer of at least FormatBufferSize
+     *  chars, without allocating and regardless of the current locale
+     *  \returns a view on the formatted number
+     */
+    std::string_view FormatTo(char* buffer, int64_t value);
+
+    /** Format a real number in fixed notation in a buffer of at least
+     *  FormatBufferSize chars, without allocating and regardless of
+     *  the current locale
+     *  \param precision the number of decimal digits, at most MaxRealPrecision
+     *  \param trimZeros remove the trailing zeros of the decimal part
+     *  \returns a view on the formatted number
+     */
+    std::string_view FormatTo(char* buffer, double value, unsigned short precision, bool trimZeros);
+}
+
 /**
  * \page <PoDoFo PdfDefinesPrivate Header>
  *
@@ -35,6 +35,8 @@
 
 #include "PdfDictionary.h"
 
+#include <algorithm>
+
 #include "PdfOutputDevice.h"
 #include "PdfDefinesPrivate.h"
 
@@ -51,7 +53,13 @@ PdfDictionary::PdfDictionary( const PdfDictionary & rhs )
 
 const PdfDictionary & PdfDictionary::operator=( const PdfDictionary & rhs )
 {
-    m_mapKeys = rhs.m_mapKeys;
+    // NOTE: Clear first so all the values are copy constructed, and
+    // thus detached, instead of being assigned over the existing ones
+    m_mapKeys.clear();
+    m_mapKeys.reserve( rhs.m_mapKeys.size() );
+    for( auto& pair : rhs.m_mapKeys )
+        m_mapKeys.push_back( std::make_pair( pair.first, std::make_unique<PdfObject>( *pair.second ) ) );
+
     PdfContainerDataType::operator=( rhs );
     return *this;
 }
@@ -62,16 +70,15 @@ bool PdfDictionary::operator==( const PdfDictionary& rhs ) const
         return true;
 
     // We don't check owner
-    return m_mapKeys == rhs.m_mapKeys;
+    return std::equal( m_mapKeys.begin(), m_mapKeys.end(), rhs.m_mapKeys.begin(), rhs.m_mapKeys.end(),
+        []( const TKeyMap::value_type& lhs, const TKeyMap::value_type& rhs ) {
+            return lhs.first == rhs.first && *lhs.second == *rhs.second;
+        });
 }
 
 bool PdfDictionary::operator!=(const PdfDictionary& rhs) const
 {
-    if (this != &rhs)
-        return true;
-
-    // We don't check owner
-    return m_mapKeys != rhs.m_mapKeys;
+    return !(*this == rhs);
 }
 
 void PdfDictionary::Clear()
@@ -92,7 +99,7 @@ PdfObject & PdfDictionary::AddKey( const PdfName & identifier, const PdfObject &
     if (added.second)
         SetDirty();
 
-    return added.first->second;
+    return *added.first->second;
 }
 
 PdfObject& PdfDictionary::AddKeyIndirect(const PdfName& key, const PdfObject& obj)
@@ -113,19 +120,27 @@ pair<TKeyMap::iterator, bool> PdfDictionary::addKey(const PdfName& identifier, c
     // NOTE: Empty PdfNames are legal according to the PDF specification.
     // Don't check for it
 
-    std::pair<TKeyMap::iterator, bool> inserted = m_mapKeys.insert(std::make_pair(identifier, rObject));
-    if (!inserted.second)
+    auto found = lowerBound(identifier);
+    std::pair<TKeyMap::iterator, bool> inserted;
+    if (found != m_mapKeys.end() && found->first == identifier)
     {
+        inserted.first = m_mapKeys.begin() + (found - m_mapKeys.cbegin());
+        inserted.second = false;
         if (noDirtySet)
-            inserted.first->second.Assign(rObject);
+            inserted.first->second->Assign(rObject);
         else
-            inserted.first->second = rObject;
+            *inserted.first->second = rObject;
+    }
+    else
+    {
+        inserted.first = m_mapKeys.insert(found, std::make_pair(identifier, std::make_unique<PdfObject>(rObject)));
+        inserted.second = true;
     }
 
-    inserted.first->second.SetParent(this);
+    inserted.first->second->SetParent(this);
     auto document = GetObjectDocument();
     if (document != nullptr)
-        inserted.first->second.SetDocument(*document);
+        inserted.first->second->SetDocument(*document);
 
     return inserted;
 }
@@ -135,11 +150,19 @@ PdfObject * PdfDictionary::getKey( const PdfName & key ) const
     if( !key.GetLength() )
         return nullptr;
 
-    TCIKeyMap it = m_mapKeys.find( key );
-    if( it == m_mapKeys.end() )
+    TCIKeyMap it = lowerBound( key );
+    if( it == m_mapKeys.end() || it->first != key )
         return nullptr;
 
-    return &const_cast<PdfObject &>( it->second );
+    return it->second.get();
+}
+
+TKeyMap::const_iterator PdfDictionary::lowerBound( const PdfName & key ) const
+{
+    return std::lower_bound(m_mapKeys.begin(), m_mapKeys.end(), key,
+        [](const TKeyMap::value_type& pair, const PdfName& name) {
+            return pair.first < name;
+        });
 }
 
 PdfObject * PdfDictionary::findKey( const PdfName &key ) const
@@ -264,15 +287,16 @@ bool PdfDictionary::HasKey( const PdfName & key ) const
 {
     // NOTE: Empty PdfNames are legal according to the PDF specification,
     // don't check for it
-    return m_mapKeys.find( key ) != m_mapKeys.end();
+    TCIKeyMap it = lowerBound( key );
+    return it != m_mapKeys.end() && it->first == key;
 }
 
 bool PdfDictionary::RemoveKey( const PdfName & identifier )
 {
     AssertMutable();
 
-    TKeyMap::iterator found = m_mapKeys.find( identifier );
-    if( found == m_mapKeys.end() )
+    TCIKeyMap found = lowerBound( identifier );
+    if( found == m_mapKeys.end() || found->first != identifier )
         return false;
 
     m_mapKeys.erase( found );
@@ -324,7 +348,7 @@ void PdfDictionary::Write(PdfOutputDevice& pDevice, EPdfWriteMode eWriteMode,
             {
                 pDevice.Write( " ", 1 ); // write a separator
             }
-            itKeys->second.GetVariant().Write( pDevice, eWriteMode, pEncrypt );
+            itKeys->second->GetVariant().Write( pDevice, eWriteMode, pEncrypt );
             if( (eWriteMode & EPdfWriteMode::Clean) == EPdfWriteMode::Clean ) 
             {
                 pDevice.Write( "\n", 1 );
@@ -341,7 +365,7 @@ void PdfDictionary::ResetDirtyInternal()
 {
     // Propagate state to all sub objects
     for (auto &pair : m_mapKeys)
-        pair.second.ResetDirty();
+        pair.second->ResetDirty();
 }
 
 void PdfDictionary::SetOwner( PdfObject *pOwner )
@@ -354,9 +378,9 @@ void PdfDictionary::SetOwner( PdfObject *pOwner )
     TIKeyMap end = this->end();
     for (; it != end; it++)
     {
-        it->second.SetParent(this);
+        it->second->SetParent(this);
         if (document != nullptr)
-            it->second.SetDocument(*document);
+            it->second->SetDocument(*document);
     }
 }
 
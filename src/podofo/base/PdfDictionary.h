@@ -36,7 +36,8 @@
 #ifndef _PDF_DICTIONARY_H_
 #define _PDF_DICTIONARY_H_
 
-#include <map>
+#include <memory>
+#include <vector>
 
 #include "PdfDefines.h"
 #include "PdfContainerDataType.h"
@@ -46,7 +47,13 @@
 
 namespace PoDoFo {
 
-typedef std::map<PdfName,PdfObject>      TKeyMap;
+/** Dictionary entries are stored in a flat vector sorted by key,
+ *  which is more compact and cache friendly than a node based map
+ *  for the few keys dictionaries usually have. The values are
+ *  allocated separately, so that they don't move when keys are
+ *  added or removed
+ */
+typedef std::vector<std::pair<PdfName,std::unique_ptr<PdfObject>>> TKeyMap;
 typedef TKeyMap::iterator                TIKeyMap;
 typedef TKeyMap::const_iterator          TCIKeyMap;
 
@@ -54,6 +61,9 @@ class PdfOutputDevice;
 
 /** The PDF dictionary data type of PoDoFo (inherits from PdfDataType,
  *  the base class for such representations)
+ *
+ *  \remarks Adding or removing keys invalidates iterators, but not
+ *  references and pointers to the values of the other keys
  */
 class PODOFO_API PdfDictionary : public PdfContainerDataType
 {
@@ -246,6 +256,7 @@ public:
      PdfObject * getKey(const PdfName & key) const;
      PdfObject * findKey(const PdfName & key) const;
      PdfObject * findKeyParent(const PdfName & key) const;
+     TKeyMap::const_iterator lowerBound(const PdfName & key) const;
 
  private: 
     TKeyMap      m_mapKeys; 
@@ -101,6 +101,9 @@ protected:
      */
     PdfEncoding( int nFirstChar, int nLastChar, PdfObject* = nullptr );
 
+public:
+    virtual ~PdfEncoding();
+
     /** Get a unique ID for this encoding
      *  which can used for comparisons!
      *
@@ -108,9 +111,6 @@ protected:
      */
     virtual const PdfName & GetID() const = 0;
 
-public:
-    virtual ~PdfEncoding();
-
     /** Comparison operator.
      *
      *  \param rhs the PdfEncoding to which this encoding should be compared
@@ -72,10 +72,10 @@ void PdfFileStream::BeginAppendImpl( const TVecFilters & vecFilters )
         if( m_pCurEncrypt ) 
         {
             m_pEncryptStream = m_pCurEncrypt->CreateEncryptionOutputStream(*m_pDeviceStream);
-            m_pStream = PdfFilterFactory::CreateEncodeStream( vecFilters, *m_pEncryptStream );
+            m_pStream = PdfFilterFactory::CreateEncodeStream( vecFilters, *m_pEncryptStream, GetFlateSettings() );
         }
         else
-            m_pStream = PdfFilterFactory::CreateEncodeStream( vecFilters, *m_pDeviceStream );
+            m_pStream = PdfFilterFactory::CreateEncodeStream( vecFilters, *m_pDeviceStream, GetFlateSettings() );
     }
     else 
     {
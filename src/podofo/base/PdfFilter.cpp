@@ -96,8 +96,10 @@ public:
      *  \param pOutputStream write all data to this output stream after encoding the data.
      *  \param eFilter use this filter for encoding.
      *  \param bOwnStream if true pOutputStream will be deleted along with this filter
+     *  \param rFlateSettings settings applied if eFilter is EPdfFilter::FlateDecode
      */
-    PdfFilteredEncodeStream( PdfOutputStream* pOutputStream, const EPdfFilter eFilter, bool bOwnStream )
+    PdfFilteredEncodeStream( PdfOutputStream* pOutputStream, const EPdfFilter eFilter, bool bOwnStream,
+                             const PdfFlateSettings & rFlateSettings )
         : m_pOutputStream( pOutputStream )
     {
         m_filter = PdfFilterFactory::Create( eFilter );
@@ -105,6 +107,9 @@ public:
         if( !m_filter.get() )
             PODOFO_RAISE_ERROR( EPdfError::UnsupportedFilter );
 
+        if( eFilter == EPdfFilter::FlateDecode )
+            static_cast<PdfFlateFilter*>(m_filter.get())->SetSettings( rFlateSettings );
+
         m_filter->BeginEncode( pOutputStream );
 
         if( !bOwnStream )
@@ -344,18 +349,24 @@ std::unique_ptr<PdfFilter> PdfFilterFactory::Create( const EPdfFilter eFilter )
     return std::unique_ptr<PdfFilter>(pFilter);
 }
 
-unique_ptr<PdfOutputStream> PdfFilterFactory::CreateEncodeStream(const TVecFilters& filters, PdfOutputStream & pStream)
+unique_ptr<PdfOutputStream> PdfFilterFactory::CreateEncodeStream(const TVecFilters& filters, PdfOutputStream & pStream,
+                                                               const PdfFlateSettings & rFlateSettings)
 {
     TVecFilters::const_iterator it = filters.begin();
 
     PODOFO_RAISE_LOGIC_IF( !filters.size(), "Cannot create an EncodeStream from an empty list of filters" );
 
-    auto pFilter = new PdfFilteredEncodeStream( &pStream, *it, false );
+    // Predictors are supported only when Flate is the only filter
+    PdfFlateSettings flateSettings = rFlateSettings;
+    if( filters.size() != 1 )
+        flateSettings.Predictor = EPdfPredictor::None;
+
+    auto pFilter = new PdfFilteredEncodeStream( &pStream, *it, false, flateSettings );
     ++it;
 
     while( it != filters.end() ) 
     {
-        pFilter = new PdfFilteredEncodeStream( pFilter, *it, true );
+        pFilter = new PdfFilteredEncodeStream( pFilter, *it, true, flateSettings );
         ++it;
     }
 
@@ -345,11 +345,14 @@ public:
      *  \param filters a list of filters
      *  \param pStream write all data to this PdfOutputStream after it has been
      *         encoded
+     *  \param rFlateSettings compression level and strategy used
+     *         by the EPdfFilter::FlateDecode filter, if in the list
      *  \returns a new PdfOutputStream that has to be deleted by the caller.
      *
      *  \see PdfFilterFactory::CreateFilterList
      */
-    static std::unique_ptr<PdfOutputStream> CreateEncodeStream(const TVecFilters & filters, PdfOutputStream &pStream);
+    static std::unique_ptr<PdfOutputStream> CreateEncodeStream(const TVecFilters & filters, PdfOutputStream &pStream,
+                                                const PdfFlateSettings & rFlateSettings = PdfFlateSettings());
 
     /** Create a PdfOutputStream that applies a list of filters 
      *  on all data written to it.
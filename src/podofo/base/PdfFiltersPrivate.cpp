@@ -107,8 +107,9 @@ public:
         }
 
         m_nCurRowIndex  = 0;
-        m_nBpp  = (m_nBPC * m_nColors) >> 3;
-        m_nRows = (m_nColumns * m_nColors * m_nBPC) >> 3;
+        // Samples smaller than a byte are predicted from the previous byte
+        m_nBpp  = std::max( (m_nBPC * m_nColors) >> 3, 1 );
+        m_nRows = (m_nColumns * m_nColors * m_nBPC + 7) >> 3;
 
         m_pPrev = static_cast<char*>(podofo_calloc( m_nRows, sizeof(char) ));
         if( !m_pPrev )
@@ -187,8 +188,8 @@ public:
                     case 13: // png average
                     {
                         int prev = (m_nCurRowIndex - m_nBpp < 0 
-                                    ? 0 : m_pPrev[m_nCurRowIndex - m_nBpp]);
-                        m_pPrev[m_nCurRowIndex] = ((prev + m_pPrev[m_nCurRowIndex]) >> 1) + *pBuffer;
+                                    ? 0 : static_cast<unsigned char>( m_pPrev[m_nCurRowIndex - m_nBpp] ));
+                        m_pPrev[m_nCurRowIndex] = ((prev + static_cast<unsigned char>( m_pPrev[m_nCurRowIndex] )) >> 1) + *pBuffer;
                         break;
                     }
                     case 14: // png paeth
@@ -274,6 +275,154 @@ private:
     char* m_pUpperLeftPixelComponents;
 };
 
+/** Applies PNG predictors to rows of data, prefixing each
+ *  row with the PNG filter type, as PdfPredictorDecoder expects
+ */
+class PdfPredictorEncoder {
+
+public:
+    PdfPredictorEncoder( const PdfFlateSettings & rSettings )
+        : m_ePredictor( rSettings.Predictor ), m_nCurRowIndex( 0 )
+    {
+        m_nBpp = std::max( (rSettings.BitsPerComponent * rSettings.Colors) >> 3, 1 );
+        m_nRowLength = (rSettings.Columns * rSettings.Colors * rSettings.BitsPerComponent + 7) >> 3;
+        m_vecRow.resize( m_nRowLength );
+        m_vecPrev.resize( m_nRowLength );
+        for( int i = 0; i < FilterCount; i++ )
+            m_vecFiltered[i].resize( m_nRowLength + 1 );
+    }
+
+    /** Encode data, appending the encoded rows completed
+     *  so far to rEncoded
+     */
+    void Encode( const char* pBuffer, size_t lLen, std::string & rEncoded )
+    {
+        while( lLen != 0 )
+        {
+            size_t lCopy = std::min( lLen, m_nRowLength - m_nCurRowIndex );
+            memcpy( m_vecRow.data() + m_nCurRowIndex, pBuffer, lCopy );
+            m_nCurRowIndex += lCopy;
+            pBuffer += lCopy;
+            lLen -= lCopy;
+
+            if( m_nCurRowIndex == m_nRowLength )
+            {
+                encodeRow( rEncoded );
+                m_nCurRowIndex = 0;
+            }
+        }
+    }
+
+    /** Check that all the data was made of whole rows
+     */
+    void Finish()
+    {
+        if( m_nCurRowIndex != 0 )
+            PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidPredictor, "The data is not made of whole rows" );
+    }
+
+private:
+    void encodeRow( std::string & rEncoded )
+    {
+        int nFilter;
+        switch( m_ePredictor )
+        {
+            case EPdfPredictor::PngNone:
+            case EPdfPredictor::PngSub:
+            case EPdfPredictor::PngUp:
+            case EPdfPredictor::PngAverage:
+            case EPdfPredictor::PngPaeth:
+                nFilter = static_cast<int>(m_ePredictor) - static_cast<int>(EPdfPredictor::PngNone);
+                filterRow( nFilter );
+                break;
+            case EPdfPredictor::PngOptimum:
+            default:
+            {
+                // Choose the filter giving the lowest sum of the
+                // absolute values of the filtered bytes, as libpng does
+                unsigned nBestSum = 0;
+                nFilter = 0;
+                for( int i = 0; i < FilterCount; i++ )
+                {
+                    filterRow( i );
+                    unsigned nSum = 0;
+                    for( size_t j = 1; j <= m_nRowLength; j++ )
+                        nSum += std::abs( static_cast<int>(static_cast<signed char>(m_vecFiltered[i][j])) );
+
+                    if( i == 0 || nSum < nBestSum )
+                    {
+                        nBestSum = nSum;
+                        nFilter = i;
+                    }
+                }
+                break;
+            }
+        }
+
+        rEncoded.append( m_vecFiltered[nFilter].data(), m_nRowLength + 1 );
+        m_vecPrev.swap( m_vecRow );
+    }
+
+    void filterRow( int nFilter )
+    {
+        const unsigned char* pRow = m_vecRow.data();
+        const unsigned char* pPrev = m_vecPrev.data();
+        char* pOut = m_vecFiltered[nFilter].data();
+        pOut[0] = static_cast<char>(nFilter);
+        pOut++;
+        for( size_t i = 0; i < m_nRowLength; i++ )
+        {
+            int a = i < m_nBpp ? 0 : pRow[i - m_nBpp];
+            int b = pPrev[i];
+            int c = i < m_nBpp ? 0 : pPrev[i - m_nBpp];
+            int nPredicted;
+            switch( nFilter )
+            {
+                case 1: // png sub
+                    nPredicted = a;
+                    break;
+                case 2: // png up
+                    nPredicted = b;
+                    break;
+                case 3: // png average
+                    nPredicted = (a + b) >> 1;
+                    break;
+                case 4: // png paeth
+                {
+                    int p = a + b - c;
+                    int pa = std::abs( p - a );
+                    int pb = std::abs( p - b );
+                    int pc = std::abs( p - c );
+                    if( pa <= pb && pa <= pc )
+                        nPredicted = a;
+                    else if( pb <= pc )
+                        nPredicted = b;
+                    else
+                        nPredicted = c;
+                    break;
+                }
+                default: // png none
+                    nPredicted = 0;
+                    break;
+            }
+
+            pOut[i] = static_cast<char>(pRow[i] - nPredicted);
+        }
+    }
+
+private:
+    static constexpr int FilterCount = 5;
+
+    EPdfPredictor m_ePredictor;
+    size_t m_nBpp;          ///< Bytes per pixel
+    size_t m_nRowLength;
+    size_t m_nCurRowIndex;
+
+    std::vector<unsigned char> m_vecRow;
+    std::vector<unsigned char> m_vecPrev;
+    std::vector<char> m_vecFiltered[FilterCount];   ///< The current row with each filter applied, prefixed by the filter type
+};
+
 
 // -------------------------------------------------------
 // Hex
@@ -528,15 +677,50 @@ void PdfAscii85Filter::WidePut( unsigned long tuple, int bytes ) const
 // Flate
 // -------------------------------------------------------
 PdfFlateFilter::PdfFlateFilter()
-    : m_pPredictor( 0 )
+    : m_pPredictor( 0 ), m_pPredictorEncoder( 0 )
 {
-    memset( m_buffer, 0, sizeof(m_buffer) );
     memset( &m_stream, 0, sizeof(m_stream) );
 }
 
 PdfFlateFilter::~PdfFlateFilter()
 {
     delete m_pPredictor;
+    delete m_pPredictorEncoder;
+}
+
+void PdfFlateFilter::SetSettings( const PdfFlateSettings & rSettings )
+{
+    ValidateSettings( rSettings );
+    m_settings = rSettings;
+}
+
+void PdfFlateFilter::ValidateSettings( const PdfFlateSettings & rSettings )
+{
+    if( rSettings.Level < Z_DEFAULT_COMPRESSION || rSettings.Level > Z_BEST_COMPRESSION )
+    {
+        PODOFO_RAISE_ERROR_INFO( EPdfError::ValueOutOfRange, "Flate compression level must be between -1 and 9" );
+    }
+
+    if( rSettings.Predictor != EPdfPredictor::None )
+    {
+        if( rSettings.Predictor < EPdfPredictor::PngNone || rSettings.Predictor > EPdfPredictor::PngOptimum )
+            PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidPredictor, "Only PNG predictors are supported for encoding" );
+
+        int nBPC = rSettings.BitsPerComponent;
+        if( rSettings.Colors < 1 || rSettings.Columns < 1
+            || ( nBPC != 1 && nBPC != 2 && nBPC != 4 && nBPC != 8 && nBPC != 16 ) )
+        {
+            PODOFO_RAISE_ERROR_INFO( EPdfError::ValueOutOfRange, "Invalid predictor parameters" );
+        }
+    }
+}
+
+void PdfFlateFilter::allocBuffer()
+{
+    // The buffer is allocated lazily, so that filters that are
+    // created but never used don't pay for it
+    if( !m_buffer )
+        m_buffer.reset( new unsigned char[PODOFO_FILTER_INTERNAL_BUFFER_SIZE] );
 }
 
 void PdfFlateFilter::BeginEncodeImpl()
@@ -545,15 +729,128 @@ void PdfFlateFilter::BeginEncodeImpl()
     m_stream.zfree    = Z_NULL;
     m_stream.opaque   = Z_NULL;
 
-    if( deflateInit( &m_stream, Z_DEFAULT_COMPRESSION ) )
+    // Same window and memory parameters as deflateInit()
+    if( deflateInit2( &m_stream, m_settings.Level, Z_DEFLATED, MAX_WBITS, 8,
+                      getZlibStrategy( m_settings.Strategy ) ) != Z_OK )
     {
         PODOFO_RAISE_ERROR( EPdfError::Flate );
     }
+
+    allocBuffer();
+
+    delete m_pPredictorEncoder;
+    m_pPredictorEncoder = m_settings.Predictor == EPdfPredictor::None ? nullptr : new PdfPredictorEncoder( m_settings );
+}
+
+int PdfFlateFilter::getZlibStrategy( EPdfFlateStrategy eStrategy )
+{
+    switch( eStrategy )
+    {
+        case EPdfFlateStrategy::Filtered:
+            return Z_FILTERED;
+        case EPdfFlateStrategy::HuffmanOnly:
+            return Z_HUFFMAN_ONLY;
+        case EPdfFlateStrategy::Rle:
+            return Z_RLE;
+        case EPdfFlateStrategy::Fixed:
+            return Z_FIXED;
+        case EPdfFlateStrategy::Default:
+        default:
+            return Z_DEFAULT_STRATEGY;
+    }
+}
+
+void PdfFlateFilter::EncodeRawBlock( const PdfFlateSettings & rSettings, const char* pBuffer, bool bLast,
+                                     PdfFlateRawBlock & rBlock )
+{
+    const size_t MaxDictionarySize = 32768;
+
+    z_stream stream;
+    memset( &stream, 0, sizeof(stream) );
+
+    // Negative window bits produce raw deflate data, without zlib header and trailer
+    if( deflateInit2( &stream, rSettings.Level, Z_DEFLATED, -MAX_WBITS, 8,
+                      getZlibStrategy( rSettings.Strategy ) ) != Z_OK )
+    {
+        PODOFO_RAISE_ERROR( EPdfError::Flate );
+    }
+
+    size_t lDictionarySize = std::min( rBlock.Offset, MaxDictionarySize );
+    if( lDictionarySize != 0 )
+    {
+        deflateSetDictionary( &stream, reinterpret_cast<const Bytef*>(pBuffer + rBlock.Offset - lDictionarySize),
+                              static_cast<uInt>(lDictionarySize) );
+    }
+
+    rBlock.Data.resize( deflateBound( &stream, static_cast<uLong>(rBlock.Length) ) + 16 );
+    stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(pBuffer + rBlock.Offset));
+    stream.avail_in  = static_cast<uInt>(rBlock.Length);
+    stream.next_out  = reinterpret_cast<Bytef*>(&rBlock.Data[0]);
+    stream.avail_out = static_cast<uInt>(rBlock.Data.size());
+
+    // A sync flush terminates the block on a byte boundary, while
+    // the last block is finished normally
+    int nResult = deflate( &stream, bLast ? Z_FINISH : Z_SYNC_FLUSH );
+    rBlock.Data.resize( rBlock.Data.size() - stream.avail_out );
+    deflateEnd( &stream );
+    if( nResult != (bLast ? Z_STREAM_END : Z_OK) )
+    {
+        PODOFO_RAISE_ERROR( EPdfError::Flate );
+    }
+
+    rBlock.Adler32 = static_cast<uint32_t>(adler32( adler32( 0, Z_NULL, 0 ),
+        reinterpret_cast<const Bytef*>(pBuffer + rBlock.Offset), static_cast<uInt>(rBlock.Length) ));
+}
+
+void PdfFlateFilter::WriteRawBlocks( const PdfFlateSettings & rSettings, const std::vector<PdfFlateRawBlock> & rBlocks,
+                                     PdfOutputStream & rStream )
+{
+    // Compute the zlib header the way deflate() does
+    int nLevel = rSettings.Level == Z_DEFAULT_COMPRESSION ? 6 : rSettings.Level;
+    int nLevelFlags;
+    if( getZlibStrategy( rSettings.Strategy ) >= Z_HUFFMAN_ONLY || nLevel < 2 )
+        nLevelFlags = 0;
+    else if( nLevel < 6 )
+        nLevelFlags = 1;
+    else if( nLevel == 6 )
+        nLevelFlags = 2;
+    else
+        nLevelFlags = 3;
+
+    unsigned nHeader = ( ( Z_DEFLATED + ( ( MAX_WBITS - 8 ) << 4 ) ) << 8 ) | ( nLevelFlags << 6 );
+    nHeader += 31 - ( nHeader % 31 );
+    char header[2] = { static_cast<char>(nHeader >> 8), static_cast<char>(nHeader & 0xFF) };
+    rStream.Write( header, 2 );
+
+    uLong nAdler32 = adler32( 0, Z_NULL, 0 );
+    for( const PdfFlateRawBlock & rBlock : rBlocks )
+    {
+        rStream.Write( rBlock.Data.data(), rBlock.Data.size() );
+        nAdler32 = adler32_combine( nAdler32, rBlock.Adler32, static_cast<z_off_t>(rBlock.Length) );
+    }
+
+    char trailer[4] = {
+        static_cast<char>((nAdler32 >> 24) & 0xFF),
+        static_cast<char>((nAdler32 >> 16) & 0xFF),
+        static_cast<char>((nAdler32 >> 8) & 0xFF),
+        static_cast<char>(nAdler32 & 0xFF)
+    };
+    rStream.Write( trailer, 4 );
 }
 
 void PdfFlateFilter::EncodeBlockImpl( const char* pBuffer, size_t lLen )
 {
-    this->EncodeBlockInternal( pBuffer, lLen, Z_NO_FLUSH );
+    if( m_pPredictorEncoder )
+    {
+        // Only whole rows are compressed, the rest is kept by the encoder
+        m_predicted.clear();
+        m_pPredictorEncoder->Encode( pBuffer, lLen, m_predicted );
+        this->EncodeBlockInternal( m_predicted.data(), m_predicted.size(), Z_NO_FLUSH );
+    }
+    else
+    {
+        this->EncodeBlockInternal( pBuffer, lLen, Z_NO_FLUSH );
+    }
 }
 
 void PdfFlateFilter::EncodeBlockInternal( const char* pBuffer, size_t lLen, int nMode )
@@ -565,7 +862,7 @@ void PdfFlateFilter::EncodeBlockInternal( const char* pBuffer, size_t lLen, int
 
     do {
         m_stream.avail_out = PODOFO_FILTER_INTERNAL_BUFFER_SIZE;
-        m_stream.next_out  = m_buffer;
+        m_stream.next_out  = m_buffer.get();
 
         if( deflate( &m_stream, nMode) == Z_STREAM_ERROR )
         {
@@ -578,7 +875,7 @@ void PdfFlateFilter::EncodeBlockInternal( const char* pBuffer, size_t lLen, int
         try {
             if( nWrittenData > 0 ) 
             {
-                GetStream()->Write( reinterpret_cast<char*>(m_buffer), nWrittenData );
+                GetStream()->Write( reinterpret_cast<char*>(m_buffer.get()), nWrittenData );
             }
         } catch( PdfError & e ) {
             // clean up after any output stream errors
@@ -591,6 +888,23 @@ void PdfFlateFilter::EncodeBlockInternal( const char* pBuffer, size_t lLen, int
 
 void PdfFlateFilter::EndEncodeImpl()
 {
+    if( m_pPredictorEncoder )
+    {
+        try
+        {
+            m_pPredictorEncoder->Finish();
+        }
+        catch( PdfError & e )
+        {
+            deflateEnd( &m_stream );
+            e.AddToCallstack( __FILE__, __LINE__ );
+            throw e;
+        }
+
+        delete m_pPredictorEncoder;
+        m_pPredictorEncoder = nullptr;
+    }
+
     this->EncodeBlockInternal( nullptr, 0, Z_FINISH );
     deflateEnd( &m_stream );
 }
@@ -609,6 +923,8 @@ void PdfFlateFilter::BeginDecodeImpl( const PdfDictionary* pDecodeParms )
     {
         PODOFO_RAISE_ERROR( EPdfError::Flate );
     }
+
+    allocBuffer();
 }
 
 void PdfFlateFilter::DecodeBlockImpl( const char* pBuffer, size_t lLen )
@@ -621,7 +937,7 @@ void PdfFlateFilter::DecodeBlockImpl( const char* pBuffer, size_t lLen )
 
     do {
         m_stream.avail_out = PODOFO_FILTER_INTERNAL_BUFFER_SIZE;
-        m_stream.next_out  = m_buffer;
+        m_stream.next_out  = m_buffer.get();
 
         switch( (flateErr = inflate(&m_stream, Z_NO_FLUSH)) ) {
             case Z_NEED_DICT:
@@ -641,9 +957,9 @@ void PdfFlateFilter::DecodeBlockImpl( const char* pBuffer, size_t lLen )
         nWrittenData = PODOFO_FILTER_INTERNAL_BUFFER_SIZE - m_stream.avail_out;
         try {
             if( m_pPredictor ) 
-                m_pPredictor->Decode( reinterpret_cast<char*>(m_buffer), nWrittenData, GetStream() );
+                m_pPredictor->Decode( reinterpret_cast<char*>(m_buffer.get()), nWrittenData, GetStream() );
             else
-                GetStream()->Write( reinterpret_cast<char*>(m_buffer), nWrittenData );
+                GetStream()->Write( reinterpret_cast<char*>(m_buffer.get()), nWrittenData );
         } catch( PdfError & e ) {
             // clean up after any output stream errors
             FailEncodeDecode();
@@ -84,11 +84,23 @@ extern "C" {
 
 namespace PoDoFo {
 
-#define PODOFO_FILTER_INTERNAL_BUFFER_SIZE 4096
+#define PODOFO_FILTER_INTERNAL_BUFFER_SIZE 65536
 
 class PdfPredictorDecoder;
+class PdfPredictorEncoder;
 class PdfOutputDevice;
 
+/** A block of a larger buffer, encoded independently
+ *  by PdfFlateFilter::EncodeRawBlock()
+ */
+struct PdfFlateRawBlock
+{
+    size_t      Offset;     ///< Offset of the block in the buffer
+    size_t      Length;     ///< Length of the unencoded block
+    std::string Data;       ///< Raw deflate data of the block
+    uint32_t    Adler32;    ///< Checksum of the unencoded block
+};
+
 /** The ascii hex filter.
  */
 class PdfHexFilter : public PdfFilter {
@@ -331,6 +343,47 @@ public:
     PdfFlateFilter();
     virtual ~PdfFlateFilter();
 
+    /** Set the compression level and strategy used
+     *  by the next call to BeginEncode().
+     *
+     *  \param rSettings the settings to use for encoding
+     */
+    void SetSettings( const PdfFlateSettings & rSettings );
+
+    /** Check that Flate settings can be used for encoding.
+     *  Raises ValueOutOfRange or InvalidPredictor if they can't.
+     *
+     *  \param rSettings the settings to check
+     */
+    static void ValidateSettings( const PdfFlateSettings & rSettings );
+
+    /** Encode a block of a larger buffer as raw deflate data ending
+     *  on a byte boundary, so that blocks encoded concurrently can be
+     *  concatenated in a single zlib stream, like pigz does.
+     *  Up to 32 KiB of the data preceding the block are used as
+     *  dictionary, so the compression ratio stays close to the one
+     *  of a stream encoded at once.
+     *
+     *  \param rSettings the settings to use for encoding
+     *  \param pBuffer the whole buffer the block is part of
+     *  \param bLast true if this is the last block of the buffer
+     *  \param rBlock Offset and Length select the block to encode,
+     *         Data and Adler32 are filled with the results
+     *
+     *  \see WriteRawBlocks
+     */
+    static void EncodeRawBlock( const PdfFlateSettings & rSettings, const char* pBuffer, bool bLast,
+                                PdfFlateRawBlock & rBlock );
+
+    /** Write blocks encoded by EncodeRawBlock() as a zlib stream.
+     *
+     *  \param rSettings the settings the blocks were encoded with
+     *  \param rBlocks all the blocks of the buffer, in order
+     *  \param rStream write the zlib stream to this stream
+     */
+    static void WriteRawBlocks( const PdfFlateSettings & rSettings, const std::vector<PdfFlateRawBlock> & rBlocks,
+                                PdfOutputStream & rStream );
+
     /** Check wether the encoding is implemented for this filter.
      * 
      *  \returns true if the filter is able to encode data
@@ -425,11 +478,18 @@ public:
  private:
     void EncodeBlockInternal( const char* pBuffer, size_t lLen, int nMode );
 
+    void allocBuffer();
+
+    static int getZlibStrategy( EPdfFlateStrategy eStrategy );
+
  private:
-    unsigned char        m_buffer[PODOFO_FILTER_INTERNAL_BUFFER_SIZE];
+    std::unique_ptr<unsigned char[]> m_buffer;
+    PdfFlateSettings     m_settings;
 
     z_stream             m_stream;
     PdfPredictorDecoder* m_pPredictor;
+    PdfPredictorEncoder* m_pPredictorEncoder;
+    std::string          m_predicted;   ///< Rows encoded by m_pPredictorEncoder, to be compressed
 };
 
 // -----------------------------------------------------
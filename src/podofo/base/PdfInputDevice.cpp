@@ -35,6 +35,9 @@
 
 #include "PdfInputDevice.h"
 
+#include "PdfInputStream.h"
+
+#include <algorithm>
 #include <cstdarg>
 #include <fstream>
 #include <sstream>
@@ -46,7 +49,11 @@ using namespace PoDoFo;
 PdfInputDevice::PdfInputDevice(bool isSeeakable) :
     m_pStream(nullptr),
     m_StreamOwned(false),
-    m_bIsSeekable(isSeeakable)
+    m_bIsSeekable(isSeeakable),
+    m_pSpan(nullptr),
+    m_lSpanLen(0),
+    m_lSpanPos(0),
+    m_bSpanEof(false)
 {
 }
 
@@ -63,22 +70,29 @@ PdfInputDevice::PdfInputDevice(const string_view& filename)
     m_StreamOwned = true;
 }
 
-// TODO: Optimize me, offer a version that does not copy the buffer
-PdfInputDevice::PdfInputDevice( const char* pBuffer, size_t lLen )
+PdfInputDevice::PdfInputDevice( const char* pBuffer, size_t lLen, bool bCopy )
     : PdfInputDevice(true)
 {
     if( !pBuffer ) 
         PODOFO_RAISE_ERROR( EPdfError::InvalidHandle );
 
+    if (!bCopy)
+    {
+        SetSpan(pBuffer, lLen);
+        return;
+    }
+
     try
     {
-        m_pStream = new std::istringstream( std::string( pBuffer, lLen ), std::ios::binary );
-        m_StreamOwned = true;
+        m_pSpanCopy.reset(new char[lLen == 0 ? 1 : lLen]);
     }
-    catch(...)
+    catch (...)
     {
         PODOFO_RAISE_ERROR( EPdfError::OutOfMemory );
     }
+
+    std::memcpy(m_pSpanCopy.get(), pBuffer, lLen);
+    SetSpan(m_pSpanCopy.get(), lLen);
 }
 
 PdfInputDevice::PdfInputDevice( const std::istream* pInStream )
@@ -96,6 +110,16 @@ PdfInputDevice::~PdfInputDevice()
         delete m_pStream;
 }
 
+void PdfInputDevice::SetSpan(const char* pBuffer, size_t lLen)
+{
+    // NOTE: An empty span must still be distinguishable
+    // from a device that has no span at all
+    m_pSpan = pBuffer == nullptr ? "" : pBuffer;
+    m_lSpanLen = lLen;
+    m_lSpanPos = 0;
+    m_bSpanEof = false;
+}
+
 void PdfInputDevice::Close()
 {
     // nothing to do here, but maybe necessary for inheriting classes
@@ -112,6 +136,20 @@ int PdfInputDevice::GetChar() const
 
 bool PdfInputDevice::TryGetChar(int &ch) const
 {
+    if (m_pSpan != nullptr)
+    {
+        if (m_lSpanPos >= m_lSpanLen)
+        {
+            m_bSpanEof = true;
+            ch = -1;
+            return false;
+        }
+
+        ch = static_cast<unsigned char>(m_pSpan[m_lSpanPos]);
+        m_lSpanPos++;
+        return true;
+    }
+
     if (m_pStream->eof())
     {
         ch = -1;
@@ -127,6 +165,17 @@ bool PdfInputDevice::TryGetChar(int &ch) const
 
 int PdfInputDevice::Look() const 
 {
+    if (m_pSpan != nullptr)
+    {
+        if (m_lSpanPos >= m_lSpanLen)
+        {
+            m_bSpanEof = true;
+            return -1;
+        }
+
+        return static_cast<unsigned char>(m_pSpan[m_lSpanPos]);
+    }
+
     // NOTE: We don't want a peek() call to set failbit
     if (m_pStream->eof())
         return -1;
@@ -140,6 +189,9 @@ int PdfInputDevice::Look() const
 
 size_t PdfInputDevice::Tell() const
 {
+    if (m_pSpan != nullptr)
+        return m_lSpanPos;
+
     streamoff ret;
     if (m_pStream->eof())
     {
@@ -166,6 +218,33 @@ void PdfInputDevice::Seek( std::streamoff off, std::ios_base::seekdir dir )
     if (!m_bIsSeekable)
         PODOFO_RAISE_ERROR_INFO(EPdfError::InvalidDeviceOperation, "Tried to seek an unseekable input device.");
 
+    if (m_pSpan != nullptr)
+    {
+        streamoff base;
+        switch (dir)
+        {
+            case ios_base::beg:
+                base = 0;
+                break;
+            case ios_base::cur:
+                base = (streamoff)m_lSpanPos;
+                break;
+            case ios_base::end:
+                base = (streamoff)m_lSpanLen;
+                break;
+            default:
+                PODOFO_RAISE_ERROR(EPdfError::InvalidEnumValue);
+        }
+
+        streamoff pos = base + off;
+        if (pos < 0 || pos > (streamoff)m_lSpanLen)
+            PODOFO_RAISE_ERROR_INFO(EPdfError::InvalidDeviceOperation, "Failed to seek to given position in the stream");
+
+        m_lSpanPos = (size_t)pos;
+        m_bSpanEof = false;
+        return;
+    }
+
     // NOTE: Some c++ libraries don't reset eofbit prior seeking
     m_pStream->clear(m_pStream->rdstate() & ~ios_base::eofbit);
     m_pStream->seekg( off, dir );
@@ -175,10 +254,162 @@ void PdfInputDevice::Seek( std::streamoff off, std::ios_base::seekdir dir )
 
 size_t PdfInputDevice::Read(char* pBuffer, size_t lLen)
 {
+    if (m_pSpan != nullptr)
+    {
+        if (lLen == 0 || m_bSpanEof)
+            return 0;
+
+        size_t read = std::min(lLen, m_lSpanLen - m_lSpanPos);
+        std::memcpy(pBuffer, m_pSpan + m_lSpanPos, read);
+        m_lSpanPos += read;
+
+        // Mimic io::Read(), which peeks the stream
+        // after reading and sets eof at the end of it
+        if (m_lSpanPos == m_lSpanLen)
+            m_bSpanEof = true;
+
+        return read;
+    }
+
     return io::Read(*m_pStream, pBuffer, lLen);
 }
 
 bool PdfInputDevice::Eof() const
 {
+    if (m_pSpan != nullptr)
+        return m_bSpanEof;
+
     return m_pStream->eof();
 }
+
+PdfStreamInputDevice::PdfStreamInputDevice( unique_ptr<PdfInputStream> pStream, size_t lBufferSize )
+    : PdfInputDevice( true ),
+      m_pStream( std::move( pStream ) ),
+      m_lBufferSize( std::max( lBufferSize, 2 * MinBackBuffer ) ),
+      m_lBufferOffset( 0 ),
+      m_lPos( 0 ),
+      m_lLen( 0 ),
+      m_bStreamEof( false ),
+      m_bEof( false )
+{
+    if( m_pStream == nullptr )
+        PODOFO_RAISE_ERROR( EPdfError::InvalidHandle );
+
+    m_pBuffer.reset( new char[m_lBufferSize] );
+}
+
+PdfStreamInputDevice::~PdfStreamInputDevice()
+{
+}
+
+bool PdfStreamInputDevice::fill() const
+{
+    while( !m_bStreamEof )
+    {
+        // Keep some data before the current position, so
+        // that the caller can still seek back a bit
+        size_t lKeep = std::min( m_lPos, MinBackBuffer );
+        size_t lDiscard = m_lPos - lKeep;
+        if( lDiscard != 0 )
+        {
+            std::memmove( m_pBuffer.get(), m_pBuffer.get() + lDiscard, m_lLen - lDiscard );
+            m_lBufferOffset += lDiscard;
+            m_lPos -= lDiscard;
+            m_lLen -= lDiscard;
+        }
+
+        size_t lRead = m_pStream->Read( m_pBuffer.get() + m_lLen, m_lBufferSize - m_lLen, m_bStreamEof );
+        m_lLen += lRead;
+        if( lRead != 0 )
+            return true;
+    }
+
+    return false;
+}
+
+size_t PdfStreamInputDevice::Tell() const
+{
+    return m_lBufferOffset + m_lPos;
+}
+
+int PdfStreamInputDevice::GetChar() const
+{
+    int ch;
+    if( TryGetChar( ch ) )
+        return ch;
+    else
+        PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidDeviceOperation, "Failed to read the current character" );
+}
+
+bool PdfStreamInputDevice::TryGetChar( int &ch ) const
+{
+    if( m_lPos == m_lLen && !fill() )
+    {
+        m_bEof = true;
+        ch = -1;
+        return false;
+    }
+
+    ch = static_cast<unsigned char>( m_pBuffer[m_lPos] );
+    m_lPos++;
+    return true;
+}
+
+int PdfStreamInputDevice::Look() const
+{
+    if( m_lPos == m_lLen && !fill() )
+    {
+        m_bEof = true;
+        return -1;
+    }
+
+    return static_cast<unsigned char>( m_pBuffer[m_lPos] );
+}
+
+void PdfStreamInputDevice::Seek( std::streamoff off, std::ios_base::seekdir dir )
+{
+    streamoff pos;
+    switch( dir )
+    {
+        case ios_base::beg:
+            pos = off;
+            break;
+        case ios_base::cur:
+            pos = (streamoff)Tell() + off;
+            break;
+        default:
+            // The end of the stream is not known in advance
+            PODOFO_RAISE_ERROR( EPdfError::InvalidEnumValue );
+    }
+
+    if( pos < (streamoff)m_lBufferOffset || pos > (streamoff)(m_lBufferOffset + m_lLen) )
+        PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidDeviceOperation, "Failed to seek outside of the buffered data" );
+
+    m_lPos = (size_t)pos - m_lBufferOffset;
+    m_bEof = false;
+}
+
+size_t PdfStreamInputDevice::Read( char* pBuffer, size_t lLen )
+{
+    size_t lRead = 0;
+    while( lRead < lLen )
+    {
+        if( m_lPos == m_lLen && !fill() )
+        {
+            m_bEof = true;
+            break;
+        }
+
+        size_t lCount = std::min( lLen - lRead, m_lLen - m_lPos );
+        std::memcpy( pBuffer + lRead, m_pBuffer.get() + m_lPos, lCount );
+        m_lPos += lCount;
+        lRead += lCount;
+    }
+
+    return lRead;
+}
+
+bool PdfStreamInputDevice::Eof() const
+{
+    return m_bEof;
+}
@@ -38,12 +38,15 @@
 
 #include <istream>
 #include <fstream>
+#include <memory>
 
 #include "PdfDefines.h"
 #include "PdfLocale.h"
 
 namespace PoDoFo {
 
+class PdfInputStream;
+
 /** This class provides an Input device which operates 
  *  either on a file, a buffer in memory or any arbitrary std::istream
  *
@@ -53,7 +56,7 @@ namespace PoDoFo {
  */
 class PODOFO_API PdfInputDevice
 {
-private:
+protected:
     PdfInputDevice(bool isSeekable);
 
 public:
@@ -65,12 +68,14 @@ public:
     explicit PdfInputDevice(const std::string_view& filename);
 
     /** Construct a new PdfInputDevice that reads all data from a memory buffer.
-     *  The buffer will not be owned by this object - it is COPIED.
+     *  By default the buffer will not be owned by this object - it is COPIED.
      *
      *  \param pBuffer a buffer in memory
      *  \param lLen the length of the buffer in memory
+     *  \param bCopy if false the buffer is not copied and must stay
+     *               valid for the whole lifetime of the device
      */
-    PdfInputDevice( const char* pBuffer, size_t lLen );
+    PdfInputDevice( const char* pBuffer, size_t lLen, bool bCopy = true );
 
     /** Construct a new PdfInputDevice that reads all data from a std::istream.
      *
@@ -138,10 +143,103 @@ public:
      */
     inline bool IsSeekable() const { return m_bIsSeekable; }
 
+    /**
+     * \return True if the whole content of the device is available
+     * as a contiguous memory span, see GetSpan()
+     */
+    inline bool HasSpan() const { return m_pSpan != nullptr; }
+
+    /** Get the whole content of the device, if it is backed
+     *  by contiguous memory. The view is valid as long as
+     *  the device is not destroyed and it is independent
+     *  from the current position of the device.
+     *
+     *  \returns the device content or an empty view if HasSpan() is false
+     */
+    inline std::string_view GetSpan() const { return std::string_view(m_pSpan, m_lSpanLen); }
+
+protected:
+    /** Let the device read all the data from a contiguous
+     *  memory span instead of a std::istream. The memory is
+     *  not owned by the device.
+     *
+     *  \param pBuffer start of the memory span
+     *  \param lLen length of the memory span
+     */
+    void SetSpan(const char* pBuffer, size_t lLen);
+
 private:
     std::istream* m_pStream;
     bool m_StreamOwned;
     bool m_bIsSeekable;
+
+    // Contiguous memory backend, used instead of m_pStream when set
+    std::unique_ptr<char[]> m_pSpanCopy;
+    const char* m_pSpan;
+    size_t m_lSpanLen;
+    mutable size_t m_lSpanPos;
+    mutable bool m_bSpanEof;
+};
+
+/** An input device which reads the data of a PdfInputStream
+ *  through a buffer of bounded size, e.g. a PdfFilteredInputStream
+ *  decoding a stream while it is being tokenized.
+ *
+ *  Seeking is only possible inside the currently buffered data:
+ *  at least the last MinBackBuffer bytes which have been read
+ *  are always available.
+ */
+class PODOFO_API PdfStreamInputDevice : public PdfInputDevice
+{
+public:
+    /** Number of bytes before the current position that are kept
+     *  when the buffer is refilled
+     */
+    static constexpr size_t MinBackBuffer = 16;
+
+    /** Default size of the buffer
+     */
+    static constexpr size_t DefaultBufferSize = 16384;
+
+    /** Construct a new PdfStreamInputDevice
+     *
+     *  \param pStream the stream to read from. It is owned by the device
+     *  \param lBufferSize size of the buffer of the device
+     */
+    PdfStreamInputDevice( std::unique_ptr<PdfInputStream> pStream, size_t lBufferSize = DefaultBufferSize );
+
+    ~PdfStreamInputDevice();
+
+    size_t Tell() const override;
+
+    int GetChar() const override;
+
+    bool TryGetChar( int &ch ) const override;
+
+    int Look() const override;
+
+    void Seek( std::streamoff off, std::ios_base::seekdir dir = std::ios_base::beg ) override;
+
+    size_t Read( char* pBuffer, size_t lLen ) override;
+
+    bool Eof() const override;
+
+private:
+    /** Read more data from the stream, keeping at most
+     *  MinBackBuffer bytes before the current position
+     *  \returns false if there is no more data to read
+     */
+    bool fill() const;
+
+private:
+    std::unique_ptr<PdfInputStream> m_pStream;
+    std::unique_ptr<char[]> m_pBuffer;
+    size_t m_lBufferSize;
+    mutable size_t m_lBufferOffset;     ///< Position of the buffer start in the stream
+    mutable size_t m_lPos;              ///< Current position in the buffer
+    mutable size_t m_lLen;              ///< Number of valid bytes in the buffer
+    mutable bool m_bStreamEof;
+    mutable bool m_bEof;
 };
 
 };
@@ -35,7 +35,12 @@
 
 #include "PdfInputStream.h"
 
+#include "PdfDictionary.h"
+#include "PdfFilter.h"
 #include "PdfInputDevice.h"
+#include "PdfObject.h"
+#include "PdfOutputStream.h"
+#include "PdfStream.h"
 #include "PdfDefinesPrivate.h"
 
 #include <stdio.h>
@@ -116,3 +121,100 @@ size_t PdfDeviceInputStream::ReadImpl( char* pBuffer, size_t lLen, bool& eof)
     return ret;
 
 }
+
+/** Collects the decoded data of a PdfFilteredInputStream
+ */
+class PdfFilteredInputStream::DecodedOutputStream : public PdfOutputStream
+{
+public:
+    DecodedOutputStream( string & rDecoded )
+        : m_rDecoded( rDecoded )
+    {
+    }
+
+    void Close() override
+    {
+    }
+
+protected:
+    void WriteImpl( const char* data, size_t len ) override
+    {
+        m_rDecoded.append( data, len );
+    }
+
+private:
+    string & m_rDecoded;
+};
+
+PdfFilteredInputStream::PdfFilteredInputStream( const PdfStream & rStream, size_t lChunkSize )
+    : m_pEncoded( rStream.GetInternalBuffer() ),
+      m_lEncodedLen( rStream.GetInternalBufferSize() ),
+      m_lEncodedPos( 0 ),
+      m_lChunkSize( lChunkSize == 0 ? DefaultChunkSize : lChunkSize ),
+      m_bDecodeClosed( false ),
+      m_lDecodedPos( 0 ),
+      m_pSink( new DecodedOutputStream( m_decoded ) )
+{
+    const PdfObject* pParent = rStream.m_pParent;
+    TVecFilters vecFilters = PdfFilterFactory::CreateFilterList( pParent );
+    if( vecFilters.size() )
+    {
+        m_pDecodeStream = PdfFilterFactory::CreateDecodeStream( vecFilters, *m_pSink,
+            pParent ? &pParent->GetDictionary() : nullptr );
+    }
+}
+
+PdfFilteredInputStream::~PdfFilteredInputStream()
+{
+}
+
+size_t PdfFilteredInputStream::ReadImpl( char* pBuffer, size_t lLen, bool& eof )
+{
+    size_t lRead = 0;
+    while( lRead < lLen )
+    {
+        if( m_lDecodedPos == m_decoded.size() )
+        {
+            // All decoded data has been consumed: reuse the buffer
+            m_decoded.clear();
+            m_lDecodedPos = 0;
+            if( !decodeChunk() )
+                break;
+
+            continue;
+        }
+
+        size_t lCount = std::min( lLen - lRead, m_decoded.size() - m_lDecodedPos );
+        memcpy( pBuffer + lRead, m_decoded.data() + m_lDecodedPos, lCount );
+        m_lDecodedPos += lCount;
+        lRead += lCount;
+    }
+
+    eof = m_bDecodeClosed && m_lDecodedPos == m_decoded.size();
+    return lRead;
+}
+
+bool PdfFilteredInputStream::decodeChunk()
+{
+    if( m_bDecodeClosed )
+        return false;
+
+    if( m_lEncodedPos == m_lEncodedLen )
+    {
+        // Flush the data still buffered by the filters
+        m_bDecodeClosed = true;
+        if( m_pDecodeStream )
+            m_pDecodeStream->Close();
+
+        return true;
+    }
+
+    size_t lCount = std::min( m_lChunkSize, m_lEncodedLen - m_lEncodedPos );
+    if( m_pDecodeStream )
+        m_pDecodeStream->Write( m_pEncoded + m_lEncodedPos, lCount );
+    else
+        m_pSink->Write( m_pEncoded + m_lEncodedPos, lCount );
+
+    m_lEncodedPos += lCount;
+    return true;
+}
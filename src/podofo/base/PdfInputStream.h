@@ -37,12 +37,16 @@
 #define _PDF_INPUT_STREAM_H_
 
 #include <fstream>
+#include <memory>
+#include <string>
 
 #include "PdfDefines.h"
 
 namespace PoDoFo {
 
 class PdfInputDevice;
+class PdfOutputStream;
+class PdfStream;
 
 /** An interface for reading blocks of data from an 
  *  a data source.
@@ -134,6 +138,57 @@ private:
     PdfInputDevice* m_pDevice;
 };
 
+/** An input stream that reads the data of a PdfStream
+ *  decoded by all filters specified in its /Filter key.
+ *
+ *  Unlike PdfStream::GetFilteredCopy(), the data is decoded
+ *  incrementally while it is read, one chunk of encoded data
+ *  at a time, so the decoded stream is never held in memory
+ *  as a whole.
+ *
+ *  The PdfStream must not be modified or deleted while
+ *  it is being read.
+ */
+class PODOFO_API PdfFilteredInputStream : public PdfInputStream
+{
+public:
+    /** Default size of the chunks of encoded data passed to the filters
+     */
+    static constexpr size_t DefaultChunkSize = 16384;
+
+    /** Read the decoded data of a stream
+     *
+     *  \param rStream the stream to decode
+     *  \param lChunkSize size of the chunks of encoded data which
+     *                    are decoded at once. The memory used while
+     *                    reading is proportional to this value.
+     */
+    PdfFilteredInputStream( const PdfStream & rStream, size_t lChunkSize = DefaultChunkSize );
+    ~PdfFilteredInputStream();
+
+protected:
+    size_t ReadImpl( char* pBuffer, size_t lLen, bool& eof ) override;
+
+private:
+    /** Decode the next chunk of encoded data
+     *  \returns false if all data has been decoded already
+     */
+    bool decodeChunk();
+
+private:
+    class DecodedOutputStream;
+
+    const char* m_pEncoded;
+    size_t m_lEncodedLen;
+    size_t m_lEncodedPos;
+    size_t m_lChunkSize;
+    bool m_bDecodeClosed;
+    std::string m_decoded;
+    size_t m_lDecodedPos;
+    std::unique_ptr<PdfOutputStream> m_pSink;
+    std::unique_ptr<PdfOutputStream> m_pDecodeStream;
+};
+
 };
 
 #endif // _PDF_INPUT_STREAM_H_
@@ -35,6 +35,7 @@
 
 #include "PdfMemStream.h"
 
+#include <doc/PdfDocument.h>
 #include "PdfArray.h"
 #include "PdfEncrypt.h"
 #include "PdfFilter.h"
@@ -58,11 +59,20 @@ void PdfMemStream::BeginAppendImpl( const TVecFilters & vecFilters )
 {
     m_buffer  = PdfRefCountedBuffer();
 	m_lLength = 0;
+    m_vecPendingFilters.clear();
 
-    if( vecFilters.size() )
+    PdfDocument* pDocument = m_pParent == nullptr ? nullptr : m_pParent->GetDocument();
+    if( vecFilters.size() && pDocument != nullptr && pDocument->GetObjects().GetDeferStreamEncoding() )
+    {
+        // Store the data as is, it's encoded by encodePending()
+        m_vecPendingFilters = vecFilters;
+        m_pendingFlateSettings = GetFlateSettings();
+        m_pStream = unique_ptr<PdfBufferOutputStream>(new PdfBufferOutputStream( &m_buffer ));
+    }
+    else if( vecFilters.size() )
     {
         m_pBufferStream = unique_ptr<PdfBufferOutputStream>(new PdfBufferOutputStream( &m_buffer ));
-        m_pStream = PdfFilterFactory::CreateEncodeStream( vecFilters, *m_pBufferStream );
+        m_pStream = PdfFilterFactory::CreateEncodeStream( vecFilters, *m_pBufferStream, GetFlateSettings() );
     }
     else 
         m_pStream = unique_ptr<PdfBufferOutputStream>(new PdfBufferOutputStream( &m_buffer ));
@@ -98,11 +108,38 @@ void PdfMemStream::EndAppendImpl()
     }
 }
 
+void PdfMemStream::encodePending() const
+{
+    if( hasPendingEncoding() )
+        encodePendingImpl();
+}
+
+void PdfMemStream::encodePendingImpl() const
+{
+    PdfRefCountedBuffer buffer;
+    PdfBufferOutputStream bufferStream( &buffer );
+    unique_ptr<PdfOutputStream> pStream = PdfFilterFactory::CreateEncodeStream( m_vecPendingFilters, bufferStream, m_pendingFlateSettings );
+    pStream->Write( m_buffer.GetBuffer(), m_lLength );
+    pStream->Close();
+    bufferStream.Close();
+
+    setEncoded( buffer, bufferStream.GetLength() );
+}
+
+void PdfMemStream::setEncoded( const PdfRefCountedBuffer & buffer, size_t lLen ) const
+{
+    m_buffer = buffer;
+    m_lLength = lLen;
+    m_vecPendingFilters.clear();
+}
+
 void PdfMemStream::GetCopy( char** pBuffer, size_t* lLen ) const
 {
     if( !pBuffer || !lLen )
         PODOFO_RAISE_ERROR( EPdfError::InvalidHandle );
 
+    encodePending();
+
     *pBuffer = static_cast<char*>(podofo_calloc( m_lLength, sizeof(char) ));
     *lLen = m_lLength;
     
@@ -120,6 +157,8 @@ void PdfMemStream::GetCopy(PdfOutputStream * pStream) const
 	if( !pStream)
 		PODOFO_RAISE_ERROR( EPdfError::InvalidHandle );
 
+    encodePending();
+
 	pStream->Write(m_buffer.GetBuffer(), m_lLength);
 }
 
@@ -155,12 +194,28 @@ void PdfMemStream::CopyFrom(const PdfStream & rhs)
 
 void PdfMemStream::copyFrom(const PdfMemStream &rhs)
 {
-    m_buffer = rhs.m_buffer;
-    m_lLength = rhs.GetLength();
+    if( rhs.m_vecPendingFilters.size() != 0 && rhs.m_lLength != 0 )
+    {
+        // Data pending to be encoded is copied and not shared, as the
+        // pending data of both streams may be encoded in parallel by
+        // PdfWriter and the reference count of the buffer isn't atomic
+        m_buffer = PdfRefCountedBuffer( rhs.m_lLength );
+        memcpy( m_buffer.GetBuffer(), rhs.m_buffer.GetBuffer(), rhs.m_lLength );
+    }
+    else
+    {
+        m_buffer = rhs.m_buffer;
+    }
+
+    m_lLength = rhs.m_lLength;
+    m_vecPendingFilters = rhs.m_vecPendingFilters;
+    m_pendingFlateSettings = rhs.m_pendingFlateSettings;
 }
 
 void PdfMemStream::Write(PdfOutputDevice& pDevice, const PdfEncrypt* pEncrypt)
 {
+    encodePending();
+
     pDevice.Print( "stream\n" );
     if( pEncrypt ) 
     {
@@ -185,20 +240,24 @@ void PdfMemStream::Write(PdfOutputDevice& pDevice, const PdfEncrypt* pEncrypt)
 
 const char* PdfMemStream::Get() const
 {
+    encodePending();
     return m_buffer.GetBuffer();
 }
 
 const char* PdfMemStream::GetInternalBuffer() const
 {
+    encodePending();
     return m_buffer.GetBuffer();
 }
 
 size_t PdfMemStream::GetInternalBufferSize() const
 {
+    encodePending();
     return m_lLength;
 }
 
 size_t PdfMemStream::GetLength() const
 {
+    encodePending();
     return m_lLength;
 }
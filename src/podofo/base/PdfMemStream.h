@@ -63,6 +63,7 @@ class PdfObject;
 class PODOFO_API PdfMemStream final : public PdfStream
 {
     friend class PdfVecObjects;
+    friend class PdfWriter;
 public:
 
     /** Create a new PdfStream object which has a parent PdfObject.
@@ -104,6 +105,9 @@ public:
      *  \warning Do not retain pointers to the stream's internal buffer,
      *           as it may be reallocated with any non-const operation.
      *
+     *  \remarks If the encoding of the data was deferred, it's done
+     *           by this call, so it's not thread-safe
+     *
      *  \returns a read-only handle to the streams data
      */
     const char* Get() const;
@@ -112,6 +116,9 @@ public:
      *  stream buffer, so (eg) for a Flate-compressed stream it will be
      *  the length of the compressed data.
      *
+     *  \remarks If the encoding of the data was deferred, it's done
+     *           by this call, so it's not thread-safe
+     *
      *  \returns the length of the internal buffer
      *  \see Get()
      */
@@ -122,11 +129,13 @@ public:
 
  protected:
     /** Required for the GetFilteredCopy implementation
+     *  \remarks Not thread-safe, like Get()
      *  \returns a handle to the internal buffer
      */
     const char* GetInternalBuffer() const override;
 
     /** Required for the GetFilteredCopy implementation
+     *  \remarks Not thread-safe, like GetLength()
      *  \returns the size of the internal buffer
      */
     size_t GetInternalBufferSize() const override;
@@ -159,11 +168,34 @@ public:
  private:
     PdfMemStream(const PdfMemStream & rhs) = delete;
 
+    /** Encode the data appended while encoding was deferred,
+     *  if any, so that the buffer holds the encoded data
+     *
+     *  \see PdfVecObjects::SetDeferStreamEncoding
+     */
+    void encodePending() const;
+    void encodePendingImpl() const;
+
+    /** Replace the data pending to be encoded with its
+     *  encoded form, produced elsewhere
+     */
+    void setEncoded(const PdfRefCountedBuffer& buffer, size_t lLen) const;
+
+    /** \returns true if there is data to be encoded by encodePending(),
+     *           i.e. data was appended while encoding was deferred and
+     *           no append is in progress
+     */
+    inline bool hasPendingEncoding() const { return m_vecPendingFilters.size() != 0 && m_pStream == nullptr; }
+
  private:
-    PdfRefCountedBuffer m_buffer;
+    // The buffer and its length are mutable as the const getters
+    // may encode the data pending in place, see encodePending()
+    mutable PdfRefCountedBuffer m_buffer;
     std::unique_ptr<PdfOutputStream> m_pStream;
     std::unique_ptr<PdfBufferOutputStream> m_pBufferStream;
-    size_t m_lLength;
+    mutable size_t m_lLength;
+    mutable TVecFilters m_vecPendingFilters;    ///< Filters not yet applied to m_buffer, see encodePending()
+    PdfFlateSettings m_pendingFlateSettings;
 };
 
 };
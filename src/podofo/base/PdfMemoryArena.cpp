@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the PoDoFo developers                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License as       *
+ *   published by the Free Software Foundation; either version 2 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this program; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ *   In addition, as a special exception, the copyright holders give       *
+ *   permission to link the code of portions of this program with the      *
+ *   OpenSSL library under certain conditions as described in each         *
+ *   individual source file, and distribute linked combinations            *
+ *   including the two.                                                    *
+ *   You must obey the GNU General Public License in all respects          *
+ *   for all of the code used other than OpenSSL.  If you modify           *
+ *   file(s) with this exception, you may extend this exception to your    *
+ *   version of the file(s), but you are not obligated to do so.  If you   *
+ *   do not wish to do so, delete this exception statement from your       *
+ *   version.  If you delete this exception statement from all source      *
+ *   files in the program, then also delete it here.                       *
+ ***************************************************************************/
+
+#include "PdfMemoryArena.h"
+
+#include <cstddef>
+#include <functional>
+
+#include "PdfDefinesPrivate.h"
+
+using namespace std;
+using namespace PoDoFo;
+
+// Align all the allocations as malloc does
+static constexpr size_t s_alignment = alignof(max_align_t);
+
+static size_t alignSize(size_t size)
+{
+    return (size + s_alignment - 1) & ~(s_alignment - 1);
+}
+
+PdfMemoryArena::PdfMemoryArena(size_t lBlockSize)
+    : m_lBlockSize(alignSize(lBlockSize)), m_pCurrent(nullptr), m_lRemaining(0)
+{
+}
+
+PdfMemoryArena::~PdfMemoryArena()
+{
+    Reset();
+}
+
+void* PdfMemoryArena::Allocate(size_t lSize)
+{
+    lSize = alignSize(lSize == 0 ? 1 : lSize);
+
+    unique_lock<mutex> lock(m_mutex);
+    if (lSize > m_lRemaining)
+    {
+        if (lSize > m_lBlockSize / 4)
+        {
+            // Serve big allocations with a dedicated block, so
+            // the remaining space of the current block isn't wasted
+            void* block = podofo_malloc(lSize);
+            if (block == nullptr)
+                PODOFO_RAISE_ERROR(EPdfError::OutOfMemory);
+
+            m_blocks.push_back({ block, lSize });
+            return block;
+        }
+
+        void* block = podofo_malloc(m_lBlockSize);
+        if (block == nullptr)
+            PODOFO_RAISE_ERROR(EPdfError::OutOfMemory);
+
+        m_blocks.push_back({ block, m_lBlockSize });
+        m_pCurrent = static_cast<char*>(block);
+        m_lRemaining = m_lBlockSize;
+    }
+
+    void* ret = m_pCurrent;
+    m_pCurrent += lSize;
+    m_lRemaining -= lSize;
+    return ret;
+}
+
+void PdfMemoryArena::Reset()
+{
+    unique_lock<mutex> lock(m_mutex);
+    for (auto& block : m_blocks)
+        podofo_free(block.first);
+
+    m_blocks.clear();
+    m_pCurrent = nullptr;
+    m_lRemaining = 0;
+}
+
+bool PdfMemoryArena::Contains(const void* pMemory) const
+{
+    const char* p = static_cast<const char*>(pMemory);
+    less<const char*> isLess;
+    unique_lock<mutex> lock(m_mutex);
+    for (auto& block : m_blocks)
+    {
+        const char* pBlock = static_cast<const char*>(block.first);
+        if (!isLess(p, pBlock) && isLess(p, pBlock + block.second))
+            return true;
+    }
+
+    return false;
+}
+
+size_t PdfMemoryArena::GetBlockCount() const
+{
+    unique_lock<mutex> lock(m_mutex);
+    return m_blocks.size();
+}
@@ -0,0 +1,150 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the PoDoFo developers                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License as       *
+ *   published by the Free Software Foundation; either version 2 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this program; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ *   In addition, as a special exception, the copyright holders give       *
+ *   permission to link the code of portions of this program with the      *
+ *   OpenSSL library under certain conditions as described in each         *
+ *   individual source file, and distribute linked combinations            *
+ *   including the two.                                                    *
+ *   You must obey the GNU General Public License in all respects          *
+ *   for all of the code used other than OpenSSL.  If you modify           *
+ *   file(s) with this exception, you may extend this exception to your    *
+ *   version of the file(s), but you are not obligated to do so.  If you   *
+ *   do not wish to do so, delete this exception statement from your       *
+ *   version.  If you delete this exception statement from all source      *
+ *   files in the program, then also delete it here.                       *
+ ***************************************************************************/
+
+#ifndef _PDF_MEMORY_ARENA_H_
+#define _PDF_MEMORY_ARENA_H_
+
+#include "PdfDefines.h"
+
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace PoDoFo {
+
+/** A monotonic memory arena: memory is carved from a few large
+ *  blocks, allocated with podofo_malloc, and it's never released
+ *  individually. All the blocks are freed at once when the arena
+ *  is destroyed or reset, so releasing the memory is O(blocks)
+ *
+ *  Allocations are thread safe.
+ *
+ *  \see PdfVecObjects::SetUseMemoryArena
+ */
+class PODOFO_API PdfMemoryArena
+{
+public:
+    /** Create an empty arena
+     *  \param lBlockSize the size of the blocks used to serve allocations.
+     *         Bigger allocations get a block on their own
+     */
+    PdfMemoryArena(size_t lBlockSize = 64 * 1024);
+
+    ~PdfMemoryArena();
+
+    /** Allocate memory from the arena. The memory stays valid
+     *  until the arena is reset or destroyed.
+     *  \param lSize size of the memory in bytes
+     *  \returns memory suitably aligned for any fundamental type
+     */
+    void* Allocate(size_t lSize);
+
+    /** Create an object of type T in the arena, or on the heap
+     *  if pArena is nullptr. In both cases the object is released
+     *  with delete: for arena objects this runs the destructor,
+     *  while the memory is released only with the arena
+     *  \param pArena the arena to allocate the object from, or nullptr
+     *  \param args arguments forwarded to the constructor of T
+     *  \returns the new object
+     */
+    template <typename T, typename... TArgs>
+    static T* Create(PdfMemoryArena* pArena, TArgs&&... args);
+
+    /** Free all the memory allocated by the arena
+     */
+    void Reset();
+
+    /** Check if memory was allocated from the arena.
+     *  This is O(blocks)
+     *  \param pMemory the memory to check
+     *  \returns true if pMemory is in one of the blocks of the arena
+     */
+    bool Contains(const void* pMemory) const;
+
+    /**
+     * \returns the number of blocks currently allocated
+     */
+    size_t GetBlockCount() const;
+
+private:
+    PdfMemoryArena(const PdfMemoryArena&) = delete;
+    PdfMemoryArena& operator=(const PdfMemoryArena&) = delete;
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<std::pair<void*, size_t>> m_blocks;   ///< Blocks and their sizes
+    size_t m_lBlockSize;
+    char* m_pCurrent;
+    size_t m_lRemaining;
+};
+
+/** An object of type T allocated from a PdfMemoryArena.
+ *  Deleting it through a pointer to T runs the destructor
+ *  and leaves the memory to the arena, so T must have a
+ *  virtual destructor. Heap objects of type T don't pay
+ *  anything for it.
+ *
+ *  \see PdfMemoryArena::Create
+ */
+template <typename T>
+class PdfArenaObject final : public T
+{
+public:
+    template <typename... TArgs>
+    PdfArenaObject(TArgs&&... args)
+        : T(std::forward<TArgs>(args)...) { }
+
+    static void* operator new(size_t size, PdfMemoryArena& rArena)
+    {
+        return rArena.Allocate(size);
+    }
+
+    // The memory is released with the arena
+    static void operator delete(void*) { }
+    static void operator delete(void*, PdfMemoryArena&) { }
+};
+
+template <typename T, typename... TArgs>
+T* PdfMemoryArena::Create(PdfMemoryArena* pArena, TArgs&&... args)
+{
+    static_assert(std::has_virtual_destructor<T>::value, "Arena objects are deleted through a virtual destructor");
+    if (pArena == nullptr)
+        return new T(std::forward<TArgs>(args)...);
+
+    return new (*pArena) PdfArenaObject<T>(std::forward<TArgs>(args)...);
+}
+
+};
+
+#endif // _PDF_MEMORY_ARENA_H_
@@ -0,0 +1,157 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the PoDoFo developers                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License as       *
+ *   published by the Free Software Foundation; either version 2 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this program; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ *   In addition, as a special exception, the copyright holders give       *
+ *   permission to link the code of portions of this program with the      *
+ *   OpenSSL library under certain conditions as described in each         *
+ *   individual source file, and distribute linked combinations            *
+ *   including the two.                                                    *
+ *   You must obey the GNU General Public License in all respects          *
+ *   for all of the code used other than OpenSSL.  If you modify           *
+ *   file(s) with this exception, you may extend this exception to your    *
+ *   version of the file(s), but you are not obligated to do so.  If you   *
+ *   do not wish to do so, delete this exception statement from your       *
+ *   version.  If you delete this exception statement from all source      *
+ *   files in the program, then also delete it here.                       *
+ ***************************************************************************/
+
+#include "PdfMemoryMappedInputDevice.h"
+
+#include "PdfDefinesPrivate.h"
+
+#ifdef WIN32
+#include <windows.h>
+#include <utfcpp/utf8.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace PoDoFo;
+
+PdfMemoryMappedInputDevice::PdfMemoryMappedInputDevice(const string_view& filename)
+    : PdfInputDevice(true),
+    m_pMapping(nullptr),
+    m_lMappingLen(0)
+#ifdef WIN32
+    , m_hFile(INVALID_HANDLE_VALUE),
+    m_hMapping(nullptr)
+#endif
+{
+    if (filename.length() == 0)
+        PODOFO_RAISE_ERROR(EPdfError::InvalidHandle);
+
+#ifdef WIN32
+    auto filename16 = utf8::utf8to16((string)filename);
+    HANDLE hFile = CreateFileW((wchar_t*)filename16.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        PODOFO_RAISE_ERROR_INFO(EPdfError::FileNotFound, (string)filename);
+
+    m_hFile = hFile;
+    LARGE_INTEGER size;
+    if (GetFileType(hFile) != FILE_TYPE_DISK || !GetFileSizeEx(hFile, &size))
+    {
+        Close();
+        PODOFO_RAISE_ERROR_INFO(EPdfError::InvalidDeviceOperation, "Unable to get the size of the file to map");
+    }
+
+    m_lMappingLen = (size_t)size.QuadPart;
+    if (m_lMappingLen != 0)
+    {
+        m_hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_hMapping == nullptr)
+        {
+            Close();
+            PODOFO_RAISE_ERROR_INFO(EPdfError::InvalidDeviceOperation, "Unable to map the file in memory");
+        }
+
+        m_pMapping = MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+        if (m_pMapping == nullptr)
+        {
+            Close();
+            PODOFO_RAISE_ERROR_INFO(EPdfError::InvalidDeviceOperation, "Unable to map the file in memory");
+        }
+    }
+#else
+    // The view may not be null terminated
+    string sFilename(filename);
+    int fd = ::open(sFilename.c_str(), O_RDONLY);
+    if (fd == -1)
+        PODOFO_RAISE_ERROR_INFO(EPdfError::FileNotFound, sFilename.c_str());
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        PODOFO_RAISE_ERROR_INFO(EPdfError::InvalidDeviceOperation, "Unable to map a file that is not a regular file");
+    }
+
+    m_lMappingLen = (size_t)st.st_size;
+    if (m_lMappingLen != 0)
+    {
+        void* pMapping = mmap(nullptr, m_lMappingLen, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pMapping == MAP_FAILED)
+        {
+            ::close(fd);
+            PODOFO_RAISE_ERROR_INFO(EPdfError::InvalidDeviceOperation, "Unable to map the file in memory");
+        }
+
+        m_pMapping = pMapping;
+    }
+
+    // The mapping stays valid after closing the descriptor
+    ::close(fd);
+#endif
+
+    SetSpan(static_cast<const char*>(m_pMapping), m_lMappingLen);
+}
+
+PdfMemoryMappedInputDevice::~PdfMemoryMappedInputDevice()
+{
+    // NOTE: The base class destructor can't reach this override
+    Close();
+}
+
+void PdfMemoryMappedInputDevice::Close()
+{
+    SetSpan(nullptr, 0);
+
+#ifdef WIN32
+    if (m_pMapping != nullptr)
+        UnmapViewOfFile(m_pMapping);
+
+    if (m_hMapping != nullptr)
+        CloseHandle(m_hMapping);
+
+    if (m_hFile != INVALID_HANDLE_VALUE)
+        CloseHandle(m_hFile);
+
+    m_hMapping = nullptr;
+    m_hFile = INVALID_HANDLE_VALUE;
+#else
+    if (m_pMapping != nullptr)
+        munmap(m_pMapping, m_lMappingLen);
+#endif
+
+    m_pMapping = nullptr;
+    m_lMappingLen = 0;
+}
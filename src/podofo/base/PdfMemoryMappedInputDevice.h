@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the PoDoFo developers                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License as       *
+ *   published by the Free Software Foundation; either version 2 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this program; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ *   In addition, as a special exception, the copyright holders give       *
+ *   permission to link the code of portions of this program with the      *
+ *   OpenSSL library under certain conditions as described in each         *
+ *   individual source file, and distribute linked combinations            *
+ *   including the two.                                                    *
+ *   You must obey the GNU General Public License in all respects          *
+ *   for all of the code used other than OpenSSL.  If you modify           *
+ *   file(s) with this exception, you may extend this exception to your    *
+ *   version of the file(s), but you are not obligated to do so.  If you   *
+ *   do not wish to do so, delete this exception statement from your       *
+ *   version.  If you delete this exception statement from all source      *
+ *   files in the program, then also delete it here.                       *
+ ***************************************************************************/
+
+#ifndef _PDF_MEMORY_MAPPED_INPUT_DEVICE_H_
+#define _PDF_MEMORY_MAPPED_INPUT_DEVICE_H_
+
+#include "PdfDefines.h"
+#include "PdfInputDevice.h"
+
+namespace PoDoFo {
+
+/** An input device that maps a whole file in memory
+ *  and reads it without copying, so that the content is
+ *  always available through PdfInputDevice::GetSpan()
+ *
+ *  The file must not be truncated or rewritten while
+ *  the device is alive.
+ */
+class PODOFO_API PdfMemoryMappedInputDevice : public PdfInputDevice
+{
+public:
+    /** Map the file with the given name in memory.
+     *
+     *  Raises FileNotFound if the file can't be opened
+     *  and InvalidDeviceOperation if it can't be mapped
+     *  (e.g. it's not a regular file)
+     *
+     *  \param filename path to a file
+     */
+    explicit PdfMemoryMappedInputDevice(const std::string_view& filename);
+
+    ~PdfMemoryMappedInputDevice();
+
+    void Close() override;
+
+private:
+    PdfMemoryMappedInputDevice(const PdfMemoryMappedInputDevice&) = delete;
+    PdfMemoryMappedInputDevice& operator=(const PdfMemoryMappedInputDevice&) = delete;
+
+private:
+    void* m_pMapping;
+    size_t m_lMappingLen;
+#ifdef WIN32
+    void* m_hFile;
+    void* m_hMapping;
+#endif
+};
+
+};
+
+#endif // _PDF_MEMORY_MAPPED_INPUT_DEVICE_H_
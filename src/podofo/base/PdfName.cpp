@@ -36,6 +36,7 @@
 #include "PdfName.h"
 
 #include <cassert>
+#include <unordered_map>
 
 #include "PdfOutputDevice.h"
 #include "PdfTokenizer.h"
@@ -50,6 +51,8 @@ void hexchr(const unsigned char ch, T & it);
 
 static string EscapeName(const string_view & view);
 static string UnescapeName(const string_view& view);
+static const shared_ptr<string>* getAtom(const string_view& view);
+static shared_ptr<string> getNameData(const string_view& view, bool& isAtom);
 
 const PdfName PdfName::KeyNull = PdfName();
 const PdfName PdfName::KeyContents  = PdfName( "Contents" );
@@ -62,7 +65,7 @@ const PdfName PdfName::KeyType      = PdfName( "Type" );
 const PdfName PdfName::KeyFilter    = PdfName( "Filter" );
 
 PdfName::PdfName()
-    : m_data(std::make_shared<string>()), m_isUtf8Expanded(true)
+    : m_data(*getAtom({ })), m_isUtf8Expanded(true)
 {
 }
 
@@ -91,6 +94,14 @@ PdfName::PdfName(const PdfName& rhs)
 {
 }
 
+PdfName::PdfName(PdfName&& rhs) noexcept
+    : m_data(std::move(rhs.m_data)), m_isUtf8Expanded(rhs.m_isUtf8Expanded), m_utf8String(std::move(rhs.m_utf8String))
+{
+    // Leave the moved-from name a valid empty name
+    rhs.m_data = *getAtom({ });
+    rhs.m_isUtf8Expanded = true;
+}
+
 PdfName::PdfName(const shared_ptr<string>& rawdata)
     : m_data(rawdata), m_isUtf8Expanded(false)
 {
@@ -100,7 +111,7 @@ void PdfName::initFromUtf8String(const string_view& view)
 {
     if (view.length() == 0)
     {
-        m_data = std::make_shared<string>();
+        m_data = *getAtom({ });
         m_isUtf8Expanded = true;
         return;
     }
@@ -111,7 +122,8 @@ void PdfName::initFromUtf8String(const string_view& view)
 
     if (isPdfDocEncodingEqual)
     {
-        m_data = std::make_shared<string>(view);
+        bool isAtom;
+        m_data = getNameData(view, isAtom);
     }
     else
     {
@@ -124,6 +136,10 @@ void PdfName::initFromUtf8String(const string_view& view)
 
 PdfName PdfName::FromEscaped(const std::string_view& view)
 {
+    // Most names have no escape sequences: avoid the copy
+    if (view.find('#') == string_view::npos)
+        return FromRaw(view);
+
     return FromRaw(UnescapeName(view));
 }
 
@@ -135,12 +151,23 @@ PdfName PdfName::FromEscaped(const char * pszName, size_t ilen)
     if( !ilen )
         ilen = strlen( pszName );
 
-    return FromRaw(UnescapeName({ pszName, ilen }));
+    return FromEscaped({ pszName, ilen });
 }
 
 PdfName PdfName::FromRaw(const string_view & rawcontent)
 {
-    return PdfName(std::make_shared<string>(rawcontent));
+    bool isAtom;
+    PdfName ret(getNameData(rawcontent, isAtom));
+    // Well known names are all ASCII, which is the same
+    // in both PdfDocEncoding and UTF-8
+    ret.m_isUtf8Expanded = isAtom;
+    return ret;
+}
+
+bool PdfName::IsInterned() const
+{
+    auto atom = getAtom(*m_data);
+    return atom != nullptr && *atom == m_data;
 }
 
 void PdfName::Write( PdfOutputDevice& pDevice, EPdfWriteMode, const PdfEncrypt* ) const
@@ -177,6 +204,86 @@ void PdfName::expandUtf8String() const
     }
 }
 
+/** Return the shared data of a well known name, or nullptr
+ *  if the name is not interned.
+ *
+ *  The table is built once on first use and never modified
+ *  afterwards, so lookups are safe from multiple threads
+ */
+const shared_ptr<string>* getAtom(const string_view& view)
+{
+    static const char* s_atoms[] = {
+        "", "A", "AA", "AcroForm", "Action", "Alternate", "Annot", "Annots",
+        "AP", "AS", "Ascent", "ASCII85Decode", "ASCIIHexDecode", "Author",
+        "AvgWidth", "BaseEncoding", "BaseFont", "BBox", "BitsPerComponent",
+        "BM", "Border", "BS", "C", "CA", "ca", "CapHeight", "Catalog",
+        "CCITTFaxDecode", "CharProcs", "CharSet", "CIDFontType0",
+        "CIDFontType2", "CIDSystemInfo", "CIDToGIDMap", "ColorSpace",
+        "Colors", "Columns", "Contents", "Count", "CreationDate", "Creator",
+        "CropBox", "CS", "D", "DA", "DCTDecode", "Decode", "DecodeParms",
+        "Descent", "DescendantFonts", "Dest", "Dests", "DeviceCMYK",
+        "DeviceGray", "DeviceRGB", "Differences", "DR", "DW", "Encoding",
+        "Encrypt", "ExtGState", "Extensions", "F", "Ff", "Fields", "Filter",
+        "First", "FirstChar", "Flags", "FlateDecode", "Font", "FontBBox",
+        "FontDescriptor", "FontFile", "FontFile2", "FontFile3", "FontMatrix",
+        "FontName", "Form", "FT", "Function", "FunctionType", "GoTo",
+        "Group", "Height", "I", "ICCBased", "ID", "Identity", "Identity-H",
+        "Image", "ImageB", "ImageC", "ImageI", "Index", "Indexed", "Info",
+        "Interpolate", "ItalicAngle", "JBIG2Decode", "JPXDecode", "K",
+        "Kids", "Lang", "Last", "LastChar", "Leading", "Length", "Length1",
+        "Length2", "Length3", "Link", "LW", "LZWDecode", "MacRomanEncoding",
+        "Mask", "Matrix", "MaxWidth", "MediaBox", "Metadata", "MissingWidth",
+        "MK", "ModDate", "N", "Names", "Next", "Normal", "ObjStm", "Off",
+        "OP", "op", "OpenAction", "OPM", "Ordering", "Outlines", "P", "Page",
+        "PageLabels", "PageLayout", "PageMode", "Pages", "Parent", "Pattern",
+        "PatternType", "PDF", "Predictor", "Prev", "ProcSet", "Producer",
+        "Properties", "Range", "Rect", "Registry", "Resources", "Root",
+        "Rotate", "RunLengthDecode", "S", "Shading", "ShadingType", "Sig",
+        "Size", "SMask", "StandardEncoding", "StemH", "StemV",
+        "StructParents", "StructTreeRoot", "Subject", "Subtype", "Supplement",
+        "T", "Text", "Title", "ToUnicode", "Transparency", "TrueType", "Type",
+        "Type0", "Type1", "Type3", "URI", "V", "W", "Widget", "Width",
+        "Widths", "WinAnsiEncoding", "XHeight", "XObject", "XRef", "XStep",
+        "YStep",
+    };
+
+    struct Atoms
+    {
+        Atoms()
+        {
+            for (const char* atom : s_atoms)
+            {
+                auto data = std::make_shared<string>(atom);
+                // The key view points to the shared data, which is never modified
+                string_view key = *data;
+                Map[key] = std::move(data);
+            }
+        }
+
+        unordered_map<string_view, shared_ptr<string>> Map;
+    };
+
+    static const Atoms s_table;
+    auto found = s_table.Map.find(view);
+    if (found == s_table.Map.end())
+        return nullptr;
+
+    return &found->second;
+}
+
+shared_ptr<string> getNameData(const string_view& view, bool& isAtom)
+{
+    auto atom = getAtom(view);
+    if (atom == nullptr)
+    {
+        isAtom = false;
+        return std::make_shared<string>(view);
+    }
+
+    isAtom = true;
+    return *atom;
+}
+
 /** Escape the input string according to the PDF name
  *  escaping rules and return the result.
  *
@@ -296,8 +403,28 @@ const PdfName& PdfName::operator=(const PdfName& rhs)
     return *this;
 }
 
+const PdfName& PdfName::operator=(PdfName&& rhs) noexcept
+{
+    if (this == &rhs)
+        return *this;
+
+    m_data = std::move(rhs.m_data);
+    m_isUtf8Expanded = rhs.m_isUtf8Expanded;
+    m_utf8String = std::move(rhs.m_utf8String);
+
+    // Leave the moved-from name a valid empty name
+    rhs.m_data = *getAtom({ });
+    rhs.m_isUtf8Expanded = true;
+    return *this;
+}
+
 bool PdfName::operator==(const PdfName& rhs) const
 {
+    // Names sharing the same buffer, such as copies of the
+    // same name, can be compared without touching the data
+    if (m_data == rhs.m_data)
+        return true;
+
     return *this->m_data == *rhs.m_data;
 }
 
@@ -319,6 +446,9 @@ bool PdfName::operator==(const string_view& view) const
 
 bool PdfName::operator!=(const PdfName& rhs) const
 {
+    if (m_data == rhs.m_data)
+        return false;
+
     return *this->m_data != *rhs.m_data;
 }
 
@@ -340,6 +470,9 @@ bool PdfName::operator!=(const string_view& view) const
 
 bool PdfName::operator<(const PdfName& rhs) const
 {
+    if (m_data == rhs.m_data)
+        return false;
+
     return *this->m_data < *rhs.m_data;
 }
 
@@ -85,6 +85,11 @@ public:
      */
     PdfName(const PdfName& rhs);
 
+    /** Move an existing PdfName object.
+     *  \param rhs another PdfName object
+     */
+    PdfName(PdfName&& rhs) noexcept;
+
     static PdfName FromRaw(const std::string_view &rawcontent);
 
     /** Create a new PdfName object from a string containing an escaped
@@ -138,6 +143,18 @@ public:
      */
     const PdfName& operator=( const PdfName & rhs );
 
+    /** Move another name to this object
+     *  \param rhs another PdfName object
+     */
+    const PdfName& operator=( PdfName && rhs ) noexcept;
+
+    /** Well known names, such as /Type or /Length, are interned:
+     *  all the instances share the same data, so they are cheap to
+     *  create and they can be compared by pointer
+     *  \returns true if this name is interned
+     */
+    bool IsInterned() const;
+
     /** compare to PdfName objects.
      *  \returns true if both PdfNames have the same value.
      */
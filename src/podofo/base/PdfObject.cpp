@@ -92,6 +92,24 @@ PdfObject::PdfObject( const PdfObject & rhs )
     copyFrom(rhs);
 }
 
+// NOTE: Moved objects keep parent document/container and
+// reference, as moving is used to relocate objects in containers
+PdfObject::PdfObject(PdfObject&& rhs) noexcept
+    : m_Variant(std::move(rhs.m_Variant)),
+    m_IndirectReference(rhs.m_IndirectReference),
+    m_Document(rhs.m_Document),
+    m_Parent(rhs.m_Parent),
+    m_IsDirty(rhs.m_IsDirty),
+    m_IsImmutable(rhs.m_IsImmutable),
+    m_bDelayedLoadDone(rhs.m_bDelayedLoadDone),
+    m_DelayedLoadStreamDone(rhs.m_DelayedLoadStreamDone),
+    m_pStream(std::move(rhs.m_pStream))
+{
+    SetVariantOwner();
+    if (m_pStream != nullptr)
+        m_pStream->m_pParent = this;
+}
+
 // NOTE: Dirty objects are those who are supposed to be serialized
 // or deserialized.
 PdfObject::PdfObject(const PdfVariant& var, bool isDirty)
@@ -178,7 +196,11 @@ void PdfObject::Write(PdfOutputDevice& pDevice, EPdfWriteMode eWriteMode,
         // CHECK-ME We want to make this in all the cases for PDF/A Compatibility
         //if( (eWriteMode & EPdfWriteMode::Clean) == EPdfWriteMode::Clean )
         {
-            pDevice.Print( "%i %i obj\n", m_IndirectReference.ObjectNumber(), m_IndirectReference.GenerationNumber() );
+            char buffer[utls::FormatBufferSize];
+            pDevice.Write( utls::FormatTo( buffer, static_cast<int64_t>(m_IndirectReference.ObjectNumber()) ) );
+            pDevice.Write( " ", 1 );
+            pDevice.Write( utls::FormatTo( buffer, static_cast<int64_t>(m_IndirectReference.GenerationNumber()) ) );
+            pDevice.Write( " obj\n", 5 );
         }
         //else
         //{
@@ -330,6 +352,19 @@ const PdfObject & PdfObject::operator=(const PdfObject & rhs)
     return *this;
 }
 
+const PdfObject& PdfObject::operator=(PdfObject&& rhs)
+{
+    if (&rhs == this)
+        return *this;
+
+    rhs.DelayedLoad();
+    m_Variant = std::move(rhs.m_Variant);
+    // NOTE: Streams are rare on moved objects: just copy them
+    copyFrom(rhs);
+    SetDirty();
+    return *this;
+}
+
 // NOTE: Don't copy parent document/container and indirect reference.
 // Objects being assigned always keep current ownership
 void PdfObject::copyFrom(const PdfObject & rhs)
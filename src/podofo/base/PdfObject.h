@@ -76,6 +76,7 @@ class PODOFO_API PdfObject
     friend class PdfStream;
     friend class PdfContainerDataType;
     friend class PdfObjectStreamParser;
+    friend class PdfWriter;
 
 public:
 
@@ -155,6 +156,14 @@ public:
      */
     PdfObject( const PdfObject & rhs );
 
+    /** Move an existing PdfObject.
+     *  Differently from copy, the parent container, document and
+     *  indirect reference are kept, so objects can be cheaply
+     *  relocated by containers (eg. PdfArray)
+     *  \param rhs PdfObject to move. It's left as a null object
+     */
+    PdfObject( PdfObject && rhs ) noexcept;
+
 public:
     /** Clear all internal member variables and free the memory
      *  they have allocated.
@@ -463,6 +472,13 @@ public:
      */
     const PdfObject& operator=(const PdfObject& rhs);
 
+    /** Move an existing PdfObject into this one.
+     *  As with copy, this object keeps its current ownership
+     *  \param rhs PdfObject to move. It's left as a null object
+     *  \returns a reference to this object
+     */
+    const PdfObject& operator=(PdfObject&& rhs);
+
     operator const PdfVariant& () const;
 
 public:
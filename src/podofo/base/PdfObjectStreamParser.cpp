@@ -39,12 +39,13 @@
 #include "PdfDictionary.h"
 #include "PdfEncrypt.h"
 #include "PdfInputDevice.h"
+#include "PdfMemoryArena.h"
+#include "PdfOutputStream.h"
 #include "PdfParserObject.h"
 #include "PdfStream.h"
 #include "PdfVecObjects.h"
 
 #include <limits>
-#include <algorithm>
 
 #ifndef VERBOSE_DEBUG_DISABLED
 #include <iostream>
@@ -53,77 +54,128 @@
 using namespace std;
 using namespace PoDoFo;
 
-PdfObjectStreamParser::PdfObjectStreamParser(PdfParserObject* pParser, PdfVecObjects* pVecObjects, const PdfRefCountedBuffer & rBuffer, PdfEncrypt* pEncrypt )
-    : m_pParser( pParser ), m_vecObjects( pVecObjects ), m_buffer( rBuffer ), m_pEncrypt( pEncrypt )
+namespace
 {
+    // An object of an object stream, which is read
+    // from the stream when its value is first accessed
+    class PdfCompressedObject : public PdfObject
+    {
+    public:
+        PdfCompressedObject(const shared_ptr<PdfObjectStreamParser>& pParser, uint32_t nObjNo, unsigned nIndex)
+            : PdfObject(PdfVariant::NullValue, false), m_pParser(pParser), m_nObjNo(nObjNo), m_nIndex(nIndex)
+        {
+            EnableDelayedLoading();
+        }
+
+    protected:
+        void DelayedLoadImpl() override
+        {
+            if (!m_pParser->TryReadObject(m_nObjNo, m_nIndex, m_Variant))
+            {
+                // References to missing objects are treated as null
+                PdfError::LogMessage(ELogSeverity::Warning, "Object %u 0 R not found in its object stream", m_nObjNo);
+            }
+
+            // Release the decoded stream, once all its objects are read
+            m_pParser = nullptr;
+        }
 
+    private:
+        shared_ptr<PdfObjectStreamParser> m_pParser;
+        uint32_t m_nObjNo;
+        unsigned m_nIndex;
+    };
 }
 
-void PdfObjectStreamParser::Parse(ObjectIdList const & list)
+PdfObjectStreamParser::PdfObjectStreamParser(const PdfObject& rObjStm, const PdfRefCountedBuffer & rBuffer, PdfEncrypt* pEncrypt )
+    : m_pObjStm( new PdfObject( rObjStm ) ), m_reference( rObjStm.GetIndirectReference() ),
+      m_buffer( rBuffer ), m_pEncrypt( pEncrypt ), m_bLoaded( false ), m_lFirst( 0 )
 {
-    int64_t lNum   = m_pParser->GetDictionary().GetKeyAsNumber( "N", 0 );
-    int64_t lFirst = m_pParser->GetDictionary().GetKeyAsNumber( "First", 0 );
-    
-    unique_ptr<char> buffer;
-    size_t lBufferLen;
-    m_pParser->GetOrCreateStream().GetFilteredCopy(buffer, lBufferLen);
-
-    this->ReadObjectsFromStream(buffer.get(), lBufferLen, lNum, lFirst, list );
-    m_pParser = nullptr;
 }
 
-void PdfObjectStreamParser::ReadObjectsFromStream( char* pBuffer, size_t lBufferLen, int64_t lNum, int64_t lFirst, ObjectIdList const & list)
+bool PdfObjectStreamParser::TryReadObject(uint32_t nObjNo, unsigned nIndex, PdfVariant& rVariant)
 {
-    PdfRefCountedInputDevice device( pBuffer, lBufferLen );
-    PdfTokenizer tokenizer(m_buffer );
-    PdfVariant var;
-    int i = 0;
+    if (!m_bLoaded)
+        load();
 
-    while( static_cast<int64_t>(i) < lNum )
+    int64_t lOff = -1;
+    if (nIndex < m_offsets.size() && m_offsets[nIndex].first == static_cast<int64_t>(nObjNo))
     {
-        const int64_t lObj = tokenizer.ReadNextNumber(device);
-        const int64_t lOff = tokenizer.ReadNextNumber(device);
-        size_t pos = device.Device()->Tell();
-
-        if( lFirst >= std::numeric_limits<int64_t>::max() - lOff )
+        lOff = m_offsets[nIndex].second;
+    }
+    else
+    {
+        // The index in the xref stream is wrong, search the object
+        for (auto& offset : m_offsets)
         {
-            PODOFO_RAISE_ERROR_INFO( EPdfError::BrokenFile,
-                                    "Object position out of max limit" );
+            if (offset.first == static_cast<int64_t>(nObjNo))
+            {
+                lOff = offset.second;
+                break;
+            }
         }
 
-        // move to the position of the object in the stream
-        device.Device()->Seek( static_cast<std::streamoff>(lFirst + lOff) );
-
-		// use a second tokenizer here so that anything that gets dequeued isn't left in the tokenizer that reads the offsets and lengths
-	    PdfTokenizer variantTokenizer(m_buffer);
-		if (m_pEncrypt && (m_pEncrypt->GetEncryptAlgorithm() == EPdfEncryptAlgorithm::AESV2
-			|| m_pEncrypt->GetEncryptAlgorithm() == EPdfEncryptAlgorithm::RC4V2))
-        {
-            variantTokenizer.ReadNextVariant(device, var); // Stream is already decrypted
-        }
-        else
-        {
-            variantTokenizer.ReadNextVariant(device, var, m_pEncrypt);
-        }
+        if (lOff < 0)
+            return false;
+    }
 
-		bool should_read = std::find(list.begin(), list.end(), lObj) != list.end();
 #ifndef VERBOSE_DEBUG_DISABLED
-        std::cerr << "ReadObjectsFromStream STREAM=" << m_pParser->GetIndirectReference().ToString() <<
-			", OBJ=" << lObj <<
-			", " << (should_read ? "read" : "skipped") << std::endl;
+    std::cerr << "ReadObjectsFromStream STREAM=" << m_reference.ToString() <<
+        ", OBJ=" << nObjNo << std::endl;
 #endif
-		if (should_read)
-        {
-            // The generation number of an object stream and of any
-            // compressed object is implicitly zero
-            PdfReference reference(static_cast<uint32_t>(lObj), 0);
-            auto obj = new PdfObject(var);
-            m_vecObjects->PushObject(reference, obj);
-		}
 
-        // move back to the position inside of the table of contents
-        device.Device()->Seek( pos );
+    // move to the position of the object in the stream
+    m_device.Device()->Seek( static_cast<std::streamoff>(m_lFirst + lOff) );
 
-        ++i;
+    PdfTokenizer tokenizer(m_buffer);
+    if (m_pEncrypt && (m_pEncrypt->GetEncryptAlgorithm() == EPdfEncryptAlgorithm::AESV2
+        || m_pEncrypt->GetEncryptAlgorithm() == EPdfEncryptAlgorithm::RC4V2))
+    {
+        tokenizer.ReadNextVariant(m_device, rVariant); // Stream is already decrypted
     }
+    else
+    {
+        tokenizer.ReadNextVariant(m_device, rVariant, m_pEncrypt);
+    }
+
+    return true;
+}
+
+PdfObject* PdfObjectStreamParser::CreateDelayedObject(const shared_ptr<PdfObjectStreamParser>& pParser,
+    uint32_t nObjNo, unsigned nIndex, PdfMemoryArena* pArena)
+{
+    return PdfMemoryArena::Create<PdfCompressedObject>(pArena, pParser, nObjNo, nIndex);
+}
+
+void PdfObjectStreamParser::load()
+{
+    int64_t lNum   = m_pObjStm->GetDictionary().GetKeyAsNumber( "N", 0 );
+    m_lFirst = m_pObjStm->GetDictionary().GetKeyAsNumber( "First", 0 );
+
+    m_stream = PdfRefCountedBuffer();
+    m_offsets.clear();
+    PdfBufferOutputStream stream(&m_stream);
+    m_pObjStm->GetOrCreateStream().GetFilteredCopy(&stream);
+
+    // The device borrows the decoded stream, which is cached
+    m_device = PdfRefCountedInputDevice( new PdfInputDevice( m_stream.GetBuffer(), m_stream.GetSize(), false ) );
+
+    // Read the object numbers and offsets, which precede the objects
+    PdfTokenizer tokenizer(m_buffer);
+    for (int64_t i = 0; i < lNum; i++)
+    {
+        const int64_t lObj = tokenizer.ReadNextNumber(m_device);
+        const int64_t lOff = tokenizer.ReadNextNumber(m_device);
+        if( m_lFirst >= std::numeric_limits<int64_t>::max() - lOff )
+        {
+            PODOFO_RAISE_ERROR_INFO( EPdfError::BrokenFile,
+                                    "Object position out of max limit" );
+        }
+
+        m_offsets.push_back(make_pair(lObj, lOff));
+    }
+
+    // The encoded data is no longer needed
+    m_pObjStm = nullptr;
+    m_bLoaded = true;
 }
@@ -39,45 +39,78 @@
 #include "PdfDefines.h"
 
 #include "PdfRefCountedBuffer.h"
+#include "PdfRefCountedInputDevice.h"
 #include "PdfParserObject.h"
 
+#include <memory>
+#include <vector>
+
 namespace PoDoFo {
 
 class PdfEncrypt;
-class PdfVecObjects;
+class PdfMemoryArena;
 
 /**
  * A utility class for PdfParser that can parse
  * an object stream object (PDF Reference 1.7 3.4.6 Object Streams)
  *
- * It is mainly here to make PdfParser more modular.
+ * The object stream is decoded only the first time one of its
+ * objects is read, then the decoded stream is cached, so
+ * the same parser can be shared by all the objects in the stream.
  */
 class PdfObjectStreamParser
 {
 public:
-	typedef std::vector<int64_t> ObjectIdList;
     /**
-     * Create a new PdfObjectStreamParserObject from an existing
-     * PdfParserObject. The PdfParserObject will be removed and deleted.
-     * All objects from the object stream will be read into memory.
+     * Create a new PdfObjectStreamParser from an object stream
+     * object. The parser keeps a copy of the object, sharing its
+     * still encoded stream data, so the object can be removed from
+     * the document before the objects of the stream are read.
      *
-     * \param pParser PdfParserObject for an object stream
-     * \param pVecObjects add loaded objecs to this vector of objects
+     * \param rObjStm the object stream
      * \param rBuffer use this allocated buffer for caching
      * \param pEncrypt encryption object used to decrypt streams
      */
-    PdfObjectStreamParser(PdfParserObject* pParser, PdfVecObjects* pVecObjects, const PdfRefCountedBuffer & rBuffer, PdfEncrypt* pEncrypt );
+    PdfObjectStreamParser(const PdfObject& rObjStm, const PdfRefCountedBuffer & rBuffer, PdfEncrypt* pEncrypt );
+
+    /** Read an object from the stream
+     *
+     *  \param nObjNo the number of the object to read
+     *  \param nIndex the index of the object in the stream, as
+     *         specified in the xref stream. If it doesn't match
+     *         the object number, the object is searched in the stream
+     *  \param rVariant store the read object into this variable
+     *
+     *  \returns false if the object is not in the stream
+     */
+    bool TryReadObject(uint32_t nObjNo, unsigned nIndex, PdfVariant& rVariant);
 
-    void Parse(ObjectIdList const &);
+    /** Create an object that is read from the
+     *  stream only when its value is first accessed
+     *
+     *  \param pParser the parser of the object stream
+     *  \param nObjNo the number of the object
+     *  \param nIndex the index of the object in the stream
+     *  \param pArena the arena to allocate the object from, or nullptr
+     *
+     *  \returns an object with delayed loading enabled
+     */
+    static PdfObject* CreateDelayedObject(const std::shared_ptr<PdfObjectStreamParser>& pParser,
+        uint32_t nObjNo, unsigned nIndex, PdfMemoryArena* pArena = nullptr);
 
 private:
-    void ReadObjectsFromStream( char* pBuffer, size_t lBufferLen, int64_t lNum, int64_t lFirst, ObjectIdList const &);
+    void load();
 
 private:
-    PdfParserObject* m_pParser;
-    PdfVecObjects* m_vecObjects;
+    std::unique_ptr<PdfObject> m_pObjStm; ///< Copy of the object stream, released once decoded
+    PdfReference m_reference;
     PdfRefCountedBuffer m_buffer;
     PdfEncrypt* m_pEncrypt;
+    bool m_bLoaded;
+    PdfRefCountedBuffer m_stream;   ///< The decoded object stream
+    PdfRefCountedInputDevice m_device;
+    int64_t m_lFirst;
+    std::vector<std::pair<int64_t, int64_t>> m_offsets; ///< Object numbers and offsets in the stream
 };
 
 };
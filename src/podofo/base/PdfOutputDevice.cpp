@@ -40,9 +40,18 @@
 #include <fstream>
 #include <sstream>
 
+#ifndef WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 using namespace PoDoFo;
 
+// Size of the write combining buffer used for files
+static constexpr size_t WriteBufferSize = 256 * 1024;
+
 PdfOutputDevice::PdfOutputDevice()
 {
     this->Init();
@@ -52,6 +61,7 @@ PdfOutputDevice::PdfOutputDevice(const std::string_view& filename, bool bTruncat
 {
     this->Init();
 
+#ifdef WIN32
     std::ios_base::openmode openmode = std::fstream::binary | std::ios_base::in | std::ios_base::out;
     if (bTruncate)
         openmode |= std::ios_base::trunc;
@@ -72,6 +82,30 @@ PdfOutputDevice::PdfOutputDevice(const std::string_view& filename, bool bTruncat
         m_ulPosition = (size_t)m_pStream->tellp();
         m_ulLength = m_ulPosition;
     }
+#else
+    int flags = O_RDWR | O_CREAT | O_CLOEXEC;
+    if (bTruncate)
+        flags |= O_TRUNC;
+
+    m_fd = ::open(std::string(filename).c_str(), flags, 0666);
+    if( m_fd == -1 )
+        PODOFO_RAISE_ERROR_INFO( EPdfError::FileNotFound, (std::string)filename);
+
+    if( !bTruncate )
+    {
+        off_t offset = ::lseek( m_fd, 0, SEEK_END );
+        if( offset == -1 )
+        {
+            ::close( m_fd );
+            PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidDeviceOperation, (std::string)filename);
+        }
+
+        m_ulPosition = (size_t)offset;
+        m_ulLength = m_ulPosition;
+    }
+#endif
+
+    m_writeBuffer.resize( WriteBufferSize );
 }
 
 PdfOutputDevice::PdfOutputDevice( char* pBuffer, size_t lLen )
@@ -112,6 +146,20 @@ PdfOutputDevice::PdfOutputDevice( std::iostream* pStream )
 
 PdfOutputDevice::~PdfOutputDevice()
 {
+    try
+    {
+        flushWriteBuffer();
+    }
+    catch (...)
+    {
+        // Write errors can be only reported by Flush()
+    }
+
+#ifndef WIN32
+    if( m_fd != -1 )
+        ::close( m_fd );
+#endif
+
     if( m_pStreamOwned ) 
         delete m_pStream;
 }
@@ -126,6 +174,17 @@ void PdfOutputDevice::Init()
     m_lBufferLen        = 0;
     m_ulPosition        = 0;
     m_pStreamOwned      = true;
+    m_fd                = -1;
+    m_lWriteBufferUsed  = 0;
+    m_nRealPrecision    = PdfRealPrecisionDefault;
+}
+
+void PdfOutputDevice::SetRealPrecision( unsigned short nPrecision )
+{
+    if( nPrecision > utls::MaxRealPrecision )
+        PODOFO_RAISE_ERROR_INFO( EPdfError::ValueOutOfRange, "The real precision is too high" );
+
+    m_nRealPrecision = nPrecision;
 }
 
 void PdfOutputDevice::Print( const char* pszFormat, ... )
@@ -146,6 +205,13 @@ void PdfOutputDevice::Print( const char* pszFormat, ... )
 
 void PdfOutputDevice::Print(const char* pszFormat, va_list args)
 {
+    // Plain strings don't need to be formatted
+    if (pszFormat != nullptr && strchr(pszFormat, '%') == nullptr)
+    {
+        Write(pszFormat, strlen(pszFormat));
+        return;
+    }
+
     // NOTE: The first vsnprintf call will modify the va_list in GCC
     // so we must copy it first. Yes, it sucks. Yes, it's a shame
     va_list argscopy;
@@ -188,24 +254,12 @@ void PdfOutputDevice::PrintV( const char* pszFormat, size_t lBytes, va_list args
             PODOFO_RAISE_ERROR( EPdfError::OutOfMemory );
         }
     }
-    else if( m_pStream || m_pRefCountedBuffer )
+    else if( m_pStream || m_pRefCountedBuffer || m_fd != -1 )
     {
         m_printBuffer.resize( lBytes );
         compat::vsnprintf(m_printBuffer.data(), lBytes + 1, pszFormat, args );
-
-        if( m_pStream ) 
-        {
-            m_pStream->write(m_printBuffer.data(), lBytes);
-            if (m_pStream->fail())
-                PODOFO_RAISE_ERROR(EPdfError::InvalidDeviceOperation);
-        }
-        else // if( m_pRefCountedBuffer ) 
-        {
-            if( m_ulPosition + lBytes > m_pRefCountedBuffer->GetSize())
-                m_pRefCountedBuffer->Resize( m_ulPosition + lBytes );
-
-            memcpy( m_pRefCountedBuffer->GetBuffer() + m_ulPosition, m_printBuffer.data(), lBytes );
-        }
+        this->Write( m_printBuffer.data(), lBytes );
+        return;
     }
 
     m_ulPosition += lBytes;
@@ -224,8 +278,27 @@ size_t PdfOutputDevice::Read( char* pBuffer, size_t lLen )
             memcpy( pBuffer, m_pBuffer + m_ulPosition, numRead);
         }
     }
+#ifndef WIN32
+    else if( m_fd != -1 )
+    {
+        flushWriteBuffer();
+
+        ssize_t rc;
+        do
+        {
+            rc = ::pread( m_fd, pBuffer, lLen, (off_t)m_ulPosition );
+        } while( rc == -1 && errno == EINTR );
+
+        if( rc == -1 )
+            PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidDeviceOperation, "Failed to read from the file" );
+
+        numRead = (size_t)rc;
+    }
+#endif
     else if( m_pReadStream )
     {
+        flushWriteBuffer();
+
 		size_t iPos = (size_t)m_pReadStream->tellg();
 		m_pReadStream->read( pBuffer, lLen );
 		if(m_pReadStream->fail() && !m_pReadStream->eof())
@@ -260,6 +333,22 @@ void PdfOutputDevice::Write( const char* pBuffer, size_t lLen )
             PODOFO_RAISE_ERROR_INFO( EPdfError::OutOfMemory, "Allocated buffer to small for PdfOutputDevice. Cannot write!"  );
         }
     }
+    else if( m_writeBuffer.size() != 0 )
+    {
+        // Collect small writes and write them to the file all together
+        if( m_lWriteBufferUsed + lLen > m_writeBuffer.size() )
+            flushWriteBuffer();
+
+        if( lLen >= m_writeBuffer.size() )
+        {
+            writeToFile( pBuffer, lLen, m_ulPosition );
+        }
+        else
+        {
+            memcpy( m_writeBuffer.data() + m_lWriteBufferUsed, pBuffer, lLen );
+            m_lWriteBufferUsed += lLen;
+        }
+    }
     else if( m_pStream )
     {
         m_pStream->write( pBuffer, lLen );
@@ -278,6 +367,8 @@ void PdfOutputDevice::Write( const char* pBuffer, size_t lLen )
 
 void PdfOutputDevice::Seek( size_t offset )
 {
+    flushWriteBuffer();
+
     if( m_pBuffer )
     {
         if( offset >= m_lBufferLen )
@@ -301,6 +392,45 @@ void PdfOutputDevice::Seek( size_t offset )
 
 void PdfOutputDevice::Flush()
 {
+    flushWriteBuffer();
+
     if( m_pStream )
         m_pStream->flush();
 }
+
+void PdfOutputDevice::flushWriteBuffer()
+{
+    if( m_lWriteBufferUsed == 0 )
+        return;
+
+    // The buffered data ends at the current position
+    size_t lUsed = m_lWriteBufferUsed;
+    m_lWriteBufferUsed = 0;
+    writeToFile( m_writeBuffer.data(), lUsed, m_ulPosition - lUsed );
+}
+
+void PdfOutputDevice::writeToFile( const char* pBuffer, size_t lLen, size_t offset )
+{
+#ifdef WIN32
+    (void)offset;
+    m_pStream->write( pBuffer, lLen );
+    if( m_pStream->fail() )
+        PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidDeviceOperation, "Failed to write to the file" );
+#else
+    while( lLen != 0 )
+    {
+        ssize_t written = ::pwrite( m_fd, pBuffer, lLen, (off_t)offset );
+        if( written == -1 )
+        {
+            if( errno == EINTR )
+                continue;
+
+            PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidDeviceOperation, "Failed to write to the file" );
+        }
+
+        pBuffer += written;
+        lLen -= (size_t)written;
+        offset += (size_t)written;
+    }
+#endif
+}
@@ -39,6 +39,7 @@
 #include <string_view>
 #include <ostream>
 #include <iostream>
+#include <vector>
 
 #include "PdfDefines.h"
 #include "PdfLocale.h"
@@ -66,6 +67,12 @@ public:
     PdfOutputDevice();
 
     /** Construct a new PdfOutputDevice that writes all data to a file.
+     *
+     *  Writes are collected in an internal buffer, so that the file
+     *  receives few large writes. The buffer is written to the file
+     *  by Flush(), Seek(), Read() and when the device is destroyed.
+     *  On POSIX systems the file is accessed directly through its
+     *  file descriptor.
      *
      *  \param pszFilename path to a file that will be opened and all data
      *                     is written to this file.
@@ -162,6 +169,14 @@ public:
      */
     void Write( const char* pBuffer, size_t lLen );
 
+    /** Write a string view to the PdfOutputDevice
+     *
+     *  \param view the data to write
+     *
+     *  \see Write
+     */
+    inline void Write( const std::string_view& view ) { Write( view.data(), view.size() ); }
+
     /** Read data from the device
      *  \param pBuffer a pointer to the data buffer
      *  \param lLen length of the output buffer
@@ -179,8 +194,25 @@ public:
      */
     inline size_t Tell() const { return m_ulPosition; }
 
+    /** Set the number of decimal digits used when writing real
+     *  numbers to this device. Lower values produce smaller files,
+     *  at the cost of accuracy. The maximum is 20
+     *
+     *  \param nPrecision the number of decimal digits
+     */
+    void SetRealPrecision( unsigned short nPrecision );
+
+    /**
+     *  \returns the number of decimal digits used when writing real numbers
+     *  \see SetRealPrecision
+     */
+    inline unsigned short GetRealPrecision() const { return m_nRealPrecision; }
+
     /** Flush the output files buffer to disk if this devices
      *  operates on a disk.
+     *
+     *  Call it after writing to a file to be notified of write
+     *  errors, as the destructor can't report them
      */
     void Flush();
 
@@ -189,6 +221,15 @@ private:
      */
     void Init();
 
+    /** Write the data collected in the write buffer to the file
+     */
+    void flushWriteBuffer();
+
+    /** Write data directly to the file
+     *  \param offset the position of the data in the file
+     */
+    void writeToFile( const char* pBuffer, size_t lLen, size_t offset );
+
 private:
     size_t               m_ulLength;
     char*                m_pBuffer;
@@ -201,6 +242,11 @@ private:
     PdfRefCountedBuffer* m_pRefCountedBuffer;
     size_t               m_ulPosition;
     std::string  m_printBuffer;
+
+    int                  m_fd;                  ///< POSIX file descriptor of the file, or -1
+    std::vector<char>    m_writeBuffer;         ///< Write combining buffer, only used for files
+    size_t               m_lWriteBufferUsed;
+    unsigned short       m_nRealPrecision;
 };
 
 };
@@ -41,6 +41,8 @@
 #include "PdfEncrypt.h"
 #include "PdfInputDevice.h"
 #include "PdfMemStream.h"
+#include "PdfMemoryArena.h"
+#include "PdfMemoryMappedInputDevice.h"
 #include "PdfObjectStreamParser.h"
 #include "PdfOutputDevice.h"
 #include "PdfStream.h"
@@ -53,6 +55,8 @@
 #include <algorithm>
 #include <iostream>
 #include <limits>
+#include <atomic>
+#include <thread>
 
 #define PDF_BUFFER_SIZE 4096
 #define PDF_VERSION_LENGHT  3
@@ -63,6 +67,22 @@
 using namespace std;
 using namespace PoDoFo;
 
+namespace
+{
+    // Input device reading the span of another device with its own
+    // position. The other device is kept alive, as the span is borrowed
+    class PdfSpanSharingInputDevice : public PdfInputDevice
+    {
+    public:
+        PdfSpanSharingInputDevice(const PdfRefCountedInputDevice& device)
+            : PdfInputDevice(device.Device()->GetSpan().data(), device.Device()->GetSpan().length(), false),
+              m_device(device) { }
+
+    private:
+        PdfRefCountedInputDevice m_device;
+    };
+}
+
 static bool CheckEOL(char e1, char e2);
 static bool CheckXRefEntryType( char c );
 static bool ReadMagicWord(char ch, int& charidx);
@@ -111,7 +131,8 @@ PdfParser::PdfParser(PdfVecObjects& pVecObjects) :
     m_buffer(PDF_BUFFER_SIZE),
     m_tokenizer(m_buffer),
     m_vecObjects(&pVecObjects),
-    m_bStrictParsing(false)
+    m_bStrictParsing(false),
+    m_nLoadThreadCount(1)
 {
     this->Reset();
 }
@@ -137,7 +158,7 @@ void PdfParser::Reset()
     m_pTrailer = nullptr;
     m_pLinearization = nullptr;
     m_entries.clear();
-    m_setObjectStreams.clear();
+    m_objectStreams.clear();
 
     m_pEncrypt = nullptr;
 
@@ -151,7 +172,23 @@ void PdfParser::ParseFile(const string_view &filename, bool bLoadOnDemand )
     if(filename.length() == 0)
         PODOFO_RAISE_ERROR( EPdfError::InvalidHandle );
 
-    PdfRefCountedInputDevice device(filename);
+    PdfRefCountedInputDevice device;
+    try
+    {
+        // Map the file in memory, so the content can be
+        // accessed directly without going through std::istream
+        device = PdfRefCountedInputDevice(new PdfMemoryMappedInputDevice(filename));
+    }
+    catch (PdfError& e)
+    {
+        if (e.GetError() != EPdfError::InvalidDeviceOperation)
+            throw e;
+
+        // The file can't be mapped, e.g. it's a pipe:
+        // fallback reading it sequentially
+        device = PdfRefCountedInputDevice(filename);
+    }
+
     if( !device.Device() )
     {
         PODOFO_RAISE_ERROR_INFO( EPdfError::FileNotFound, filename.data());
@@ -978,7 +1015,7 @@ void PdfParser::ReadObjects(const PdfRefCountedInputDevice& device)
                 PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidEncryptionDict, oss.str().c_str() );
             }
 
-            pObject = new PdfParserObject(m_vecObjects->GetDocument(), device, m_buffer, (ssize_t)m_entries[i].Offset);
+            pObject = PdfMemoryArena::Create<PdfParserObject>(m_vecObjects->getMemoryArena(), m_vecObjects->GetDocument(), device, m_buffer, (ssize_t)m_entries[i].Offset);
             if( !pObject )
                 PODOFO_RAISE_ERROR( EPdfError::OutOfMemory );
 
@@ -1035,6 +1072,12 @@ void PdfParser::ReadObjectsInternal(const PdfRefCountedInputDevice& device)
     int              nLast        = 0;
     PdfParserObject* pObject      = nullptr;
 
+    // Objects already parsed in parallel, indexed as m_entries
+    vector<PdfParsedEntry> parsedEntries;
+    unsigned nThreads = m_nLoadThreadCount == 0 ? thread::hardware_concurrency() : m_nLoadThreadCount;
+    if (nThreads > 1 && !m_bLoadOnDemand && m_pEncrypt == nullptr && device.Device()->HasSpan())
+        parseObjectsParallel(device, nThreads, parsedEntries);
+
     // Read objects
     for( i=0; i < m_nNumObjects; i++ )
     {
@@ -1054,26 +1097,29 @@ void PdfParser::ReadObjectsInternal(const PdfRefCountedInputDevice& device)
             {
                 if ( entry.Offset > 0 )
                 {
-                    pObject = new PdfParserObject(m_vecObjects->GetDocument(), device, m_buffer, (ssize_t)entry.Offset);
-                    auto reference = pObject->GetIndirectReference();
-                    if ( reference.GenerationNumber() != entry.Generation )
+                    exception_ptr parseError;
+                    if (parsedEntries.size() == 0)
                     {
-                        if ( m_bStrictParsing )
-                        {
-                            PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidXRef,
-                                "Found object with generation different than reported in XRef sections" );
-                        }
-                        else
-                        {
-                            PdfError::LogMessage( ELogSeverity::Warning,
-                                "Found object with generation different than reported in XRef sections" );
-                        }
+                        pObject = PdfMemoryArena::Create<PdfParserObject>(m_vecObjects->getMemoryArena(), m_vecObjects->GetDocument(), device, m_buffer, (ssize_t)entry.Offset);
+                        pObject->SetLoadOnDemand( m_bLoadOnDemand );
+                    }
+                    else
+                    {
+                        // The object is missing if its creation failed
+                        if (parsedEntries[i].Object == nullptr)
+                            rethrow_exception(parsedEntries[i].Error);
+
+                        pObject = parsedEntries[i].Object.release();
+                        parseError = parsedEntries[i].Error;
                     }
 
-                    pObject->SetLoadOnDemand( m_bLoadOnDemand );
                     try
                     {
-                        pObject->ParseFile( m_pEncrypt.get() );
+                        if (parsedEntries.size() == 0)
+                            pObject->ParseFile( m_pEncrypt.get() );
+                        else if (parseError != nullptr)
+                            rethrow_exception(parseError);
+
                         if (m_pEncrypt && pObject->IsDictionary())
                         {
                             PdfObject* pObjType = pObject->GetDictionary().GetKey( PdfName::KeyType );
@@ -1081,31 +1127,18 @@ void PdfParser::ReadObjectsInternal(const PdfRefCountedInputDevice& device)
                             {
                                 // XRef is never encrypted
                                 delete pObject;
-                                pObject = new PdfParserObject(m_vecObjects->GetDocument(), device, m_buffer, (ssize_t)entry.Offset);
-                                reference = pObject->GetIndirectReference();
+                                pObject = PdfMemoryArena::Create<PdfParserObject>(m_vecObjects->getMemoryArena(), m_vecObjects->GetDocument(), device, m_buffer, (ssize_t)entry.Offset);
                                 pObject->SetLoadOnDemand( m_bLoadOnDemand );
                                 pObject->ParseFile( nullptr );
                             }
                         }
-                        nLast = reference.ObjectNumber();
-
-                        // final pdf should not contain a linerization dictionary as it contents are invalid 
-                        // as we change some objects and the final xref table
-                        if( m_pLinearization && nLast == static_cast<int>(m_pLinearization->GetIndirectReference().ObjectNumber()) )
-                        {
-                            m_vecObjects->SafeAddFreeObject( reference );
-                            delete pObject;
-                        }
-                        else
-                        {
-                            m_vecObjects->AddObject(pObject);
-                        }
                     }
                     catch( PdfError & e )
                     {
+                        auto reference = pObject->GetIndirectReference();
                         std::ostringstream oss;
-                        oss << "Error while loading object " << pObject->GetIndirectReference().ObjectNumber() 
-                            << " " << pObject->GetIndirectReference().GenerationNumber() 
+                        oss << "Error while loading object " << reference.ObjectNumber()
+                            << " " << reference.GenerationNumber()
                             << " Offset = " << entry.Offset
                             << " Index = " << i << std::endl;
                         delete pObject;
@@ -1114,6 +1147,7 @@ void PdfParser::ReadObjectsInternal(const PdfRefCountedInputDevice& device)
                         {
                             PdfError::LogMessage( ELogSeverity::Error, oss.str().c_str() );
                             m_vecObjects->SafeAddFreeObject( reference );
+                            break;
                         }
                         else
                         {
@@ -1121,6 +1155,56 @@ void PdfParser::ReadObjectsInternal(const PdfRefCountedInputDevice& device)
                             throw e;
                         }
                     }
+                    catch( ... )
+                    {
+                        delete pObject;
+                        throw;
+                    }
+
+                    // The reference is available only after parsing the object
+                    auto reference = pObject->GetIndirectReference();
+                    if ( reference.GenerationNumber() != entry.Generation )
+                    {
+                        if ( m_bStrictParsing )
+                        {
+                            delete pObject;
+                            PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidXRef,
+                                "Found object with generation different than reported in XRef sections" );
+                        }
+                        else
+                        {
+                            PdfError::LogMessage( ELogSeverity::Warning,
+                                "Found object with generation different than reported in XRef sections" );
+                        }
+                    }
+
+                    nLast = reference.ObjectNumber();
+
+                    // final pdf should not contain a linerization dictionary as it contents are invalid 
+                    // as we change some objects and the final xref table
+                    if( m_pLinearization && nLast == static_cast<int>(m_pLinearization->GetIndirectReference().ObjectNumber()) )
+                    {
+                        m_vecObjects->SafeAddFreeObject( reference );
+                        delete pObject;
+                    }
+                    else if ( m_vecObjects->getObjectByNumber( reference.ObjectNumber() ) != nullptr )
+                    {
+                        // Another XRef entry already loaded an object with this number
+                        delete pObject;
+                        if ( m_bStrictParsing )
+                        {
+                            PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidXRef,
+                                "Found object with a number already in use" );
+                        }
+
+                        PdfError::LogMessage( ELogSeverity::Warning,
+                            "Found object %u %u R with a number already in use, skipping it",
+                            reference.ObjectNumber(), reference.GenerationNumber() );
+                    }
+                    else
+                    {
+                        m_vecObjects->AddObject(pObject);
+                    }
                 }
                 else if ( entry.Generation == 0 )
                 {
@@ -1175,21 +1259,18 @@ void PdfParser::ReadObjectsInternal(const PdfRefCountedInputDevice& device)
     // all normal objects including object streams are available now,
     // we can parse the object streams safely now.
     //
-    // Note that even if demand loading is enabled we still currently read all
-    // objects from the stream into memory then free the stream.
-    //
+    // If demand loading is enabled, each object stream is decoded
+    // only when one of its objects is accessed for the first time
     for( i = 0; i < m_nNumObjects; i++ )
     {
         PdfXRefEntry &entry = m_entries[i];
         if( entry.Parsed && entry.Type == EXRefEntryType::Compressed ) // we have an compressed object stream
-        {
-#ifndef VERBOSE_DEBUG_DISABLED
-            if (m_bLoadOnDemand) cerr << "Demand loading on, but can't demand-load from object stream." << endl;
-#endif
-            ReadCompressedObjectFromStream((uint32_t)entry.ObjectNumber, static_cast<int>(entry.Index));
-        }
+            ReadCompressedObjectFromStream(static_cast<uint32_t>(i), static_cast<uint32_t>(entry.ObjectNumber), static_cast<unsigned>(entry.Index));
     }
 
+    // The stream parsers are now owned by the objects
+    m_objectStreams.clear();
+
     if( !m_bLoadOnDemand )
     {
         // Force loading of streams. We can't do this during the initial
@@ -1200,8 +1281,10 @@ void PdfParser::ReadObjectsInternal(const PdfRefCountedInputDevice& device)
              itObjects != m_vecObjects->end();
              ++itObjects)
         {
+            // Objects read from object streams are not parser objects
             pObject = dynamic_cast<PdfParserObject*>(*itObjects);
-            pObject->ForceStreamParse();
+            if (pObject != nullptr)
+                pObject->ForceStreamParse();
         }
     }
 
@@ -1212,40 +1295,102 @@ void PdfParser::ReadObjectsInternal(const PdfRefCountedInputDevice& device)
     UpdateDocumentVersion();
 }
 
-void PdfParser::ReadCompressedObjectFromStream( uint32_t nObjNo, int nIndex)
+void PdfParser::parseObjectsParallel(const PdfRefCountedInputDevice& device, unsigned nThreads, vector<PdfParsedEntry>& parsedEntries)
 {
-    // NOTE: index of the compressed object is ignored since
-    // we eagerly read all the objects from the stream
-    (void)nIndex;
+    // Entries are distributed to the workers in blocks
+    constexpr int BlockSize = 64;
 
-    // If we already have read all objects from this stream just return
-    if( m_setObjectStreams.find( nObjNo ) != m_setObjectStreams.end() )
-        return;
-
-    m_setObjectStreams.insert( nObjNo );
+    parsedEntries.resize(m_nNumObjects);
+    nThreads = std::min(nThreads, static_cast<unsigned>((m_nNumObjects + BlockSize - 1) / BlockSize));
+    atomic<int> nextBlock(0);
+    auto& document = m_vecObjects->GetDocument();
+    // Retrieve the arena here, since it's lazily created
+    auto pArena = m_vecObjects->getMemoryArena();
 
-    // generation number of object streams is always 0
-    PdfParserObject* pStream = dynamic_cast<PdfParserObject*>(m_vecObjects->GetObject( PdfReference( nObjNo, 0 ) ) );
-    if( pStream == nullptr )
+    // Each worker has its own read position on the shared span and its own
+    // buffer, since ref counted handles are not safe to share between threads
+    vector<PdfRefCountedInputDevice> devices;
+    vector<PdfRefCountedBuffer> buffers;
+    for (unsigned i = 0; i < nThreads; i++)
     {
-        std::ostringstream oss;
-        oss << "Loading of object " << nObjNo << " 0 R failed!" << std::endl;
-        PODOFO_RAISE_ERROR_INFO( EPdfError::NoObject, oss.str().c_str() );
+        devices.push_back(PdfRefCountedInputDevice(new PdfSpanSharingInputDevice(device)));
+        buffers.push_back(PdfRefCountedBuffer(PDF_BUFFER_SIZE));
     }
 
-	PdfObjectStreamParser::ObjectIdList list;
-    for( int i = 0; i < m_nNumObjects; i++ ) 
+    auto parse = [&](unsigned nWorker)
     {
-        PdfXRefEntry &entry = m_entries[i];
-        if( entry.Parsed && entry.Type == EXRefEntryType::Compressed &&
-			m_entries[i].ObjectNumber == nObjNo)
+        for (;;)
         {
-            list.push_back(static_cast<int64_t>(i));
-		}
-	}
-    
-    PdfObjectStreamParser pParserObject( pStream, m_vecObjects, m_buffer, m_pEncrypt.get() );
-    pParserObject.Parse( list );
+            int nStart = nextBlock.fetch_add(1) * BlockSize;
+            if (nStart >= m_nNumObjects)
+                return;
+
+            int nEnd = std::min(nStart + BlockSize, m_nNumObjects);
+            for (int i = nStart; i < nEnd; i++)
+            {
+                PdfXRefEntry& entry = m_entries[i];
+                if (!entry.Parsed || entry.Type != EXRefEntryType::InUse || entry.Offset == 0)
+                    continue;
+
+                // Any error is rethrown by the calling thread, as
+                // exceptions can't leave the worker threads
+                PdfParsedEntry& parsed = parsedEntries[i];
+                try
+                {
+                    parsed.Object.reset(PdfMemoryArena::Create<PdfParserObject>(pArena, document, devices[nWorker], buffers[nWorker], (ssize_t)entry.Offset));
+                    parsed.Object->SetLoadOnDemand(false);
+                    parsed.Object->ParseFile(nullptr);
+                }
+                catch (...)
+                {
+                    parsed.Error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (unsigned i = 1; i < nThreads; i++)
+        workers.push_back(thread(parse, i));
+
+    // The calling thread is a worker too
+    parse(0);
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void PdfParser::ReadCompressedObjectFromStream(uint32_t nObjNo, uint32_t nStreamObjNo, unsigned nIndex)
+{
+    // The same parser is shared by all the objects
+    // of a stream, so the stream is decoded only once
+    auto& pStreamParser = m_objectStreams[nStreamObjNo];
+    if (pStreamParser == nullptr)
+    {
+        // generation number of object streams is always 0
+        PdfObject* pStream = m_vecObjects->GetObject( PdfReference( nStreamObjNo, 0 ) );
+        if( pStream == nullptr )
+        {
+            std::ostringstream oss;
+            oss << "Loading of object " << nStreamObjNo << " 0 R failed!" << std::endl;
+            PODOFO_RAISE_ERROR_INFO( EPdfError::NoObject, oss.str().c_str() );
+        }
+
+        pStreamParser = std::make_shared<PdfObjectStreamParser>( *pStream, m_buffer, m_pEncrypt.get() );
+    }
+
+    // The generation number of an object stream and of any
+    // compressed object is implicitly zero
+    PdfReference reference( nObjNo, 0 );
+    if (m_bLoadOnDemand)
+    {
+        m_vecObjects->PushObject( reference, PdfObjectStreamParser::CreateDelayedObject( pStreamParser, nObjNo, nIndex, m_vecObjects->getMemoryArena() ) );
+    }
+    else
+    {
+        PdfVariant var;
+        if ( pStreamParser->TryReadObject( nObjNo, nIndex, var ) )
+            m_vecObjects->PushObject( reference, PdfMemoryArena::Create<PdfObject>( m_vecObjects->getMemoryArena(), var ) );
+    }
 }
 
 const char* PdfParser::GetPdfVersionString() const
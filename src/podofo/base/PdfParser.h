@@ -36,8 +36,11 @@
 #ifndef _PDF_PARSER_H_
 #define _PDF_PARSER_H_
 
+#include <exception>
 #include <set>
 #include <map>
+#include <memory>
+#include <unordered_map>
 #include "PdfDefines.h"
 #include "PdfParserObject.h"
 #include "PdfXRefEntry.h"
@@ -53,6 +56,7 @@ typedef TMapObjects::const_iterator TCIMapObjects;
 class PdfEncrypt;
 class PdfString;
 class PdfParserObject;
+class PdfObjectStreamParser;
 
 /**
  * PdfParser reads a PDF file into memory. 
@@ -79,6 +83,7 @@ public:
     ~PdfParser();
 
     /** Open a PDF file and parse it.
+     *  The file is mapped in memory when possible.
      *
      *  \param pszFilename filename of the file which is going to be parsed
      *  \param bLoadOnDemand If true all objects will be read from the file at
@@ -252,6 +257,25 @@ public:
      */
     inline void SetIgnoreBrokenObjects( bool bBroken ) { m_bIgnoreBrokenObjects = bBroken; }
 
+    /**
+     * \returns the number of threads used to parse the objects
+     *
+     * \see SetLoadThreadCount
+     */
+    inline unsigned GetLoadThreadCount() const { return m_nLoadThreadCount; }
+
+    /**
+     * Set the number of threads used to parse the objects when
+     * loading on demand is disabled. Objects are parsed in parallel
+     * only if the input device has a contiguous span, as it happens
+     * with ParseFile() and ParseBuffer(), and the file is not encrypted.
+     *
+     * Default is 1, which parses all objects on the calling thread.
+     *
+     * \param nThreads number of threads, 0 to use one per hardware thread
+     */
+    inline void SetLoadThreadCount( unsigned nThreads ) { m_nLoadThreadCount = nThreads; }
+
     inline size_t GetXRefOffset() const { return m_nXRefOffset; }
 
     inline bool HasXRefStream() const { return m_HasXRefStream; }
@@ -359,18 +383,34 @@ private:
      */
     void ReadObjectsInternal(const PdfRefCountedInputDevice& device);
 
-    /** Read the object with index nIndex from the object stream nObjNo
-     *  and push it on the objects vector m_vecOffsets.
+    /** Read the object nObjNo with index nIndex from the object
+     *  stream nStreamObjNo and push it on the objects vector.
      *
-     *  All objects are read from this stream and the stream object
-     *  is free'd from memory. Further calls who try to read from the
-     *  same stream simply do nothing.
+     *  If demand loading is enabled, the object is read and the
+     *  stream decoded only when the object is first accessed.
      *
-     *  \param nObjNo object number of the stream object
-     *  \param nIndex index of the object which should be parsed
+     *  \param nObjNo object number of the compressed object
+     *  \param nStreamObjNo object number of the stream object
+     *  \param nIndex index of the object in the stream
+     */
+    void ReadCompressedObjectFromStream(uint32_t nObjNo, uint32_t nStreamObjNo, unsigned nIndex);
+
+    /** An object parsed by parseObjectsParallel(),
+     *  or the error raised while parsing it
+     */
+    struct PdfParsedEntry
+    {
+        std::unique_ptr<PdfParserObject> Object;
+        std::exception_ptr Error;
+    };
+
+    /** Parse all the in use objects of the xref table with
+     *  a pool of threads reading the span of the device
      *
+     *  \param nThreads the number of threads to use
+     *  \param parsedEntries the parsed objects, indexed as m_entries
      */
-    void ReadCompressedObjectFromStream(uint32_t nObjNo, int nIndex);
+    void parseObjectsParallel(const PdfRefCountedInputDevice& device, unsigned nThreads, std::vector<PdfParsedEntry>& parsedEntries);
 
     /** Checks the magic number at the start of the pdf file
      *  and sets the m_ePdfVersion member to the correct version
@@ -446,7 +486,7 @@ private:
 
     std::string m_password;
 
-    std::set<int> m_setObjectStreams;
+    std::unordered_map<uint32_t, std::shared_ptr<PdfObjectStreamParser>> m_objectStreams;
 
     bool          m_bStrictParsing;
     bool          m_bIgnoreBrokenObjects;
@@ -455,6 +495,8 @@ private:
     int           m_nRecursionDepth;
     
     std::set<size_t> m_visitedXRefOffsets;
+
+    unsigned      m_nLoadThreadCount;
 };
 
 };
@@ -205,7 +205,7 @@ void PdfParserObject::ParseFileComplete( bool bIsTrailer )
             }
             else
             {
-                PODOFO_RAISE_ERROR_INFO( EPdfError::NoObject, pszToken.data() );
+                PODOFO_RAISE_ERROR_INFO( EPdfError::NoObject, (string)pszToken );
             }
         }
     }
@@ -47,12 +47,14 @@ void PdfReference::Write(PdfOutputDevice& pDevice, EPdfWriteMode eWriteMode, con
     if( (eWriteMode & EPdfWriteMode::Compact) == EPdfWriteMode::Compact ) 
     {
         // Write space before the reference
-        pDevice.Print( " %i %hi R", m_nObjectNo, m_nGenerationNo );
-    }
-    else
-    {
-        pDevice.Print( "%i %hi R", m_nObjectNo, m_nGenerationNo );
+        pDevice.Write( " ", 1 );
     }
+
+    char buffer[utls::FormatBufferSize];
+    pDevice.Write( utls::FormatTo( buffer, static_cast<int64_t>(m_nObjectNo) ) );
+    pDevice.Write( " ", 1 );
+    pDevice.Write( utls::FormatTo( buffer, static_cast<int64_t>(m_nGenerationNo) ) );
+    pDevice.Write( " R", 2 );
 }
 
 const std::string PdfReference::ToString() const
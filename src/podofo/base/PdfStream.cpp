@@ -38,6 +38,7 @@
 #include <doc/PdfDocument.h>
 #include "PdfArray.h"
 #include "PdfFilter.h"
+#include "PdfFiltersPrivate.h"
 #include "PdfInputStream.h"
 #include "PdfOutputStream.h"
 #include "PdfOutputDevice.h"
@@ -112,6 +113,55 @@ void PdfStream::CopyFrom(const PdfStream &rhs)
 {
     PdfMemoryInputStream stream( rhs.GetInternalBuffer(), rhs.GetInternalBufferSize() );
     this->SetRawData( stream );
+    m_flateSettings = rhs.m_flateSettings;
+}
+
+void PdfStream::setPredictorDecodeParms( const PdfFlateSettings & rSettings )
+{
+    PdfDictionary& rDict = m_pParent->GetDictionary();
+    if( rSettings.Predictor == EPdfPredictor::None )
+    {
+        // Don't leave the parameters of a predictor no longer used
+        const PdfObject* pDecodeParms = rDict.GetKey( "DecodeParms" );
+        if( pDecodeParms != nullptr && pDecodeParms->IsDictionary() && pDecodeParms->GetDictionary().HasKey( "Predictor" ) )
+            rDict.RemoveKey( "DecodeParms" );
+
+        return;
+    }
+
+    PdfDictionary decodeParms;
+    decodeParms.AddKey( "Predictor", static_cast<int64_t>(rSettings.Predictor) );
+    if( rSettings.Colors != 1 )
+        decodeParms.AddKey( "Colors", static_cast<int64_t>(rSettings.Colors) );
+    if( rSettings.BitsPerComponent != 8 )
+        decodeParms.AddKey( "BitsPerComponent", static_cast<int64_t>(rSettings.BitsPerComponent) );
+    if( rSettings.Columns != 1 )
+        decodeParms.AddKey( "Columns", static_cast<int64_t>(rSettings.Columns) );
+
+    rDict.AddKey( "DecodeParms", decodeParms );
+}
+
+void PdfStream::SetFlateSettings( const PdfFlateSettings & rSettings )
+{
+    PdfFlateFilter::ValidateSettings( rSettings );
+    m_flateSettings = rSettings;
+}
+
+void PdfStream::ResetFlateSettings()
+{
+    m_flateSettings.reset();
+}
+
+PdfFlateSettings PdfStream::GetFlateSettings() const
+{
+    if( m_flateSettings.has_value() )
+        return *m_flateSettings;
+
+    PdfDocument* pDocument = m_pParent == nullptr ? nullptr : m_pParent->GetDocument();
+    if( pDocument == nullptr )
+        return PdfFlateSettings();
+
+    return pDocument->GetObjects().GetFlateSettings();
 }
 
 void PdfStream::Set(const string_view& view, const TVecFilters& vecFilters)
@@ -261,6 +311,9 @@ void PdfStream::BeginAppend(const TVecFilters& vecFilters, bool bClearExisting,
         {
             m_pParent->GetDictionary().AddKey( PdfName::KeyFilter, 
                                                PdfName( PdfFilterFactory::FilterTypeToName( vecFilters.front() ) ) );
+
+            if( vecFilters.front() == EPdfFilter::FlateDecode )
+                setPredictorDecodeParms( GetFlateSettings() );
         }
         else // vecFilters.size() > 1
         {
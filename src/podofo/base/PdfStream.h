@@ -38,6 +38,8 @@
 
 #include "PdfDefines.h"
 
+#include <optional>
+
 #include "PdfFilter.h"
 #include "PdfRefCountedBuffer.h"
 #include "PdfEncrypt.h"
@@ -63,7 +65,9 @@ class PdfOutputStream;
  */
 class PODOFO_API PdfStream
 {
+    friend class PdfObject;
     friend class PdfParserObject;
+    friend class PdfFilteredInputStream;
 public:
     /** The default filter to use when changing the stream content.
      *  It's a static member and applies to all newly created/changed streams.
@@ -223,6 +227,28 @@ public:
      */
     inline bool IsAppending() const { return m_bAppend; }
 
+    /** Set the Flate compression level and strategy used when
+     *  data is appended to this stream, overriding the settings
+     *  of the owner document.
+     *
+     *  \param rSettings the settings to use for this stream
+     *
+     *  \see PdfVecObjects::SetFlateSettings
+     */
+    void SetFlateSettings( const PdfFlateSettings & rSettings );
+
+    /** Use the Flate settings of the owner document again
+     *  for this stream.
+     */
+    void ResetFlateSettings();
+
+    /**
+     *  \returns the Flate settings used to encode appended data, i.e.
+     *            the stream's own settings if set, else the ones of
+     *            the owner document
+     */
+    PdfFlateSettings GetFlateSettings() const;
+
     /** Get the stream's length with all filters applied (e.g. if the stream is
      * Flate-compressed, the length of the compressed data stream).
      *
@@ -322,10 +348,18 @@ private:
 
     void BeginAppend(const TVecFilters& vecFilters, bool bClearExisting, bool bDeleteFilters, bool markObjectDirty);
 
+    /** Set or remove the /DecodeParms of a Flate encoded stream
+     *  for the predictor applied by the given settings
+     */
+    void setPredictorDecodeParms(const PdfFlateSettings& rSettings);
+
 protected:
     PdfObject*          m_pParent;
 
     bool                m_bAppend;
+
+private:
+    std::optional<PdfFlateSettings> m_flateSettings;
 };
 
 };
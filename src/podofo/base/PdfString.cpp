@@ -83,18 +83,18 @@ const char* PdfString::s_pszUnicodeMarkerHex = "FEFF";
 
 
 PdfString::PdfString()
-    : m_bHex( false ), m_bUnicode( false ), m_pEncoding( nullptr )
+    : m_lInlineSize( 0 ), m_bHex( false ), m_bUnicode( false ), m_pEncoding( nullptr )
 {
 }
 
 PdfString::PdfString( const std::string& sString, const PdfEncoding * const pEncoding )
-    : m_bHex( false ), m_bUnicode( false ), m_pEncoding( pEncoding )
+    : m_lInlineSize( 0 ), m_bHex( false ), m_bUnicode( false ), m_pEncoding( pEncoding )
 {
     Init( sString.c_str(), sString.length() );
 }
 
 PdfString::PdfString( const char* pszString, const PdfEncoding * const pEncoding )
-    : m_bHex( false ), m_bUnicode( false ), m_pEncoding( pEncoding )
+    : m_lInlineSize( 0 ), m_bHex( false ), m_bUnicode( false ), m_pEncoding( pEncoding )
 {
     if( pszString )
         Init( pszString, strlen( pszString ) );
@@ -113,6 +113,7 @@ PdfString::PdfString( const wchar_t* pszString, size_t lLen )
 
 void PdfString::setFromWchar_t(const wchar_t* pszString, size_t lLen )
 {
+    m_lInlineSize = 0;
     m_bHex = false;
     m_bUnicode = true;
     m_pEncoding = nullptr;
@@ -123,15 +124,15 @@ void PdfString::setFromWchar_t(const wchar_t* pszString, size_t lLen )
         {
             // We have UTF16
             lLen *= sizeof(wchar_t);
-            m_buffer = PdfRefCountedBuffer( lLen + 2 );
-            memcpy( m_buffer.GetBuffer(), pszString, lLen );
-            m_buffer.GetBuffer()[lLen] = '\0';
-            m_buffer.GetBuffer()[lLen+1] = '\0';
+            char* pData = allocData( lLen + 2 );
+            memcpy( pData, pszString, lLen );
+            pData[lLen] = '\0';
+            pData[lLen+1] = '\0';
             
             // if the buffer is a UTF-16LE string
             // convert it to UTF-16BE
 #ifdef PODOFO_IS_LITTLE_ENDIAN
-            SwapBytes( m_buffer.GetBuffer(), lLen );
+            SwapBytes( pData, lLen );
 #endif // PODOFO_IS_LITTLE_ENDIA
         }
         else
@@ -164,14 +165,14 @@ void PdfString::setFromWchar_t(const wchar_t* pszString, size_t lLen )
 #endif
 
 PdfString::PdfString( const char* pszString, size_t lLen, bool bHex, const PdfEncoding * const pEncoding )
-    : m_bHex( bHex ), m_bUnicode( false ), m_pEncoding( pEncoding )
+    : m_lInlineSize( 0 ), m_bHex( bHex ), m_bUnicode( false ), m_pEncoding( pEncoding )
 {
     if( pszString )
         Init( pszString, lLen );
 }
 
 PdfString::PdfString( const pdf_utf8* pszStringUtf8 )
-    : m_bHex( false ), m_bUnicode( true ), m_pEncoding( nullptr )
+    : m_lInlineSize( 0 ), m_bHex( false ), m_bUnicode( true ), m_pEncoding( nullptr )
 {
     InitFromUtf8( pszStringUtf8, strlen( reinterpret_cast<const char*>(pszStringUtf8) ) );
 
@@ -179,7 +180,7 @@ PdfString::PdfString( const pdf_utf8* pszStringUtf8 )
 }
 
 PdfString::PdfString( const pdf_utf8* pszStringUtf8, size_t lLen )
-    : m_bHex( false ), m_bUnicode( true ), m_pEncoding( nullptr )
+    : m_lInlineSize( 0 ), m_bHex( false ), m_bUnicode( true ), m_pEncoding( nullptr )
 {
     InitFromUtf8( pszStringUtf8, lLen );
 
@@ -187,7 +188,7 @@ PdfString::PdfString( const pdf_utf8* pszStringUtf8, size_t lLen )
 }
 
 PdfString::PdfString( const pdf_utf16be* pszStringUtf16 )
-    : m_bHex( false ), m_bUnicode( true ), m_pEncoding( nullptr )
+    : m_lInlineSize( 0 ), m_bHex( false ), m_bUnicode( true ), m_pEncoding( nullptr )
 {
     size_t lBufLen = 0;
     const pdf_utf16be* pszCnt  = pszStringUtf16;
@@ -200,14 +201,14 @@ PdfString::PdfString( const pdf_utf16be* pszStringUtf16 )
 
     lBufLen *= sizeof(pdf_utf16be);
 
-    m_buffer = PdfRefCountedBuffer( lBufLen + sizeof(pdf_utf16be) );
-    memcpy( m_buffer.GetBuffer(), reinterpret_cast<const char*>(pszStringUtf16), lBufLen );
-    m_buffer.GetBuffer()[lBufLen] = '\0';
-    m_buffer.GetBuffer()[lBufLen+1] = '\0';
+    char* pData = allocData( lBufLen + sizeof(pdf_utf16be) );
+    memcpy( pData, reinterpret_cast<const char*>(pszStringUtf16), lBufLen );
+    pData[lBufLen] = '\0';
+    pData[lBufLen+1] = '\0';
 }
 
 PdfString::PdfString( const pdf_utf16be* pszStringUtf16, size_t lLen )
-    : m_bHex( false ), m_bUnicode( true ), m_pEncoding( nullptr )
+    : m_lInlineSize( 0 ), m_bHex( false ), m_bUnicode( true ), m_pEncoding( nullptr )
 {
     size_t lBufLen = 0;
     const pdf_utf16be* pszCnt  = pszStringUtf16;
@@ -220,18 +221,24 @@ PdfString::PdfString( const pdf_utf16be* pszStringUtf16, size_t lLen )
 
     lBufLen *= sizeof(pdf_utf16be);
 
-    m_buffer = PdfRefCountedBuffer( lBufLen + sizeof(pdf_utf16be) );
-    memcpy( m_buffer.GetBuffer(), reinterpret_cast<const char*>(pszStringUtf16), lBufLen );
-    m_buffer.GetBuffer()[lBufLen] = '\0';
-    m_buffer.GetBuffer()[lBufLen+1] = '\0';
+    char* pData = allocData( lBufLen + sizeof(pdf_utf16be) );
+    memcpy( pData, reinterpret_cast<const char*>(pszStringUtf16), lBufLen );
+    pData[lBufLen] = '\0';
+    pData[lBufLen+1] = '\0';
 }
 
 PdfString::PdfString( const PdfString & rhs )
-    : PdfDataType(), m_bHex( false ), m_bUnicode( false ), m_pEncoding( nullptr )
+    : PdfDataType(), m_lInlineSize( 0 ), m_bHex( false ), m_bUnicode( false ), m_pEncoding( nullptr )
 {
     this->operator=( rhs );
 }
 
+PdfString::PdfString( PdfString && rhs )
+    : PdfDataType(), m_lInlineSize( 0 ), m_bHex( false ), m_bUnicode( false ), m_pEncoding( nullptr )
+{
+    this->operator=( std::move( rhs ) );
+}
+
 PdfString PdfString::FromUtf8String( const std::string &str )
 {
     return PdfString( ( const pdf_utf8 * )str.c_str(), str.size() );
@@ -268,9 +275,9 @@ void PdfString::SetHexData( const char* pszHex, size_t lLen, PdfEncrypt* pEncryp
 
     // Allocate a buffer large enough for the hex decoded data
     // and the 2 terminating zeros
-    m_buffer = PdfRefCountedBuffer( lLen % 2 ? ((lLen + 1) >> 1) + 2 : (lLen >> 1) + 2 );
+    char* pData = allocData( lLen % 2 ? ((lLen + 1) >> 1) + 2 : (lLen >> 1) + 2 );
     m_bHex   = true;
-    char* pBuffer = m_buffer.GetBuffer();
+    char* pBuffer = pData;
     if ( pBuffer != nullptr )
     {
         char val;
@@ -314,22 +321,28 @@ void PdfString::SetHexData( const char* pszHex, size_t lLen, PdfEncrypt* pEncryp
 
         // If the allocated internal buffer is too big (e.g. because of whitespaces in the data)
         // copy to a smaller buffer so that PdfString::GetLength() will be correct
-        lLen = pBuffer - m_buffer.GetBuffer();
-        if( static_cast<size_t>(lLen) != m_buffer.GetSize() )
+        lLen = pBuffer - pData;
+        if( static_cast<size_t>(lLen) != getDataSize() )
         {
-            PdfRefCountedBuffer temp( lLen );
-            memcpy( temp.GetBuffer(), m_buffer.GetBuffer(), lLen );
-            m_buffer = temp;
+            if( m_lInlineSize != 0 )
+            {
+                m_lInlineSize = static_cast<unsigned char>( lLen );
+            }
+            else
+            {
+                PdfRefCountedBuffer temp = m_buffer;
+                memcpy( allocData( lLen ), temp.GetBuffer(), lLen );
+            }
         }
     }
     
     if( pEncrypt )
     {
-        size_t outBufferLen = m_buffer.GetSize() - 2 - pEncrypt->CalculateStreamOffset();
+        size_t outBufferLen = getDataSize() - 2 - pEncrypt->CalculateStreamOffset();
         PdfRefCountedBuffer outBuffer(outBufferLen + 16 - (outBufferLen % 16));
         
-        pEncrypt->Decrypt( reinterpret_cast<unsigned char*>(m_buffer.GetBuffer()),
-                           static_cast<unsigned int>(m_buffer.GetSize()-2),
+        pEncrypt->Decrypt( reinterpret_cast<const unsigned char*>(getData()),
+                           static_cast<unsigned int>(getDataSize()-2),
                           reinterpret_cast<unsigned char*>(outBuffer.GetBuffer()),
                           outBufferLen);
         // Add trailing pair of zeros
@@ -339,18 +352,28 @@ void PdfString::SetHexData( const char* pszHex, size_t lLen, PdfEncrypt* pEncryp
 
         // Replace buffer with decrypted value
         m_buffer = outBuffer;
+        m_lInlineSize = 0;
     }
 
     // Now check for the first two bytes, to see if we got a unicode string
-    if( m_buffer.GetSize() >= 4 ) 
+    if( getDataSize() >= 4 ) 
     {
-		m_bUnicode = (m_buffer.GetBuffer()[0] == static_cast<char>(0xFE) && m_buffer.GetBuffer()[1] == static_cast<char>(0xFF));
+		m_bUnicode = (getData()[0] == static_cast<char>(0xFE) && getData()[1] == static_cast<char>(0xFF));
 		
 		if( m_bUnicode ) 
         {
-            PdfRefCountedBuffer temp( m_buffer.GetSize() - 2 );
-            memcpy( temp.GetBuffer(), m_buffer.GetBuffer() + 2, m_buffer.GetSize() - 2 );
-            m_buffer = temp;           
+            size_t lSize = getDataSize() - 2;
+            if( m_lInlineSize != 0 )
+            {
+                memmove( m_inlineBuffer, m_inlineBuffer + 2, lSize );
+                m_lInlineSize = static_cast<unsigned char>( lSize );
+            }
+            else
+            {
+                PdfRefCountedBuffer temp( lSize );
+                memcpy( temp.GetBuffer(), m_buffer.GetBuffer() + 2, lSize );
+                m_buffer = temp;
+            }
         }
     }
 }
@@ -363,9 +386,9 @@ void PdfString::Write ( PdfOutputDevice& pDevice, EPdfWriteMode eWriteMode, cons
     // Peter Petrov: 17 May 2008
     // Added check - m_buffer.GetSize()
     // Now we are not encrypting the empty strings (was access violation)!
-    if( pEncrypt && m_buffer.GetSize() && IsValid() )
+    if( pEncrypt && getDataSize() && IsValid() )
     {
-        size_t nInputBufferLen = m_buffer.GetSize() - 2; // Cut off the trailing pair of zeros
+        size_t nInputBufferLen = getDataSize() - 2; // Cut off the trailing pair of zeros
         size_t nUnicodeMarkerOffet = sizeof( PdfString::s_pszUnicodeMarker );
         if( m_bUnicode )
             nInputBufferLen += nUnicodeMarkerOffet;
@@ -375,10 +398,10 @@ void PdfString::Write ( PdfOutputDevice& pDevice, EPdfWriteMode eWriteMode, cons
         if( m_bUnicode )
         {
             memcpy(pInputBuffer, PdfString::s_pszUnicodeMarker, nUnicodeMarkerOffet);
-            memcpy(&pInputBuffer[nUnicodeMarkerOffet], m_buffer.GetBuffer(), nInputBufferLen - nUnicodeMarkerOffet);
+            memcpy(&pInputBuffer[nUnicodeMarkerOffet], getData(), nInputBufferLen - nUnicodeMarkerOffet);
         }
         else
-            memcpy(pInputBuffer, m_buffer.GetBuffer(), nInputBufferLen);
+            memcpy(pInputBuffer, getData(), nInputBufferLen);
         
         size_t nOutputBufferLen = pEncrypt->CalculateStreamLength(nInputBufferLen);
         
@@ -396,10 +419,10 @@ void PdfString::Write ( PdfOutputDevice& pDevice, EPdfWriteMode eWriteMode, cons
     }
 
     pDevice.Print( m_bHex ? "<" : "(" );
-    if( m_buffer.GetSize() && IsValid() )
+    if( getDataSize() && IsValid() )
     {
-        const char* pBuf = m_buffer.GetBuffer();
-        size_t lLen = m_buffer.GetSize() - 2; // Cut off the trailing pair of zeros
+        const char* pBuf = getData();
+        size_t lLen = getDataSize() - 2; // Cut off the trailing pair of zeros
 
         if( m_bHex ) 
         {
@@ -450,11 +473,37 @@ void PdfString::Write ( PdfOutputDevice& pDevice, EPdfWriteMode eWriteMode, cons
 
 const PdfString & PdfString::operator=( const PdfString & rhs )
 {
-    this->m_bHex      = rhs.m_bHex;
-    this->m_bUnicode  = rhs.m_bUnicode;
-    this->m_buffer    = rhs.m_buffer;
-    this->m_sUtf8     = rhs.m_sUtf8;
-    this->m_pEncoding = rhs.m_pEncoding;
+    if( this == &rhs )
+        return *this;
+
+    // Copies always share the buffer, so that pointers returned
+    // by GetString() on a copy live as long as the original
+    this->m_bHex        = rhs.m_bHex;
+    this->m_bUnicode    = rhs.m_bUnicode;
+    this->m_buffer      = rhs.shareBuffer();
+    this->m_lInlineSize = 0;
+    this->m_sUtf8       = rhs.m_sUtf8;
+    this->m_pEncoding   = rhs.m_pEncoding;
+
+    return *this;
+}
+
+const PdfString & PdfString::operator=( PdfString && rhs )
+{
+    if( this == &rhs )
+        return *this;
+
+    // Inline data is copied, so moving a short string
+    // does not need a shared buffer
+    this->m_bHex        = rhs.m_bHex;
+    this->m_bUnicode    = rhs.m_bUnicode;
+    this->m_buffer      = rhs.m_buffer;
+    this->m_lInlineSize = rhs.m_lInlineSize;
+    if( m_lInlineSize != 0 )
+        memcpy( m_inlineBuffer, rhs.m_inlineBuffer, m_lInlineSize );
+
+    this->m_sUtf8       = std::move( rhs.m_sUtf8 );
+    this->m_pEncoding   = rhs.m_pEncoding;
 
     return *this;
 }
@@ -530,19 +579,18 @@ bool PdfString::operator==( const PdfString & rhs ) const
         return false;
     }
 
-    PdfString str1 = *this;
-    PdfString str2 = rhs;
-
-    if( m_bUnicode || rhs.m_bUnicode )
+    if( m_bUnicode != rhs.m_bUnicode )
     {
-        // one or both strings are unicode:
-        // make sure both are unicode so that 
-        // we do not loose information
-        str1 = str1.ToUnicode();
-        str2 = str2.ToUnicode();
+        // one string is unicode: make sure both
+        // are unicode so that we do not loose information
+        if( m_bUnicode )
+            return *this == rhs.ToUnicode();
+        else
+            return this->ToUnicode() == rhs;
     }
 
-    return str1.m_buffer == str2.m_buffer;
+    return getDataSize() == rhs.getDataSize()
+        && memcmp( getData(), rhs.getData(), getDataSize() ) == 0;
 }
 
 void PdfString::Init( const char* pszString, size_t lLen )
@@ -576,16 +624,16 @@ void PdfString::Init( const char* pszString, size_t lLen )
     }
 
     
-    m_buffer = PdfRefCountedBuffer( lLen + 2 );
-    memcpy( m_buffer.GetBuffer(), pszString, lLen );
-    m_buffer.GetBuffer()[lLen] = '\0';
-    m_buffer.GetBuffer()[lLen+1] = '\0';
+    char* pData = allocData( lLen + 2 );
+    memcpy( pData, pszString, lLen );
+    pData[lLen] = '\0';
+    pData[lLen+1] = '\0';
 
     // if the buffer is a UTF-16LE string
     // convert it to UTF-16BE
     if( bUft16LE ) 
     {
-        SwapBytes( m_buffer.GetBuffer(), lLen );
+        SwapBytes( pData, lLen );
     }
 }
 
@@ -598,17 +646,17 @@ void PdfString::InitFromUtf8( const pdf_utf8* pszStringUtf8, size_t lLen )
 
     std::vector<pdf_utf16be> u16str;
     utf8::utf8to16(utf8::endianess::big_endian, pszStringUtf8, pszStringUtf8 + lLen, std::back_inserter(u16str));
-    m_buffer = PdfRefCountedBuffer(u16str.size() * sizeof(pdf_utf16be) + sizeof(pdf_utf16be));
-    memcpy( m_buffer.GetBuffer(), reinterpret_cast<const char*>(u16str.data()), u16str.size() * sizeof(pdf_utf16be));
-    m_buffer.GetBuffer()[u16str.size() * sizeof(pdf_utf16be)] = '\0';
-    m_buffer.GetBuffer()[u16str.size() * sizeof(pdf_utf16be) + 1] = '\0';
+    char* pData = allocData(u16str.size() * sizeof(pdf_utf16be) + sizeof(pdf_utf16be));
+    memcpy( pData, reinterpret_cast<const char*>(u16str.data()), u16str.size() * sizeof(pdf_utf16be));
+    pData[u16str.size() * sizeof(pdf_utf16be)] = '\0';
+    pData[u16str.size() * sizeof(pdf_utf16be) + 1] = '\0';
 }
 
 void PdfString::InitUtf8()
 {
     if( this->IsUnicode() )
     {
-        const pdf_utf16be* buffer = reinterpret_cast<const pdf_utf16be*>(m_buffer.GetBuffer());
+        const pdf_utf16be* buffer = reinterpret_cast<const pdf_utf16be*>(getData());
         utf8::utf16to8(utf8::endianess::big_endian, buffer, buffer + this->GetUnicodeLength(), std::back_inserter(m_sUtf8));
     }
     else
@@ -632,8 +680,8 @@ const std::wstring PdfString::GetStringW() const
         return this->ToUnicode().GetStringW();
     }
 
-    PdfRefCountedBuffer buffer( m_buffer.GetSize() );
-    memcpy( buffer.GetBuffer(), m_buffer.GetBuffer(), m_buffer.GetSize() );
+    PdfRefCountedBuffer buffer( getDataSize() );
+    memcpy( buffer.GetBuffer(), getData(), getDataSize() );
 #ifdef PODOFO_IS_LITTLE_ENDIAN
     SwapBytes( buffer.GetBuffer(), buffer.GetSize() );
 #endif // PODOFO_IS_LITTLE_ENDIA
@@ -685,32 +733,70 @@ void PdfString::SwapBytes(char* pBuf, size_t lLen)
 
 PdfRefCountedBuffer &PdfString::GetBuffer(void)
 {
+    // The buffer may be modified: from now on it holds the data
+    shareBuffer();
+    m_lInlineSize = 0;
 	return m_buffer;
 }
 
 const PdfRefCountedBuffer &PdfString::GetBuffer(void) const
 {
+    return shareBuffer();
+}
+
+char* PdfString::allocData( size_t lSize )
+{
+    if( lSize <= PDF_STRING_BUFFER_SIZE )
+    {
+        m_buffer = PdfRefCountedBuffer();
+        m_lInlineSize = static_cast<unsigned char>( lSize );
+        return m_inlineBuffer;
+    }
+
+    m_buffer = PdfRefCountedBuffer( lSize );
+    m_lInlineSize = 0;
+    return m_buffer.GetBuffer();
+}
+
+const char* PdfString::getData() const
+{
+    return m_lInlineSize != 0 ? m_inlineBuffer : m_buffer.GetBuffer();
+}
+
+size_t PdfString::getDataSize() const
+{
+    return m_lInlineSize != 0 ? m_lInlineSize : m_buffer.GetSize();
+}
+
+const PdfRefCountedBuffer& PdfString::shareBuffer() const
+{
+    if( m_lInlineSize != 0 && m_buffer.GetBuffer() == nullptr )
+    {
+        m_buffer = PdfRefCountedBuffer( m_lInlineSize );
+        memcpy( m_buffer.GetBuffer(), m_inlineBuffer, m_lInlineSize );
+    }
+
     return m_buffer;
 }
 
 bool PdfString::IsValid() const
 {
-    return (m_buffer.GetBuffer() != nullptr);
+    return (getData() != nullptr);
 }
 
 const char* PdfString::GetString() const
 {
-    return m_buffer.GetBuffer();
+    return getData();
 }
 
 const pdf_utf16be* PdfString::GetUnicode() const
 {
-    return reinterpret_cast<const pdf_utf16be*>(m_buffer.GetBuffer());
+    return reinterpret_cast<const pdf_utf16be*>(getData());
 }
 
 const std::string& PdfString::GetStringUtf8() const
 {
-    if (this->IsValid() && !m_sUtf8.length() && m_buffer.GetSize() - 2)
+    if (this->IsValid() && !m_sUtf8.length() && getDataSize() - 2)
         const_cast<PdfString*>(this)->InitUtf8();
 
     return m_sUtf8;
@@ -724,9 +810,9 @@ size_t PdfString::GetLength() const
         return 0;
     }
 
-    PODOFO_ASSERT(m_buffer.GetSize() >= 2);
+    PODOFO_ASSERT(getDataSize() >= 2);
 
-    return m_buffer.GetSize() - 2;
+    return getDataSize() - 2;
 }
 
 size_t PdfString::GetCharacterLength() const
@@ -742,7 +828,7 @@ size_t PdfString::GetUnicodeLength() const
         return 0;
     }
 
-    PODOFO_ASSERT((m_buffer.GetSize() / sizeof(pdf_utf16be)) >= 1);
+    PODOFO_ASSERT((getDataSize() / sizeof(pdf_utf16be)) >= 1);
 
-    return (m_buffer.GetSize() / sizeof(pdf_utf16be)) - 1;
+    return (getDataSize() / sizeof(pdf_utf16be)) - 1;
 }
@@ -73,7 +73,9 @@ enum class EPdfStringConversion
  *
  *
  *  PdfString is an implicitly shared class. As a reason
- *  it is very fast to copy PdfString objects.
+ *  it is very fast to copy PdfString objects. Short strings
+ *  are stored inside the object and get a shared buffer
+ *  only when they are copied for the first time.
  *
  *  The internal string buffer is guaranteed to be always terminated 
  *  by 2 zero ('\0') bytes.
@@ -164,6 +166,11 @@ public:
      */
     PdfString( const PdfString & rhs );
 
+    /** Move an existing PdfString
+     *  \param rhs another PdfString to move
+     */
+    PdfString( PdfString && rhs );
+
     /** Construct a new PdfString from an UTF-8 encoded string.
      *
      *  \param str an UTF-8 encoded string.
@@ -321,6 +328,12 @@ public:
      */
     const PdfString & operator=( const PdfString & rhs );
 
+    /** Move an existing PdfString
+     *  \param rhs another PdfString to move
+     *  \returns this object
+     */
+    const PdfString & operator=( PdfString && rhs );
+
     /** Compare two PdfString objects
      *  \param rhs another PdfString to compare with
      *  \returns this object
@@ -416,6 +429,23 @@ private:
 #ifdef WIN32
     void setFromWchar_t(const wchar_t* pszString, size_t lLen);
 #endif
+
+    /** Allocate the storage for the string data, inline if it is
+     *  short enough and in a new shared buffer otherwise.
+     *
+     *  \param lSize size of the data, including the 2 terminating zeros
+     *  \returns the (uninitialized) storage
+     */
+    char* allocData( size_t lSize );
+
+    const char* getData() const;
+    size_t getDataSize() const;
+
+    /** \returns a shared buffer with the string data, creating
+     *  it from the inline data if needed. The inline data is
+     *  kept, so pointers returned by GetString() stay valid
+     */
+    const PdfRefCountedBuffer& shareBuffer() const;
  private:
     static const char        s_pszUnicodeMarker[];   ///< The unicode marker used to indicate unicode strings in PDF
     static const char*       s_pszUnicodeMarkerHex;  ///< The unicode marker converted to hex
@@ -423,7 +453,9 @@ private:
     static const char * const m_escMap;              ///< Mapping of escape sequences to their value
 
  private:
-    PdfRefCountedBuffer m_buffer;                    ///< String data (always binary), may contain '\0' bytes
+    mutable PdfRefCountedBuffer m_buffer;            ///< String data (always binary), may contain '\0' bytes
+    char                m_inlineBuffer[PDF_STRING_BUFFER_SIZE]; ///< Data of short strings, used instead of m_buffer
+    unsigned char       m_lInlineSize;               ///< Size of the inline data, including the terminating zeros. 0 if m_buffer is used
 
     bool                m_bHex;                      ///< This string is converted to hex during writing it out
     bool                m_bUnicode;                  ///< This string contains unicode data
@@ -0,0 +1,95 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the PoDoFo developers                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License as       *
+ *   published by the Free Software Foundation; either version 2 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this program; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ *   In addition, as a special exception, the copyright holders give       *
+ *   permission to link the code of portions of this program with the      *
+ *   OpenSSL library under certain conditions as described in each         *
+ *   individual source file, and distribute linked combinations            *
+ *   including the two.                                                    *
+ *   You must obey the GNU General Public License in all respects          *
+ *   for all of the code used other than OpenSSL.  If you modify           *
+ *   file(s) with this exception, you may extend this exception to your    *
+ *   version of the file(s), but you are not obligated to do so.  If you   *
+ *   do not wish to do so, delete this exception statement from your       *
+ *   version.  If you delete this exception statement from all source      *
+ *   files in the program, then also delete it here.                       *
+ ***************************************************************************/
+
+#include "PdfStringStream.h"
+
+#include "PdfDefinesPrivate.h"
+
+using namespace std;
+using namespace PoDoFo;
+
+PdfStringStream::PdfStringStream()
+    : m_nPrecision(6)
+{
+}
+
+PdfStringStream& PdfStringStream::operator<<(double value)
+{
+    char buffer[utls::FormatBufferSize];
+    auto view = utls::FormatTo(buffer, value, m_nPrecision, false);
+    m_buffer.append(view.data(), view.size());
+    return *this;
+}
+
+PdfStringStream& PdfStringStream::operator<<(char ch)
+{
+    m_buffer.push_back(ch);
+    return *this;
+}
+
+PdfStringStream& PdfStringStream::operator<<(const char* str)
+{
+    m_buffer.append(str);
+    return *this;
+}
+
+PdfStringStream& PdfStringStream::operator<<(const string_view& view)
+{
+    m_buffer.append(view.data(), view.size());
+    return *this;
+}
+
+void PdfStringStream::Write(const char* pBuffer, size_t lLen)
+{
+    m_buffer.append(pBuffer, lLen);
+}
+
+void PdfStringStream::Clear()
+{
+    // NOTE: The capacity is kept, so the buffer can be reused
+    m_buffer.clear();
+}
+
+void PdfStringStream::SetPrecision(unsigned short nPrecision)
+{
+    if (nPrecision > utls::MaxRealPrecision)
+        PODOFO_RAISE_ERROR_INFO(EPdfError::ValueOutOfRange, "The precision is too high");
+
+    m_nPrecision = nPrecision;
+}
+
+void PdfStringStream::writeInteger(int64_t value)
+{
+    char buffer[utls::FormatBufferSize];
+    auto view = utls::FormatTo(buffer, value);
+    m_buffer.append(view.data(), view.size());
+}
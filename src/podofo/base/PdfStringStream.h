@@ -0,0 +1,116 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the PoDoFo developers                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License as       *
+ *   published by the Free Software Foundation; either version 2 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this program; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ *   In addition, as a special exception, the copyright holders give       *
+ *   permission to link the code of portions of this program with the      *
+ *   OpenSSL library under certain conditions as described in each         *
+ *   individual source file, and distribute linked combinations            *
+ *   including the two.                                                    *
+ *   You must obey the GNU General Public License in all respects          *
+ *   for all of the code used other than OpenSSL.  If you modify           *
+ *   file(s) with this exception, you may extend this exception to your    *
+ *   version of the file(s), but you are not obligated to do so.  If you   *
+ *   do not wish to do so, delete this exception statement from your       *
+ *   version.  If you delete this exception statement from all source      *
+ *   files in the program, then also delete it here.                       *
+ ***************************************************************************/
+
+#ifndef _PDF_STRING_STREAM_H_
+#define _PDF_STRING_STREAM_H_
+
+#include "PdfDefines.h"
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace PoDoFo {
+
+/** A growable, contiguous character buffer to build PDF
+ *  content, like content streams. Numbers are formatted
+ *  regardless of the current locale, and much faster than
+ *  with std::ostringstream
+ *
+ *  Real numbers are written in fixed notation, with
+ *  the number of decimal digits set by SetPrecision()
+ */
+class PODOFO_API PdfStringStream
+{
+public:
+    /** Create an empty stream, writing real
+     *  numbers with 6 decimal digits
+     */
+    PdfStringStream();
+
+    PdfStringStream& operator<<(double value);
+
+    PdfStringStream& operator<<(char ch);
+
+    PdfStringStream& operator<<(const char* str);
+
+    PdfStringStream& operator<<(const std::string_view& view);
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    PdfStringStream& operator<<(T value)
+    {
+        writeInteger(static_cast<int64_t>(value));
+        return *this;
+    }
+
+    /** Append raw data to the stream
+     *  \param pBuffer the data to append
+     *  \param lLen the size of the data in bytes
+     */
+    void Write(const char* pBuffer, size_t lLen);
+
+    /** Remove all the content of the stream
+     */
+    void Clear();
+
+    /** Set the number of decimal digits used to write real numbers
+     *  \param nPrecision the number of decimal digits, at most 20
+     */
+    void SetPrecision(unsigned short nPrecision);
+
+    /**
+     *  \returns the number of decimal digits used to write real numbers
+     */
+    inline unsigned short GetPrecision() const { return m_nPrecision; }
+
+    /**
+     *  \returns a view on the content of the stream, which is
+     *  valid until the stream is modified
+     */
+    inline std::string_view GetString() const { return m_buffer; }
+
+    /**
+     *  \returns the size of the content in bytes
+     */
+    inline size_t GetSize() const { return m_buffer.size(); }
+
+private:
+    void writeInteger(int64_t value);
+
+private:
+    std::string m_buffer;
+    unsigned short m_nPrecision;
+};
+
+};
+
+#endif // _PDF_STRING_STREAM_H_
@@ -45,6 +45,7 @@
 #include "PdfVariant.h"
 #include "PdfDefinesPrivate.h"
 
+#include <charconv>
 #include <limits>
 #include <sstream>
 #include <memory>
@@ -146,6 +147,25 @@ const char* genHexMap()
 
 };
 
+// Parse the leading integer of the token in the same way strtoll()
+// does, without requiring the token to be null terminated
+static bool tryParseLeadingInteger(const string_view& token, int64_t& num)
+{
+    const char* begin = token.data();
+    const char* end = begin + token.length();
+    if (begin != end && *begin == '+' && end - begin > 1 && isdigit(static_cast<unsigned char>(begin[1])))
+        begin++;
+
+    auto result = from_chars(begin, end, num);
+    if (result.ec == errc::invalid_argument)
+        return false;
+
+    if (result.ec == errc::result_out_of_range)
+        num = *begin == '-' ? numeric_limits<int64_t>::min() : numeric_limits<int64_t>::max();
+
+    return true;
+}
+
 const char * const PdfTokenizer::s_delimiterMap  = PdfTokenizerNameSpace::genDelMap();
 const char * const PdfTokenizer::s_whitespaceMap = PdfTokenizerNameSpace::genWsMap();
 const char * const PdfTokenizer::s_escMap        = PdfTokenizerNameSpace::genEscMap();
@@ -222,6 +242,9 @@ bool PdfTokenizer::TryReadNextToken(const PdfRefCountedInputDevice& device, stri
     if( peType )
         *peType = EPdfTokenType::Literal;
 
+    if (device.Device()->HasSpan())
+        return tryReadNextTokenFromSpan(*device.Device(), pszToken, peType);
+
     while( (c = device.Device()->Look()) != EOF
            && counter + 1 < static_cast<int64_t>(m_buffer.GetSize()) )
     {
@@ -314,6 +337,88 @@ bool PdfTokenizer::TryReadNextToken(const PdfRefCountedInputDevice& device, stri
     return true;
 }
 
+bool PdfTokenizer::tryReadNextTokenFromSpan(PdfInputDevice& device, string_view& pszToken, EPdfTokenType* peType)
+{
+    // Same semantics of the character by character loop above, but the
+    // returned token points directly into the device memory
+    string_view span = device.GetSpan();
+    const char* begin = span.data();
+    const char* end = begin + span.length();
+    const char* cursor = begin + device.Tell();
+
+    for (;;)
+    {
+        // ignore leading whitespaces
+        while (cursor != end && s_whitespaceMap[static_cast<unsigned char>(*cursor)])
+            cursor++;
+
+        if (cursor == end)
+        {
+            device.Seek(static_cast<std::streamoff>(cursor - begin));
+            pszToken = { };
+            return false;
+        }
+
+        if (*cursor != '%')
+            break;
+
+        cursor = skipComment(cursor, end);
+    }
+
+    const char* tokenStart = cursor;
+    char c = *cursor;
+    cursor++;
+    if (c == '<' || c == '>')
+    {
+        // special handling for << and >> tokens
+        if (peType)
+            *peType = EPdfTokenType::Delimiter;
+
+        if (cursor != end && *cursor == c)
+            cursor++;
+    }
+    else if (s_delimiterMap[static_cast<unsigned char>(c)])
+    {
+        // All other delimiters are one-character tokens
+        if (peType)
+            *peType = EPdfTokenType::Delimiter;
+    }
+    else
+    {
+        while (cursor != end && !s_whitespaceMap[static_cast<unsigned char>(*cursor)]
+            && !s_delimiterMap[static_cast<unsigned char>(*cursor)])
+        {
+            cursor++;
+        }
+    }
+
+    pszToken = string_view(tokenStart, cursor - tokenStart);
+
+    // A comment directly following a regular token is
+    // consumed together with it, as it's done above
+    if (cursor != end && *cursor == '%' && !s_delimiterMap[static_cast<unsigned char>(c)])
+        cursor = skipComment(cursor, end);
+
+    device.Seek(static_cast<std::streamoff>(cursor - begin));
+    return true;
+}
+
+const char* PdfTokenizer::skipComment(const char* cursor, const char* end)
+{
+    // Consume all characters up to and including the next line
+    // break, accepting 0x0D, 0x0A and 0x0D 0x0A as one EOL
+    while (cursor != end && *cursor != 0x0D && *cursor != 0x0A)
+        cursor++;
+
+    if (cursor == end)
+        return cursor;
+
+    if (*cursor == 0x0D && end - cursor > 1 && cursor[1] == 0x0A)
+        return cursor + 2;
+
+    return cursor + 1;
+}
+
 bool PdfTokenizer::IsNextToken(const PdfRefCountedInputDevice& device, const string_view& pszToken)
 {
     if (pszToken.length() == 0)
@@ -340,16 +445,15 @@ int64_t PdfTokenizer::ReadNextNumber(const PdfRefCountedInputDevice& device)
         PODOFO_RAISE_ERROR_INFO( EPdfError::UnexpectedEOF, "Expected number" );
     }
 
-    char* end;
-    long long num = strtoll(pszRead.data(), &end, 10);
-    if (pszRead == end)
+    int64_t num;
+    if (!tryParseLeadingInteger(pszRead, num))
     {
         // Don't consume the token
         this->EnqueueToken(pszRead, eType);
         PODOFO_RAISE_ERROR_INFO( EPdfError::NoNumber, "Could not read number" );
     }
 
-    return static_cast<int64_t>(num);
+    return num;
 }
 
 void PdfTokenizer::ReadNextVariant(const PdfRefCountedInputDevice& device, PdfVariant& rVariant, PdfEncrypt* pEncrypt)
@@ -405,40 +509,27 @@ PdfTokenizer::EPdfLiteralDataType PdfTokenizer::DetermineDataType(const PdfRefCo
         }
 
         EPdfLiteralDataType eDataType = EPdfLiteralDataType::Number;
-        const char* pszStart = pszToken.data();
-        while (*pszStart)
+        for (char ch : pszToken)
         {
-            if (*pszStart == '.')
+            if (ch == '.')
             {
                 eDataType = EPdfLiteralDataType::Real;
             }
-            else if( !(isdigit( *pszStart ) || *pszStart == '-' || *pszStart == '+' ) )
+            else if( !(isdigit( static_cast<unsigned char>(ch) ) || ch == '-' || ch == '+' ) )
             {
                 eDataType = EPdfLiteralDataType::Unknown;
                 break;
             }
-
-            ++pszStart;
         }
 
         if (eDataType == EPdfLiteralDataType::Real)
         {
-            double dVal;
-
-            m_doubleParser.clear(); // clear error state
-            m_doubleParser.str((string)pszToken);
-            if (!(m_doubleParser >> dVal))
-            {
-                m_doubleParser.clear(); // clear error state
-                PODOFO_RAISE_ERROR_INFO(EPdfError::InvalidDataType, pszToken.data());
-            }
-
-            rVariant = PdfVariant(dVal);
+            rVariant = PdfVariant(ParseReal(pszToken));
             return EPdfLiteralDataType::Real;
         }
         else if (eDataType == EPdfLiteralDataType::Number)
         {
-            rVariant = PdfVariant(static_cast<int64_t>(strtoll(pszToken.data(), nullptr, 10)));
+            rVariant = PdfVariant(ParseInteger(pszToken));
             // read another two tokens to see if it is a reference
             // we cannot be sure that there is another token
             // on the input device, so if we hit EOF just return
@@ -457,9 +548,8 @@ PdfTokenizer::EPdfLiteralDataType PdfTokenizer::DetermineDataType(const PdfRefCo
                 return EPdfLiteralDataType::Number;
             }
 
-            char* end;
-            long long l = strtoll(nextToken.data(), &end, 10);
-            if (nextToken.data() == end)
+            int64_t l;
+            if (!tryParseLeadingInteger(nextToken, l))
             {
                 this->EnqueueToken(nextToken, eSecondTokenType);
                 return EPdfLiteralDataType::Number;
@@ -607,7 +697,7 @@ void PdfTokenizer::ReadDictionary(const PdfRefCountedInputDevice& device, PdfVar
         PdfString string;
         string.SetHexData( contentsHexBuffer->size() ? &(*contentsHexBuffer)[0] : "", contentsHexBuffer->size(), encrypt );
 
-        val = string;
+        val = std::move( string );
         dict.AddKey( "Contents", val );
     }
 }
@@ -635,7 +725,103 @@ void PdfTokenizer::ReadArray(const PdfRefCountedInputDevice& device, PdfVariant&
     }
 }
 
+double PdfTokenizer::ParseReal(const string_view& pszToken)
+{
+    // Fast path for plain decimals with few digits: both the
+    // mantissa and the power of ten are exact doubles, so the
+    // division is correctly rounded like the stream parsing
+    static const double s_pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+        1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+
+    const char* cursor = pszToken.data();
+    const char* end = cursor + pszToken.length();
+    bool bNegative = false;
+    if (cursor != end && (*cursor == '-' || *cursor == '+'))
+    {
+        bNegative = *cursor == '-';
+        cursor++;
+    }
+
+    uint64_t nMantissa = 0;
+    int nDigits = 0;
+    int nFractionDigits = -1;
+    for (; cursor != end; cursor++)
+    {
+        if (*cursor == '.' && nFractionDigits == -1)
+        {
+            nFractionDigits = 0;
+            continue;
+        }
+
+        if (*cursor < '0' || *cursor > '9' || nDigits == 15)
+            break;
+
+        nMantissa = nMantissa * 10 + (*cursor - '0');
+        nDigits++;
+        if (nFractionDigits != -1)
+            nFractionDigits++;
+    }
+
+    if (cursor == end && nDigits != 0)
+    {
+        double dVal = static_cast<double>(nMantissa);
+        if (nFractionDigits > 0)
+            dVal /= s_pow10[nFractionDigits];
+
+        return bNegative ? -dVal : dVal;
+    }
+
+    double dVal;
+    m_doubleParser.clear(); // clear error state
+    m_doubleParser.str((string)pszToken);
+    if (!(m_doubleParser >> dVal))
+    {
+        m_doubleParser.clear(); // clear error state
+        PODOFO_RAISE_ERROR_INFO(EPdfError::InvalidDataType, (string)pszToken);
+    }
+
+    return dVal;
+}
+
+int64_t PdfTokenizer::ParseInteger(const string_view& pszToken)
+{
+    int64_t num;
+    if (!tryParseLeadingInteger(pszToken, num))
+        num = 0;
+
+    return num;
+}
+
 void PdfTokenizer::ReadString(const PdfRefCountedInputDevice& device, PdfVariant& rVariant, PdfEncrypt* pEncrypt )
+{
+    readString(device, m_vecBuffer);
+
+    if( m_vecBuffer.size() )
+    {
+        if( pEncrypt )
+        {
+            size_t outLen = m_vecBuffer.size() - pEncrypt->CalculateStreamOffset();
+            char * outBuffer = new char[outLen + 16 - (outLen % 16)];
+            pEncrypt->Decrypt( reinterpret_cast<unsigned char*>(&(m_vecBuffer[0])),
+                              static_cast<unsigned int>(m_vecBuffer.size()),
+                              reinterpret_cast<unsigned char*>(outBuffer), outLen);
+
+            rVariant = PdfString( outBuffer, outLen );
+
+            delete[] outBuffer;
+        }
+        else
+        {
+            rVariant = PdfString( &(m_vecBuffer[0]), m_vecBuffer.size() );
+        }
+    }
+    else
+    {
+        rVariant = PdfString("");
+    }
+}
+
+void PdfTokenizer::readString(const PdfRefCountedInputDevice& device, std::vector<char>& rVecBuffer)
 {
     int               c;
 
@@ -645,7 +831,7 @@ void PdfTokenizer::ReadString(const PdfRefCountedInputDevice& device, PdfVariant
     char              cOctValue     = 0;
     int               nBalanceCount = 0; // Balanced parathesis do not have to be escaped in strings
 
-    m_vecBuffer.clear();
+    rVecBuffer.clear();
 
     while( (c = device.Device()->Look()) != EOF )
     {
@@ -664,7 +850,7 @@ void PdfTokenizer::ReadString(const PdfRefCountedInputDevice& device, PdfVariant
 
             bEscape = (c == '\\');
             if( !bEscape )
-                m_vecBuffer.push_back( static_cast<char>(c) );
+                rVecBuffer.push_back( static_cast<char>(c) );
         }
         else
         {
@@ -684,7 +870,7 @@ void PdfTokenizer::ReadString(const PdfRefCountedInputDevice& device, PdfVariant
                     // No octal character anymore,
                     // so the octal sequence must be ended
                     // and the character has to be treated as normal character!
-                    m_vecBuffer.push_back ( cOctValue );
+                    rVecBuffer.push_back ( cOctValue );
                     bEscape    = false;
                     bOctEscape = false;
                     nOctCount  = 0;
@@ -698,7 +884,7 @@ void PdfTokenizer::ReadString(const PdfRefCountedInputDevice& device, PdfVariant
 
                 if( nOctCount > 2 )
                 {
-                    m_vecBuffer.push_back ( cOctValue );
+                    rVecBuffer.push_back ( cOctValue );
                     bEscape    = false;
                     bOctEscape = false;
                     nOctCount  = 0;
@@ -710,7 +896,7 @@ void PdfTokenizer::ReadString(const PdfRefCountedInputDevice& device, PdfVariant
                 // Handle plain escape sequences
                 const char & code = s_escMap[device.Device()->GetChar() & 0xff];
                 if( code )
-                    m_vecBuffer.push_back( code );
+                    rVecBuffer.push_back( code );
 
                 bEscape = false;
             }
@@ -719,31 +905,7 @@ void PdfTokenizer::ReadString(const PdfRefCountedInputDevice& device, PdfVariant
 
     // In case the string ends with a octal escape sequence
     if( bOctEscape )
-        m_vecBuffer.push_back ( cOctValue );
-
-    if( m_vecBuffer.size() )
-    {
-        if( pEncrypt )
-        {
-            size_t outLen = m_vecBuffer.size() - pEncrypt->CalculateStreamOffset();
-            char * outBuffer = new char[outLen + 16 - (outLen % 16)];
-            pEncrypt->Decrypt( reinterpret_cast<unsigned char*>(&(m_vecBuffer[0])),
-                              static_cast<unsigned int>(m_vecBuffer.size()),
-                              reinterpret_cast<unsigned char*>(outBuffer), outLen);
-
-            rVariant = PdfString( outBuffer, outLen );
-
-            delete[] outBuffer;
-        }
-        else
-        {
-            rVariant = PdfString( &(m_vecBuffer[0]), m_vecBuffer.size() );
-        }
-    }
-    else
-    {
-        rVariant = PdfString("");
-    }
+        rVecBuffer.push_back ( cOctValue );
 }
 
 void PdfTokenizer::ReadHexString(const PdfRefCountedInputDevice& device, PdfVariant& rVariant, PdfEncrypt* pEncrypt )
@@ -753,7 +915,7 @@ void PdfTokenizer::ReadHexString(const PdfRefCountedInputDevice& device, PdfVari
     PdfString string;
     string.SetHexData( m_vecBuffer.size() ? &(m_vecBuffer[0]) : "", m_vecBuffer.size(), pEncrypt );
 
-    rVariant = string;
+    rVariant = std::move( string );
 }
 
 void PdfTokenizer::readHexString(const PdfRefCountedInputDevice& device, std::vector<char>& rVecBuffer)
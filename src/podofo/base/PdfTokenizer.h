@@ -41,6 +41,7 @@
 #include "PdfRefCountedInputDevice.h"
 
 #include <deque>
+#include <limits>
 #include <sstream>
 
 namespace PoDoFo {
@@ -97,12 +98,13 @@ public:
     /** Reads the next token from the current file position
      *  ignoring all comments.
      *
-     *  \param[out] pszToken On true return, set to a pointer to the read
-     *                     token (a nullptr-terminated C string). The pointer is
-     *                     to memory owned by PdfTokenizer and must NOT be
-     *                     freed.  The contents are invalidated on the next
+     *  \param[out] pszToken On true return, set to a view of the read
+     *                     token. The view is not null terminated and
+     *                     points to memory owned by PdfTokenizer or, if the
+     *                     device has a contiguous span, directly to the device
+     *                     memory. The contents are invalidated on the next
      *                     call to tryReadNextToken(..) and by the destruction of
-     *                     the PdfTokenizer. Undefined on false return.
+     *                     the PdfTokenizer or the device. Undefined on false return.
      *
      *  \param[out] peType On true return, if not nullptr the type of the read token
      *                     will be stored into this parameter. Undefined on false
@@ -265,10 +267,13 @@ protected:
      */
     void ReadName(const PdfRefCountedInputDevice& device, PdfVariant& rVariant );
 
-    PdfRefCountedBuffer& GetBuffer() { return m_buffer; }
-
-private:
-    bool tryReadDataType(const PdfRefCountedInputDevice& device, EPdfLiteralDataType eDataType, PdfVariant& rVariant, PdfEncrypt* pEncrypt);
+    /** Read the characters of a string from the input device,
+     *  after the opening parenthesis, and store them unescaped
+     *  into a vector.
+     *
+     *  \param rVecBuffer store the string into this variable
+     */
+    void readString(const PdfRefCountedInputDevice& device, std::vector<char>& rVecBuffer);
 
     /** Read a hex string from the input device
      *  and store it into a vector.
@@ -277,6 +282,36 @@ private:
      */
     void readHexString(const PdfRefCountedInputDevice& device, std::vector<char>& rVecBuffer);
 
+    /** Parse a real number token
+     *
+     *  Throws InvalidDataType if the token is not a number.
+     *
+     *  \param pszToken the token to parse
+     *  \returns the value of the token
+     */
+    double ParseReal(const std::string_view& pszToken);
+
+    /** Parse an integer number token, in the same way
+     *  as DetermineDataType() does
+     *
+     *  \param pszToken the token to parse
+     *  \returns the value of the leading integer of the token, or 0
+     */
+    static int64_t ParseInteger(const std::string_view& pszToken);
+
+    PdfRefCountedBuffer& GetBuffer() { return m_buffer; }
+
+private:
+    /** Fast path of TryReadNextToken() for devices with a
+     *  contiguous span: the token is classified with the character
+     *  maps and returned without copying it
+     */
+    bool tryReadNextTokenFromSpan(PdfInputDevice& device, std::string_view& pszToken, EPdfTokenType* peType);
+
+    static const char* skipComment(const char* cursor, const char* end);
+
+    bool tryReadDataType(const PdfRefCountedInputDevice& device, EPdfLiteralDataType eDataType, PdfVariant& rVariant, PdfEncrypt* pEncrypt);
+
 private:
     // 256-byte array mapping character ordinal values to a truth value
     // indicating whether or not they are whitespace according to the PDF
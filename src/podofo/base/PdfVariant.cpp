@@ -81,6 +81,12 @@ PdfVariant::PdfVariant( const PdfString & rsString )
     m_Data.pData = new PdfString( rsString );
 }
 
+PdfVariant::PdfVariant( PdfString && rsString )
+    : PdfVariant(EPdfDataType::String)
+{
+    m_Data.pData = new PdfString( std::move( rsString ) );
+}
+
 PdfVariant::PdfVariant( const PdfName & rName )
     : PdfVariant(EPdfDataType::Name)
 {
@@ -117,6 +123,13 @@ PdfVariant::PdfVariant( const PdfVariant & rhs )
     this->operator=(rhs);
 }
 
+PdfVariant::PdfVariant( PdfVariant && rhs ) noexcept
+    : m_Data(rhs.m_Data), m_eDataType(rhs.m_eDataType)
+{
+    rhs.m_Data = { };
+    rhs.m_eDataType = EPdfDataType::Null;
+}
+
 PdfVariant::~PdfVariant()
 {
     Clear();
@@ -171,39 +184,20 @@ void PdfVariant::Write( PdfOutputDevice& pDevice, EPdfWriteMode eWriteMode,
             if( (eWriteMode & EPdfWriteMode::Compact) == EPdfWriteMode::Compact ) 
                 pDevice.Write( " ", 1 ); // Write space before numbers
 
-            pDevice.Print( "%" PDF_FORMAT_INT64, m_Data.nNumber );
+            char buffer[utls::FormatBufferSize];
+            pDevice.Write(utls::FormatTo(buffer, m_Data.nNumber));
             break;
         }
         case EPdfDataType::Real:
         {
-            if( (eWriteMode & EPdfWriteMode::Compact) == EPdfWriteMode::Compact ) 
+            bool bCompact = (eWriteMode & EPdfWriteMode::Compact) == EPdfWriteMode::Compact;
+            if( bCompact ) 
                 pDevice.Write( " ", 1 ); // Write space before numbers
 
-            // Use ostringstream, so that locale does not matter
             // NOTE: Don't use printf() formatting! It may write the number
-            // way that is incompatible in PDF
-            std::ostringstream oss;
-            PdfLocaleImbue(oss);
-            oss << std::fixed << m_Data.dNumber;
-            std::string copy = oss.str();
-            size_t len = copy.size();
-
-            if( (eWriteMode & EPdfWriteMode::Compact) == EPdfWriteMode::Compact && 
-                copy.find('.') != string::npos )
-            {
-                const char *str = copy.c_str();
-                while( str[len - 1] == '0' )
-                    --len;
-                if( str[len - 1] == '.' )
-                    --len;
-                if( len == 0 )
-                {
-                    pDevice.Write( "0", 1 );
-                    break;
-                }
-            }
-
-            pDevice.Write( copy.c_str(), len );
+            // way that is incompatible in PDF, depending on the locale
+            char buffer[utls::FormatBufferSize];
+            pDevice.Write(utls::FormatTo(buffer, m_Data.dNumber, pDevice.GetRealPrecision(), bCompact));
             break;
         }
         case EPdfDataType::String:
@@ -224,7 +218,7 @@ void PdfVariant::Write( PdfOutputDevice& pDevice, EPdfWriteMode eWriteMode,
                 pDevice.Write( " ", 1 ); // Write space before null
             }
 
-            pDevice.Print( "null" );
+            pDevice.Write( "null", 4 );
             break;
         }
         case EPdfDataType::Unknown:
@@ -248,6 +242,19 @@ void PdfVariant::ToString( std::string & rsData, EPdfWriteMode eWriteMode ) cons
     rsData = out.str();
 }
 
+const PdfVariant & PdfVariant::operator=( PdfVariant && rhs ) noexcept
+{
+    if (&rhs == this)
+        return *this;
+
+    Clear();
+    m_Data = rhs.m_Data;
+    m_eDataType = rhs.m_eDataType;
+    rhs.m_Data = { };
+    rhs.m_eDataType = EPdfDataType::Null;
+    return *this;
+}
+
 const PdfVariant & PdfVariant::operator=( const PdfVariant & rhs )
 {
     Clear();
@@ -103,6 +103,13 @@ public:
      */        
     PdfVariant( const PdfString & rsString );
 
+    /** Construct a PdfVariant that is a string, moving the
+     *  argument string so that short strings are not shared.
+     *
+     *  \param rsString the value of the string
+     */
+    PdfVariant( PdfString && rsString );
+
     /** Construct a PdfVariant that is a name.
      *  \param rName the value of the name
      */        
@@ -138,6 +145,12 @@ public:
      */
     PdfVariant( const PdfVariant & rhs );
 
+    /** Constructs a new PdfVariant taking the contents of rhs.
+     *  No data is copied: rhs is left as a EPdfDataType::Null variant.
+     *  \param rhs an existing variant which is moved.
+     */
+    PdfVariant( PdfVariant && rhs ) noexcept;
+
     ~PdfVariant();
 
     /** Clear all internal member variables and free the memory
@@ -344,6 +357,12 @@ public:
      */
     const PdfVariant & operator=( const PdfVariant & rhs );
 
+    /** Move the values of another PdfVariant to this one.
+     *  \param rhs an existing variant which is moved. It's
+     *         left as a EPdfDataType::Null variant
+     */
+    const PdfVariant & operator=( PdfVariant && rhs ) noexcept;
+
     /**
      * Test to see if the value contained by this variant is the same
      * as the value of the other variant.
@@ -40,7 +40,9 @@
 
 #include "PdfArray.h"
 #include "PdfDictionary.h"
+#include "PdfFiltersPrivate.h"
 #include "PdfMemStream.h"
+#include "PdfMemoryArena.h"
 #include "PdfObject.h"
 #include "PdfReference.h"
 #include "PdfStream.h"
@@ -100,6 +102,8 @@ size_t PdfVecObjects::m_nMaxReserveSize = static_cast<size_t>(8388607); // cf. T
 PdfVecObjects::PdfVecObjects(PdfDocument& document) :
     m_pDocument(&document),
     m_bCanReuseObjectNumbers( true ),
+    m_bUseMemoryArena( false ),
+    m_bDeferStreamEncoding( false ),
     m_nObjectCount( 1 ),
     m_sorted( true ),
     m_pStreamFactory(nullptr)
@@ -116,43 +120,108 @@ void PdfVecObjects::Clear()
     for (auto obj : m_vector)
         delete obj;
 
+    // Objects allocated from the arena are now all destroyed
+    m_pMemoryArena = nullptr;
+
     m_vector.clear();
+    m_vecObjectsByNumber.clear();
     m_nObjectCount = 1;
     m_sorted = true;
     m_pStreamFactory = nullptr;
 }
 
+void PdfVecObjects::SetFlateSettings( const PdfFlateSettings & rSettings )
+{
+    // A predictor depends on the layout of the data of each stream
+    if( rSettings.Predictor != EPdfPredictor::None )
+        PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidPredictor, "Predictors can be set only on streams" );
+
+    PdfFlateFilter::ValidateSettings( rSettings );
+    m_flateSettings = rSettings;
+}
+
+PdfMemoryArena* PdfVecObjects::getMemoryArena()
+{
+    if (!m_bUseMemoryArena)
+        return nullptr;
+
+    if (m_pMemoryArena == nullptr)
+        m_pMemoryArena.reset(new PdfMemoryArena());
+
+    return m_pMemoryArena.get();
+}
+
 PdfObject* PdfVecObjects::GetObject( const PdfReference & ref ) const
 {
-    const_cast<PdfVecObjects&>(*this).Sort();
-    TCIVecObjects it = std::lower_bound( m_vector.begin(), m_vector.end(), ref, CompareReference);
-    if( it == m_vector.end() || (*it)->GetIndirectReference() != ref)
+    if (ref.ObjectNumber() >= m_vecObjectsByNumber.size())
+        return nullptr;
+
+    // The generation must match as well
+    PdfObject* pObj = m_vecObjectsByNumber[ref.ObjectNumber()];
+    if (pObj == nullptr || pObj->GetIndirectReference() != ref)
         return nullptr;
 
-    return *it;
+    return pObj;
+}
+
+PdfObject* PdfVecObjects::getObjectByNumber(uint32_t nObjNo) const
+{
+    if (nObjNo >= m_vecObjectsByNumber.size())
+        return nullptr;
+
+    return m_vecObjectsByNumber[nObjNo];
 }
 
 unique_ptr<PdfObject> PdfVecObjects::RemoveObject( const PdfReference & ref, bool bMarkAsFree )
 {
-    const_cast<PdfVecObjects&>(*this).Sort();
-    TCIVecObjects it = std::lower_bound(m_vector.begin(), m_vector.end(), ref, CompareReference);
-    if (it == m_vector.end() || (*it)->GetIndirectReference() != ref)
+    PdfObject* pObj = GetObject(ref);
+    if (pObj == nullptr)
         return nullptr;
 
-    auto pObj = *(it);
+    // Locate the object without sorting the vector: erasing
+    // preserves the order, whatever it is
+    TIVecObjects it;
+    if (m_sorted)
+        it = std::lower_bound(m_vector.begin(), m_vector.end(), ref, CompareReference);
+    else
+        it = std::find(m_vector.begin(), m_vector.end(), pObj);
+
+    PODOFO_ASSERT(it != m_vector.end() && *it == pObj);
     if( bMarkAsFree )
-        SafeAddFreeObject(pObj->GetIndirectReference());
+        SafeAddFreeObject(ref);
 
-    m_vector.erase(it);
-    m_sorted = false;
-    return unique_ptr<PdfObject>(pObj);
+    return RemoveObject(it);
 }
 
 unique_ptr<PdfObject> PdfVecObjects::RemoveObject( const TIVecObjects & it )
 {
     auto pObj = *it;
+    uint32_t nObjNo = pObj->GetIndirectReference().ObjectNumber();
+    if (nObjNo < m_vecObjectsByNumber.size() && m_vecObjectsByNumber[nObjNo] == pObj)
+        m_vecObjectsByNumber[nObjNo] = nullptr;
+
     m_vector.erase( it );
-    m_sorted = false;
+
+    TIVecObservers itObservers = m_vecObservers.begin();
+    while( itObservers != m_vecObservers.end() )
+    {
+        (*itObservers)->ObjectRemoved( pObj );
+        ++itObservers;
+    }
+
+    // Objects allocated from the memory arena would be released
+    // with it, so the caller gets a copy on the heap instead
+    if (m_pMemoryArena != nullptr && m_pMemoryArena->Contains(pObj))
+    {
+        unique_ptr<PdfObject> pCopy(new PdfObject(*pObj));
+        pCopy->SetIndirectReference(pObj->GetIndirectReference());
+        if (pObj->GetDocument() != nullptr)
+            pCopy->SetDocument(*pObj->GetDocument());
+
+        delete pObj;
+        return pCopy;
+    }
+
     return unique_ptr<PdfObject>(pObj);
 }
 
@@ -258,10 +327,12 @@ void PdfVecObjects::AddFreeObject( const PdfReference & rReference )
 
 void PdfVecObjects::PushObject(const PdfReference & ref, PdfObject* pObj)
 {
-    if (GetObject(ref))
+    PdfObject* pExisting = getObjectByNumber(ref.ObjectNumber());
+    if (pExisting != nullptr)
     {
-        PdfError::LogMessage(ELogSeverity::Warning, "Object: %" PDF_FORMAT_INT64 " 0 R will be deleted and loaded again.", ref.ObjectNumber());
-        RemoveObject(ref, false);
+        PdfError::LogMessage(ELogSeverity::Warning, "Object: %u %u R will be deleted and loaded again.",
+            ref.ObjectNumber(), pExisting->GetIndirectReference().GenerationNumber());
+        RemoveObject(pExisting->GetIndirectReference(), false);
     }
 
     pObj->SetIndirectReference(ref);
@@ -278,10 +349,32 @@ void PdfVecObjects::addNewObject(PdfObject* obj)
 
 void PdfVecObjects::AddObject(PdfObject * pObj)
 {
-    SetObjectCount(pObj->GetIndirectReference());
+    const PdfReference& ref = pObj->GetIndirectReference();
+    PdfObject* pExisting = getObjectByNumber(ref.ObjectNumber());
+    if (pExisting != nullptr)
+    {
+        PdfError::LogMessage(ELogSeverity::Error, "Object: %u %u R is already in use by %u %u R",
+            ref.ObjectNumber(), ref.GenerationNumber(),
+            ref.ObjectNumber(), pExisting->GetIndirectReference().GenerationNumber());
+        PODOFO_RAISE_ERROR_INFO(EPdfError::InternalLogic, "Object number is already in use");
+    }
+
+    // The index is dense, so bound it the same way as Reserve()
+    if (ref.ObjectNumber() >= m_nMaxReserveSize)
+        PODOFO_RAISE_ERROR_INFO(EPdfError::ValueOutOfRange, "Object number is over the allowed limit");
+
+    SetObjectCount(ref);
     pObj->SetDocument(*m_pDocument);
+
+    if (ref.ObjectNumber() >= m_vecObjectsByNumber.size())
+        m_vecObjectsByNumber.resize(ref.ObjectNumber() + 1);
+
+    // Objects added in ascending order keep the vector sorted
+    if (m_sorted && !m_vector.empty() && *pObj < *m_vector.back())
+        m_sorted = false;
+
     m_vector.push_back(pObj);
-    m_sorted = false;
+    m_vecObjectsByNumber[ref.ObjectNumber()] = pObj;
 }
 
 void PdfVecObjects::Sort()
@@ -396,13 +489,13 @@ void PdfVecObjects::insertReferencesIntoVector(const PdfObject& obj, TVecReferen
         itKeys = obj.GetDictionary().begin();
         while( itKeys != obj.GetDictionary().end() )
         {
-            if( itKeys->second.IsReference() )
-                insertOneReferenceIntoVector(itKeys->second, list );
+            if( itKeys->second->IsReference() )
+                insertOneReferenceIntoVector(*itKeys->second, list );
             // optimization as this is really slow:
             // Call only for dictionaries, references and arrays
-            else if( itKeys->second.IsArray() ||
-                itKeys->second.IsDictionary() )
-                insertReferencesIntoVector(itKeys->second, list );
+            else if( itKeys->second->IsArray() ||
+                itKeys->second->IsDictionary() )
+                insertReferencesIntoVector(*itKeys->second, list );
             
             ++itKeys;
         }
@@ -443,10 +536,10 @@ void PdfVecObjects::GetObjectDependencies( const PdfObject& obj, TPdfReferenceLi
         {
             // optimization as this is really slow:
             // Call only for dictionaries, references and arrays
-            if( itKeys->second.IsArray() ||
-                itKeys->second.IsDictionary() ||
-                itKeys->second.IsReference() )
-                GetObjectDependencies( itKeys->second, list );
+            if( itKeys->second->IsArray() ||
+                itKeys->second->IsDictionary() ||
+                itKeys->second->IsReference() )
+                GetObjectDependencies( *itKeys->second, list );
             
             ++itKeys;
         }
@@ -619,6 +712,7 @@ void PdfVecObjects::Reserve(size_t size)
     if (size <= m_nMaxReserveSize) // Fix CVE-2018-5783
     {
         m_vector.reserve(size);
+        m_vecObjectsByNumber.reserve(size);
     }
     else
     {
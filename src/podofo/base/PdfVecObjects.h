@@ -38,12 +38,14 @@
 
 #include <set>
 #include <list>
+#include <memory>
 #include "PdfDefines.h"
 #include "PdfReference.h"
 
 namespace PoDoFo {
 
 class PdfDocument;
+class PdfMemoryArena;
 class PdfObject;
 class PdfStream;
 class PdfVariant;
@@ -119,6 +121,12 @@ public:
         virtual void EndAppendStream( const PdfStream* pStream ) = 0;
 
         virtual void Finish() = 0;
+
+        /** Called whenever an object is removed, before it is
+         *  handed to the caller of RemoveObject().
+         *  \param pObject the removed object
+         */
+        virtual void ObjectRemoved( const PdfObject* pObject ) { (void)pObject; }
     };
 
     /** This class is used to implement stream factories in PoDoFo.
@@ -158,6 +166,44 @@ public:
      */
     void SetCanReuseObjectNumbers( bool bCanReuseObjectNumbers );
 
+    /** Enable/disable allocating the objects read by PdfParser
+     *  from a memory arena owned by this vector. The arena is released
+     *  all at once by Clear() or when the vector is destroyed, which
+     *  reduces allocations and fragmentation when loading many documents.
+     *  Only the top level objects are allocated from the arena: their
+     *  destructors still run, and the contents of arrays, dictionaries
+     *  and strings are allocated on the heap.
+     *  By default the memory arena is disabled.
+     *
+     *  Objects removed with RemoveObject() are moved to the heap,
+     *  so they can be used after the arena has been released.
+     *
+     *  \param bUseMemoryArena if true, parsed objects are allocated from the arena
+     */
+    inline void SetUseMemoryArena( bool bUseMemoryArena ) { m_bUseMemoryArena = bUseMemoryArena; }
+
+    /** Set the Flate compression level and strategy used when
+     *  stream data of this document is encoded, e.g. a low level for
+     *  on-the-fly generation or the best compression for archival.
+     *  Streams can override it with PdfStream::SetFlateSettings().
+     *  Predictors can be set only on streams.
+     *
+     *  \param rSettings the settings to use for Flate encoded streams,
+     *         with no predictor
+     */
+    void SetFlateSettings( const PdfFlateSettings & rSettings );
+
+    /** Enable/disable deferring the encoding of data appended to
+     *  memory streams until the encoded data is needed, e.g. when
+     *  the document is written. Writing with
+     *  PdfSaveOptions::ParallelCompression then encodes the pending
+     *  streams concurrently.
+     *  By default deferred encoding is disabled.
+     *
+     *  \param bDeferStreamEncoding if true the encoding of appended data is deferred
+     */
+    inline void SetDeferStreamEncoding( bool bDeferStreamEncoding ) { m_bDeferStreamEncoding = bDeferStreamEncoding; }
+
     /** Removes all objects from the vector
      *  and resets it to the default state.
      *
@@ -179,8 +225,10 @@ public:
      */
     size_t GetObjectCount() const { return m_nObjectCount; }
 
-    /** Finds the object with the given reference in m_vecOffsets 
+    /** Finds the object with the given reference
      *  and returns a pointer to it if it is found.
+     *  The lookup is performed in constant time and doesn't
+     *  require the vector to be sorted.
      *  \param ref the object to be found
      *  \returns the found object or nullptr if no object was found.
      */
@@ -189,7 +237,9 @@ public:
     /** Remove the object with the given object and generation number from the list
      *  of objects.
      *  The object is returned if it was found. Otherwise nullptr is returned.
-     *  The caller has to delete the object by hisself.
+     *  The caller has to delete the object by hisself. An object allocated
+     *  from the memory arena is returned as a copy allocated on the heap,
+     *  so it can outlive the arena.
      *
      *  \param ref the object to be found
      *  \param bMarkAsFree if true the removed object reference is marked as free object
@@ -199,7 +249,8 @@ public:
      */
     std::unique_ptr<PdfObject> RemoveObject(const PdfReference& ref, bool bMarkAsFree = true);
 
-    /** Remove the object with the iterator it from the vector and return it
+    /** Remove the object with the iterator it from the vector and return it,
+     *  as RemoveObject(const PdfReference&, bool) does
      *  \param it the object to remove
      *  \returns the removed object
      */
@@ -378,24 +429,50 @@ public:
      */
     inline bool GetCanReuseObjectNumbers() const { return m_bCanReuseObjectNumbers; }
 
+    /**
+     *  \returns whether parsed objects are allocated from a memory arena
+     *  \see SetUseMemoryArena
+     */
+    inline bool GetUseMemoryArena() const { return m_bUseMemoryArena; }
+
+    /**
+     *  \returns the Flate settings used for the streams of this document
+     *  \see SetFlateSettings
+     */
+    inline const PdfFlateSettings & GetFlateSettings() const { return m_flateSettings; }
+
+    /**
+     *  \returns whether the encoding of data appended to memory streams is deferred
+     *  \see SetDeferStreamEncoding
+     */
+    inline bool GetDeferStreamEncoding() const { return m_bDeferStreamEncoding; }
+
     /** \returns a list of free references in this vector
      */
     inline const TPdfReferenceList& GetFreeObjects() const { return m_lstFreeObjects; }
 
 private:
-    /** Insert an object into this vector so that
-     *  the vector remains sorted w.r.t.
-     *  the ordering based on object and generation numbers
+    /** Insert an object into this vector and index it by
+     *  its object number. Only one object can be stored
+     *  for each object number: if the number is already in
+     *  use, whatever the generation, an exception is raised
+     *  and the object is not inserted.
      *  m_bObjectCount will be increased for the object.
      *
      *  \param pObj pointer to the object you want to insert
      */
     void AddObject(PdfObject* pObj);
 
-    /** Push an object with the givent reference. If one is existing, it will be replaced
+    /** Push an object with the givent reference. If one is existing
+     *  with the same object number, it will be replaced
      */
     void PushObject(const PdfReference &reference, PdfObject* pObj);
 
+    /** \returns the object with the given object number, whatever
+     *  its generation, or nullptr if there is none
+     */
+    PdfObject* getObjectByNumber(uint32_t nObjNo) const;
+
     /** Mark a reference as unused so that it can be reused for new objects.
      *
      *  Add the object only if the generation is the allowed range
@@ -429,6 +506,12 @@ private:
 private:
     void addNewObject(PdfObject* obj);
 
+    /**
+     * \returns the arena to allocate parsed objects from, or
+     *  nullptr if the memory arena is disabled
+     */
+    PdfMemoryArena* getMemoryArena();
+
     /**
      * \returns the next free object reference
      */
@@ -459,9 +542,14 @@ private:
 private:
     PdfDocument* m_pDocument;
     bool                m_bCanReuseObjectNumbers;
+    bool                m_bUseMemoryArena;
+    bool                m_bDeferStreamEncoding;
+    std::unique_ptr<PdfMemoryArena> m_pMemoryArena;
+    PdfFlateSettings    m_flateSettings;
     size_t              m_nObjectCount;
     bool                m_sorted;
     TVecObjects         m_vector;
+    TVecObjects         m_vecObjectsByNumber;   ///< Objects indexed by object number, nullptr for missing ones
 
 
     TVecObservers       m_vecObservers;
@@ -38,7 +38,10 @@
 #include "PdfData.h"
 #include "PdfDate.h"
 #include "PdfDictionary.h"
+#include "PdfFiltersPrivate.h"
+#include "PdfMemStream.h"
 #include "PdfObject.h"
+#include "PdfOutputStream.h"
 #include "PdfParser.h"
 #include "PdfParserObject.h"
 #include "PdfStream.h"
@@ -48,15 +51,42 @@
 #include "PdfDefinesPrivate.h"
 
 #define PDF_MAGIC           "\xe2\xe3\xcf\xd3\n"
+// Maximum number of objects packed in a single object stream
+#define OBJECT_STREAM_MAX_OBJECTS 100
 // 10 spaces
 #define LINEARIZATION_PADDING "          " 
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iostream>
+#include <thread>
 #include <stdlib.h>
 
 using namespace std;
 using namespace PoDoFo;
 
+namespace
+{
+    // Restores the real precision of an output device,
+    // also when leaving PdfWriter::Write with an exception
+    class PdfRealPrecisionGuard
+    {
+    public:
+        PdfRealPrecisionGuard(PdfOutputDevice& device)
+            : m_device(device), m_nPrecision(device.GetRealPrecision()) { }
+
+        ~PdfRealPrecisionGuard()
+        {
+            m_device.SetRealPrecision(m_nPrecision);
+        }
+
+    private:
+        PdfOutputDevice& m_device;
+        unsigned short m_nPrecision;
+    };
+}
+
 PdfWriter::PdfWriter(PdfVecObjects* pVecObjects, const PdfObject& pTrailer, EPdfVersion version) :
     m_vecObjects(pVecObjects),
     m_Trailer(pTrailer),
@@ -64,7 +94,9 @@ PdfWriter::PdfWriter(PdfVecObjects* pVecObjects, const PdfObject& pTrailer, EPdf
     m_UseXRefStream(false),
     m_pEncryptObj(nullptr),
     m_saveOptions(PdfSaveOptions::None),
+    m_nCompressionThreadCount(0),
     m_eWriteMode(EPdfWriteMode::Compact),
+    m_nRealPrecision(PdfRealPrecisionDefault),
     m_lPrevXRefOffset(0),
     m_bIncrementalUpdate(false),
     m_rewriteXRefTable(false),
@@ -91,6 +123,14 @@ void PdfWriter::SetIncrementalUpdate(bool rewriteXRefTable)
     m_rewriteXRefTable = rewriteXRefTable;
 }
 
+void PdfWriter::SetRealPrecision(unsigned short nPrecision)
+{
+    if (nPrecision > utls::MaxRealPrecision)
+        PODOFO_RAISE_ERROR_INFO(EPdfError::ValueOutOfRange, "The real precision is too high");
+
+    m_nRealPrecision = nPrecision;
+}
+
 const char* PdfWriter::GetPdfVersionString() const
 {
     return s_szPdfVersionNums[static_cast<int>(m_eVersion)];
@@ -103,6 +143,17 @@ PdfWriter::~PdfWriter()
 
 void PdfWriter::Write(PdfOutputDevice& device)
 {
+    PdfRealPrecisionGuard precisionGuard(device);
+    device.SetRealPrecision(m_nRealPrecision);
+
+    // Object streams require a XRef stream to be referenced.
+    // NOTE: They are not written in incremental updates, as
+    // the original file may use a XRef table
+    bool bObjectStreams = (m_saveOptions & PdfSaveOptions::ObjectStreams) == PdfSaveOptions::ObjectStreams
+        && !m_bIncrementalUpdate;
+    if (bObjectStreams)
+        SetUseXRefStream(true);
+
     CreateFileIdentifier( m_identifier, m_Trailer, &m_originalIdentifier );
 
     // setup encrypt dictionary
@@ -126,6 +177,12 @@ void PdfWriter::Write(PdfOutputDevice& device)
         if( !m_bIncrementalUpdate )
             WritePdfHeader(device);
 
+        if (bObjectStreams)
+            createObjectStreams(*pXRef);
+
+        if ((m_saveOptions & PdfSaveOptions::ParallelCompression) == PdfSaveOptions::ParallelCompression)
+            encodeStreamsParallel();
+
         WritePdfObjects(device, *m_vecObjects, *pXRef);
 
         if ( m_bIncrementalUpdate )
@@ -135,17 +192,25 @@ void PdfWriter::Write(PdfOutputDevice& device)
     }
     catch( PdfError & e )
     {   
-        // P.Zent: Delete Encryption dictionary (cannot be reused)
-        if(m_pEncryptObj)
-        {
-            m_vecObjects->RemoveObject(m_pEncryptObj->GetIndirectReference());
-            m_pEncryptObj = nullptr;
-        }
-        
+        cleanupWrite();
         e.AddToCallstack( __FILE__, __LINE__ );
         throw e;
     }
-    
+    catch (...)
+    {
+        // Exceptions rethrown from the encoding threads
+        // may not be PdfError, e.g. std::bad_alloc
+        cleanupWrite();
+        throw;
+    }
+
+    cleanupWrite();
+}
+
+void PdfWriter::cleanupWrite()
+{
+    removeObjectStreams();
+
     // P.Zent: Delete Encryption dictionary (cannot be reused)
     if(m_pEncryptObj)
     {
@@ -161,6 +226,7 @@ void PdfWriter::WritePdfHeader(PdfOutputDevice& device)
 
 void PdfWriter::WritePdfObjects(PdfOutputDevice& device, const PdfVecObjects& vecObjects, PdfXRef& xref)
 {
+    vector<PdfReference> skippedObjects;
     for(PdfObject* pObject : vecObjects )
     {
 	    if( m_bIncrementalUpdate )
@@ -196,21 +262,237 @@ void PdfWriter::WritePdfObjects(PdfOutputDevice& device, const PdfVecObjects& ve
             }
         }
 
-        xref.AddInUseObject( pObject->GetIndirectReference(), device.Tell());
+        if (m_compressedObjects.size() != 0)
+        {
+            auto found = m_compressedObjects.find(pObject->GetIndirectReference().ObjectNumber());
+            if (found != m_compressedObjects.end() && pObject->GetIndirectReference().GenerationNumber() == 0)
+            {
+                // The object is written in its object stream
+                xref.AddCompressedObject(pObject->GetIndirectReference(), (uint32_t)found->second.ObjectNumber, found->second.Index);
+                continue;
+            }
+        }
 
-        if (!xref.ShouldSkipWrite(pObject->GetIndirectReference()))
+        if (xref.ShouldSkipWrite(pObject->GetIndirectReference()))
         {
-            // Also make sure that we do not encrypt the encryption dictionary!
-            pObject->Write(device, m_eWriteMode, pObject == m_pEncryptObj ? nullptr : m_pEncrypt.get());
+            // The object is written by the XRef itself after all
+            // the others, so its offset is known only at the end
+            skippedObjects.push_back(pObject->GetIndirectReference());
+            continue;
         }
+
+        xref.AddInUseObject( pObject->GetIndirectReference(), device.Tell());
+
+        // Also make sure that we do not encrypt the encryption dictionary!
+        pObject->Write(device, m_eWriteMode, pObject == m_pEncryptObj ? nullptr : m_pEncrypt.get());
     }
 
+    for (auto& skippedObjectRef : skippedObjects)
+        xref.AddInUseObject(skippedObjectRef, device.Tell());
+
     for(auto& freeObjectRef : vecObjects.GetFreeObjects())
     {
         xref.AddFreeObject(freeObjectRef);
     }
 }
 
+void PdfWriter::createObjectStreams(PdfXRef& xref)
+{
+    // Collect the objects first, since the object
+    // streams are added to the same vector.
+    // NOTE: Objects with a stream, with a generation number
+    // other than zero and the encryption dictionary can't
+    // be stored in an object stream (ISO 32000-1:2008 7.5.7)
+    vector<PdfObject*> objects;
+    for (PdfObject* pObject : *m_vecObjects)
+    {
+        if (pObject->GetIndirectReference().GenerationNumber() != 0
+            || pObject == m_pEncryptObj
+            || xref.ShouldSkipWrite(pObject->GetIndirectReference())
+            || pObject->HasStream())
+        {
+            continue;
+        }
+
+        objects.push_back(pObject);
+    }
+
+    m_compressedObjects.reserve(objects.size());
+    for (size_t i = 0; i < objects.size(); i += OBJECT_STREAM_MAX_OBJECTS)
+    {
+        size_t nCount = std::min(objects.size() - i, (size_t)OBJECT_STREAM_MAX_OBJECTS);
+        // Compressed entries imply a generation number of zero
+        // for the object stream, so free object numbers can't be reused
+        uint32_t nObjStmNo = static_cast<uint32_t>(m_vecObjects->GetObjectCount());
+        PdfObject* pObjStm = new PdfObject(PdfDictionary());
+        pObjStm->GetDictionary().AddKey(PdfName::KeyType, PdfName("ObjStm"));
+        m_vecObjects->PushObject(PdfReference(nObjStmNo, 0), pObjStm);
+        m_vecObjectStreams.push_back(pObjStm);
+
+        // The stream starts with pairs of object numbers and
+        // offsets, followed by the objects without "obj" keywords.
+        // Objects are not encrypted, as the whole stream is
+        PdfRefCountedBuffer header;
+        PdfRefCountedBuffer body;
+        PdfOutputDevice headerDevice(&header);
+        PdfOutputDevice bodyDevice(&body);
+        bodyDevice.SetRealPrecision(m_nRealPrecision);
+        char buffer[utls::FormatBufferSize];
+        for (size_t j = 0; j < nCount; j++)
+        {
+            PdfObject* pObject = objects[i + j];
+            headerDevice.Write(utls::FormatTo(buffer, static_cast<int64_t>(pObject->GetIndirectReference().ObjectNumber())));
+            headerDevice.Write(" ", 1);
+            headerDevice.Write(utls::FormatTo(buffer, static_cast<int64_t>(bodyDevice.Tell())));
+            headerDevice.Write(" ", 1);
+            pObject->GetVariant().Write(bodyDevice, m_eWriteMode, nullptr);
+            bodyDevice.Print("\n");
+            pObject->ResetDirty();
+
+            m_compressedObjects[pObject->GetIndirectReference().ObjectNumber()] =
+                PdfXRefEntry::CreateCompressed(nObjStmNo, static_cast<unsigned>(j));
+        }
+
+        pObjStm->GetDictionary().AddKey("N", static_cast<int64_t>(nCount));
+        pObjStm->GetDictionary().AddKey("First", static_cast<int64_t>(headerDevice.GetLength()));
+
+        PdfStream& stream = pObjStm->GetOrCreateStream();
+        stream.BeginAppend();
+        stream.Append(header.GetBuffer(), headerDevice.GetLength());
+        stream.Append(body.GetBuffer(), bodyDevice.GetLength());
+        stream.EndAppend();
+    }
+}
+
+void PdfWriter::encodeStreamsParallel()
+{
+    // Streams larger than two blocks are split, if enabled
+    const size_t FlateBlockSize = 1024 * 1024;
+    bool bSplit = (m_saveOptions & PdfSaveOptions::SplitFlateStreams) == PdfSaveOptions::SplitFlateStreams;
+
+    // A task encodes either a whole stream, or a block of a stream
+    // that is split when all of its blocks have been encoded
+    struct EncodeTask
+    {
+        PdfMemStream* Stream;
+        int Split;              ///< Index in splitStreams, -1 if not split
+        size_t Block;
+        exception_ptr Error;
+    };
+    vector<EncodeTask> tasks;
+    vector<PdfMemStream*> splitStreams;
+    vector<vector<PdfFlateRawBlock>> splitBlocks;
+    for (PdfObject* pObject : *m_vecObjects)
+    {
+        // Load delayed streams on this thread, as the
+        // workers must touch only the stream buffers
+        if ((m_bIncrementalUpdate && !pObject->IsDirty()) || !pObject->HasStream())
+            continue;
+
+        PdfMemStream* pStream = dynamic_cast<PdfMemStream*>(pObject->GetStream());
+        if (pStream == nullptr || !pStream->hasPendingEncoding())
+            continue;
+
+        if (!bSplit || pStream->m_lLength <= 2 * FlateBlockSize
+            || pStream->m_vecPendingFilters.size() != 1
+            || pStream->m_vecPendingFilters[0] != EPdfFilter::FlateDecode
+            || pStream->m_pendingFlateSettings.Predictor != EPdfPredictor::None)
+        {
+            tasks.push_back({ pStream, -1, 0, exception_ptr() });
+            continue;
+        }
+
+        int nSplit = static_cast<int>(splitStreams.size());
+        splitStreams.push_back(pStream);
+        splitBlocks.emplace_back();
+        auto& blocks = splitBlocks.back();
+        for (size_t lOffset = 0; lOffset < pStream->m_lLength; lOffset += FlateBlockSize)
+        {
+            tasks.push_back({ pStream, nSplit, blocks.size(), exception_ptr() });
+            blocks.push_back({ lOffset, std::min(FlateBlockSize, pStream->m_lLength - lOffset), string(), 0 });
+        }
+    }
+
+    if (tasks.size() == 0)
+        return;
+
+    unsigned nThreads = m_nCompressionThreadCount == 0 ? thread::hardware_concurrency() : m_nCompressionThreadCount;
+    nThreads = std::max(1u, std::min(nThreads, static_cast<unsigned>(tasks.size())));
+    atomic<size_t> nextTask(0);
+    auto encode = [&]()
+    {
+        for (;;)
+        {
+            size_t i = nextTask.fetch_add(1);
+            if (i >= tasks.size())
+                return;
+
+            EncodeTask& task = tasks[i];
+            try
+            {
+                if (task.Split == -1)
+                {
+                    task.Stream->encodePendingImpl();
+                }
+                else
+                {
+                    auto& blocks = splitBlocks[task.Split];
+                    PdfFlateFilter::EncodeRawBlock(task.Stream->m_pendingFlateSettings, task.Stream->m_buffer.GetBuffer(),
+                        task.Block == blocks.size() - 1, blocks[task.Block]);
+                }
+            }
+            catch (...)
+            {
+                // Rethrown on the calling thread
+                task.Error = current_exception();
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (unsigned i = 1; i < nThreads; i++)
+        workers.push_back(thread(encode));
+
+    // The calling thread is a worker too
+    encode();
+    for (auto& worker : workers)
+        worker.join();
+
+    for (auto& task : tasks)
+    {
+        if (task.Error != nullptr)
+            rethrow_exception(task.Error);
+    }
+
+    for (size_t i = 0; i < splitStreams.size(); i++)
+    {
+        PdfMemStream* pStream = splitStreams[i];
+        PdfRefCountedBuffer buffer;
+        PdfBufferOutputStream bufferStream(&buffer);
+        PdfFlateFilter::WriteRawBlocks(pStream->m_pendingFlateSettings, splitBlocks[i], bufferStream);
+        bufferStream.Close();
+        pStream->setEncoded(buffer, bufferStream.GetLength());
+    }
+}
+
+void PdfWriter::removeObjectStreams()
+{
+    // NOTE: Don't mark the numbers as free, but restore the
+    // object count: the object streams took the numbers following
+    // the ones in use, so the document is left as it was before writing
+    if (m_vecObjectStreams.size() != 0)
+    {
+        uint32_t nFirstObjStmNo = m_vecObjectStreams.front()->GetIndirectReference().ObjectNumber();
+        for (PdfObject* pObjStm : m_vecObjectStreams)
+            m_vecObjects->RemoveObject(pObjStm->GetIndirectReference(), false);
+
+        m_vecObjects->m_nObjectCount = nFirstObjStmNo;
+    }
+
+    m_vecObjectStreams.clear();
+    m_compressedObjects.clear();
+}
+
 void PdfWriter::FillTrailerObject( PdfObject& trailer, size_t lSize, bool bOnlySizeKey ) const
 {
     trailer.GetDictionary().AddKey( PdfName::KeySize, static_cast<int64_t>(lSize) );
@@ -330,10 +612,12 @@ void PdfWriter::CreateFileIdentifier(PdfString& identifier, const PdfObject& pTr
     }
 
     pInfo->GetDictionary().AddKey("Location", PdfString("SOMEFILENAME"));
+    length.SetRealPrecision(m_nRealPrecision);
     pInfo->Write(length, m_eWriteMode, nullptr);
 
     PdfRefCountedBuffer buffer(length.GetLength());
     PdfOutputDevice device(&buffer);
+    device.SetRealPrecision(m_nRealPrecision);
     pInfo->Write(device, m_eWriteMode, nullptr);
 
     // calculate the MD5 Sum
@@ -43,6 +43,9 @@
 #include "PdfObject.h"
 
 #include "PdfEncrypt.h"
+#include "PdfXRefEntry.h"
+
+#include <unordered_map>
 
 namespace PoDoFo {
 
@@ -110,8 +113,32 @@ public:
      */
     const char* GetPdfVersionString() const;
 
+    /** Set the options to use when writing the PDF.
+     *  PdfSaveOptions::ObjectStreams enables a XRef stream and
+     *  is ignored when writing an incremental update.
+     *  \param saveOptions save options
+     */
     inline void SetSaveOptions(PdfSaveOptions saveOptions) { m_saveOptions = saveOptions; }
 
+    /**
+     *  \returns the options used when writing the PDF
+     */
+    inline PdfSaveOptions GetSaveOptions() const { return m_saveOptions; }
+
+    /** Set the number of threads used to encode the streams
+     *  when writing with PdfSaveOptions::ParallelCompression.
+     *  Default is 0, which uses one thread per hardware thread.
+     *
+     *  \param nThreads number of threads, the calling thread included
+     */
+    inline void SetCompressionThreadCount(unsigned nThreads) { m_nCompressionThreadCount = nThreads; }
+
+    /**
+     *  \returns the number of threads used to encode the streams
+     *  \see SetCompressionThreadCount
+     */
+    inline unsigned GetCompressionThreadCount() const { return m_nCompressionThreadCount; }
+
     /** Set the write mode to use when writing the PDF.
      *  \param eWriteMode write mode
      */
@@ -122,6 +149,21 @@ public:
      */
     inline EPdfWriteMode GetWriteMode() const { return m_eWriteMode; }
 
+    /** Set the number of decimal digits used when writing real
+     *  numbers. It is applied to the output device by Write().
+     *  Lower values produce smaller files, at the cost of accuracy.
+     *  The default is 6 and the maximum is 20
+     *
+     *  \param nPrecision the number of decimal digits
+     */
+    void SetRealPrecision(unsigned short nPrecision);
+
+    /**
+     *  \returns the number of decimal digits used when writing real numbers
+     *  \see SetRealPrecision
+     */
+    inline unsigned short GetRealPrecision() const { return m_nRealPrecision; }
+
     /** Set the PDF Version of the document. Has to be called before Write() to
      *  have an effect.
      *  \param eVersion  version of the pdf document
@@ -207,6 +249,29 @@ protected:
     const PdfString & GetIdentifier() { return m_identifier; }
     void SetIdentifier(const PdfString &identifier) { m_identifier = identifier; }
     void SetEncryptObj(PdfObject* obj);
+private:
+    /** Pack all the objects that can be compressed into
+     *  new object streams, which are written in place of them
+     *  \param xref the XRef that will be written
+     */
+    void createObjectStreams(PdfXRef& xref);
+
+    /** Remove the object streams created by createObjectStreams
+     */
+    void removeObjectStreams();
+
+    /** Remove the objects created only for writing, i.e. the
+     *  object streams and the encryption dictionary
+     */
+    void cleanupWrite();
+
+    /** Encode the memory streams that will be written and whose
+     *  encoding was deferred, on a pool of threads
+     *
+     *  \see PdfSaveOptions::ParallelCompression
+     */
+    void encodeStreamsParallel();
+
 private:
     PdfVecObjects*  m_vecObjects;
     PdfObject m_Trailer;
@@ -217,8 +282,13 @@ private:
     std::unique_ptr<PdfEncrypt> m_pEncrypt;    ///< If not nullptr encrypt all strings and streams and create an encryption dictionary in the trailer
     PdfObject* m_pEncryptObj; ///< Used to temporarly store the encryption dictionary
 
+    std::vector<PdfObject*> m_vecObjectStreams; ///< Used to temporarly store the created object streams
+    std::unordered_map<uint32_t, PdfXRefEntry> m_compressedObjects; ///< Compressed entries of the objects stored in object streams
+
     PdfSaveOptions  m_saveOptions;
+    unsigned        m_nCompressionThreadCount;
     EPdfWriteMode   m_eWriteMode;
+    unsigned short  m_nRealPrecision;
 
     PdfString       m_identifier;
     PdfString       m_originalIdentifier; // used for incremental update
@@ -57,7 +57,15 @@ PdfXRef::~PdfXRef() { }
 
 void PdfXRef::AddInUseObject(const PdfReference& ref, optional<uint64_t> offset)
 {
-    AddObject(ref, offset, true);
+    if (offset.has_value())
+        AddObject(ref, PdfXRefEntry::CreateInUse(*offset, ref.GenerationNumber()), true);
+    else
+        AddObject(ref, std::nullopt, true);
+}
+
+void PdfXRef::AddCompressedObject(const PdfReference& ref, uint32_t nStreamObjNo, unsigned nIndex)
+{
+    AddObject(ref, PdfXRefEntry::CreateCompressed(nStreamObjNo, nIndex), true);
 }
 
 void PdfXRef::AddFreeObject(const PdfReference& ref)
@@ -65,12 +73,12 @@ void PdfXRef::AddFreeObject(const PdfReference& ref)
     AddObject(ref, std::nullopt, false);
 }
 
-void PdfXRef::AddObject(const PdfReference& ref, optional<uint64_t> offset, bool inUse)
+void PdfXRef::AddObject(const PdfReference& ref, const optional<PdfXRefEntry>& entry, bool inUse)
 {
     if (ref.ObjectNumber() > m_maxObjNum)
         m_maxObjNum = ref.ObjectNumber();
 
-    if (inUse && offset == std::nullopt)
+    if (inUse && entry == std::nullopt)
     {
         // Objects with no offset provided will not be written
         // in the entry list
@@ -81,7 +89,7 @@ void PdfXRef::AddObject(const PdfReference& ref, optional<uint64_t> offset, bool
 
     for (auto &block : m_vecBlocks)
     {
-        if(block.InsertItem(ref, offset, inUse) )
+        if(block.InsertItem(ref, entry, inUse) )
         {
             insertDone = true;
             break;
@@ -94,7 +102,7 @@ void PdfXRef::AddObject(const PdfReference& ref, optional<uint64_t> offset, bool
         block.First = ref.ObjectNumber();
         block.Count = 1;
         if( inUse )
-            block.Items.push_back(XRefItem(ref, offset.value()));
+            block.Items.push_back(XRefItem(ref, entry.value()));
         else
             block.FreeItems.push_back( ref );
 
@@ -156,7 +164,7 @@ void PdfXRef::Write(PdfOutputDevice& device)
                 ++itFree;
             }
 
-            this->WriteXRefEntry(device, PdfXRefEntry::CreateInUse(itItems->Offset, itItems->Reference.GenerationNumber()));
+            this->WriteXRefEntry(device, itItems->Entry);
             ++itItems;
         }
 
@@ -338,16 +346,16 @@ bool PdfXRef::ShouldSkipWrite(const PdfReference& ref)
     return false;
 }
 
-bool PdfXRef::PdfXRefBlock::InsertItem(const PdfReference& ref, std::optional<uint64_t> offset, bool inUse)
+bool PdfXRef::PdfXRefBlock::InsertItem(const PdfReference& ref, const std::optional<PdfXRefEntry>& entry, bool inUse)
 {
-    PODOFO_ASSERT(!inUse || offset.has_value());
+    PODOFO_ASSERT(!inUse || entry.has_value());
     if (ref.ObjectNumber() == First + Count)
     {
         // Insert at back
         Count++;
 
         if (inUse)
-            Items.push_back(XRefItem(ref, offset.value()));
+            Items.push_back(XRefItem(ref, entry.value()));
         else
             FreeItems.push_back(ref);
 
@@ -361,7 +369,7 @@ bool PdfXRef::PdfXRefBlock::InsertItem(const PdfReference& ref, std::optional<ui
 
         // This is known to be slow, but should not occur actually
         if (inUse)
-            Items.insert(Items.begin(), XRefItem(ref, offset.value()));
+            Items.insert(Items.begin(), XRefItem(ref, entry.value()));
         else
             FreeItems.insert(FreeItems.begin(), ref);
 
@@ -375,7 +383,7 @@ bool PdfXRef::PdfXRefBlock::InsertItem(const PdfReference& ref, std::optional<ui
 
         if (inUse)
         {
-            Items.push_back(XRefItem(ref, offset.value()));
+            Items.push_back(XRefItem(ref, entry.value()));
             std::sort(Items.begin(), Items.end());
         }
         else
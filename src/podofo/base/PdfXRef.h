@@ -58,11 +58,11 @@ class PdfXRef
  protected:
     struct XRefItem
     {
-        XRefItem( const PdfReference & rRef, uint64_t off ) 
-            : Reference( rRef ), Offset( off ) { }
+        XRefItem( const PdfReference & rRef, const PdfXRefEntry & rEntry )
+            : Reference( rRef ), Entry( rEntry ) { }
 
         PdfReference Reference;
-        uint64_t Offset;
+        PdfXRefEntry Entry;
 
         bool operator<( const XRefItem & rhs ) const
         {
@@ -85,7 +85,7 @@ class PdfXRef
 
         PdfXRefBlock(const PdfXRefBlock& rhs) = default;
         
-        bool InsertItem(const PdfReference& rRef, std::optional<uint64_t> offset, bool bUsed );
+        bool InsertItem(const PdfReference& rRef, const std::optional<PdfXRefEntry>& entry, bool bUsed );
 
         bool operator<( const PdfXRefBlock & rhs ) const
         {
@@ -120,6 +120,15 @@ public:
      */
     void AddInUseObject(const PdfReference& rRef, std::optional<uint64_t> offset);
 
+    /** Add an object stored in an object stream to the XRef table.
+     *  Compressed entries can be written only by XRef streams.
+     *
+     *  \param rRef reference of this object
+     *  \param nStreamObjNo object number of the object stream
+     *  \param nIndex index of the object in the object stream
+     */
+    void AddCompressedObject(const PdfReference& rRef, uint32_t nStreamObjNo, unsigned nIndex);
+
     /** Add a free object to the XRef table.
      *  
      *  \param ref reference of this object
@@ -202,7 +211,7 @@ protected:
     virtual void EndWriteImpl(PdfOutputDevice& device);
 
 private:
-    void AddObject(const PdfReference& rRef, std::optional<uint64_t> offset, bool inUse);
+    void AddObject(const PdfReference& rRef, const std::optional<PdfXRefEntry>& entry, bool inUse);
 
     /** Called at the end of writing the XRef table.
      *  Sub classes can overload this method to finish a XRef table.
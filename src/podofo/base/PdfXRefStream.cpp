@@ -82,7 +82,14 @@ bool PdfXRefStream::ShouldSkipWrite(const PdfReference& ref)
 
 void PdfXRefStream::BeginWrite( PdfOutputDevice& )
 {
-    m_xrefStreamObj->GetOrCreateStream().BeginAppend();
+    // The entries are rows of fixed size fields, that
+    // compress much better with the PNG Up predictor
+    PdfStream& stream = m_xrefStreamObj->GetOrCreateStream();
+    PdfFlateSettings settings = stream.GetFlateSettings();
+    settings.Predictor = EPdfPredictor::PngUp;
+    settings.Columns = static_cast<int>(sizeof(XRefStreamEntry));
+    stream.SetFlateSettings( settings );
+    stream.BeginAppend();
 }
 
 void PdfXRefStream::WriteSubSection(PdfOutputDevice&, uint32_t first, uint32_t count )
@@ -100,15 +107,21 @@ void PdfXRefStream::WriteXRefEntry(PdfOutputDevice&, const PdfXRefEntry& entry)
     {
     case EXRefEntryType::Free:
         stmEntry.Variant = compat::AsBigEndian(static_cast<uint32_t>(entry.ObjectNumber));
+        stmEntry.Generation = compat::AsBigEndian(static_cast<uint16_t>(entry.Generation));
         break;
     case EXRefEntryType::InUse:
         stmEntry.Variant = compat::AsBigEndian(static_cast<uint32_t>(entry.Offset));
+        stmEntry.Generation = compat::AsBigEndian(static_cast<uint16_t>(entry.Generation));
+        break;
+    case EXRefEntryType::Compressed:
+        // The third field is the index of the object in the object stream
+        stmEntry.Variant = compat::AsBigEndian(static_cast<uint32_t>(entry.ObjectNumber));
+        stmEntry.Generation = compat::AsBigEndian(static_cast<uint16_t>(entry.Index));
         break;
     default:
         PODOFO_RAISE_ERROR(EPdfError::InvalidEnumValue);
     }
 
-    stmEntry.Generation = compat::AsBigEndian(static_cast<uint16_t>(entry.Generation));
     m_xrefStreamObj->GetOrCreateStream().Append((char *)&stmEntry, sizeof(XRefStreamEntry));
 }
 
@@ -0,0 +1,401 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the PoDoFo developers                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License as       *
+ *   published by the Free Software Foundation; either version 2 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this program; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ *   In addition, as a special exception, the copyright holders give       *
+ *   permission to link the code of portions of this program with the      *
+ *   OpenSSL library under certain conditions as described in each         *
+ *   individual source file, and distribute linked combinations            *
+ *   including the two.                                                    *
+ *   You must obey the GNU General Public License in all respects          *
+ *   for all of the code used other than OpenSSL.  If you modify           *
+ *   file(s) with this exception, you may extend this exception to your    *
+ *   version of the file(s), but you are not obligated to do so.  If you   *
+ *   do not wish to do so, delete this exception statement from your       *
+ *   version.  If you delete this exception statement from all source      *
+ *   files in the program, then also delete it here.                       *
+ ***************************************************************************/
+
+#include "PdfDecodedStreamCache.h"
+
+#include "base/PdfDefinesPrivate.h"
+
+#include "base/PdfArray.h"
+#include "base/PdfDictionary.h"
+#include "base/PdfFilter.h"
+#include "base/PdfMemStream.h"
+#include "base/PdfObject.h"
+#include "base/PdfOutputStream.h"
+
+#include "PdfDocument.h"
+#include "PdfPage.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+namespace PoDoFo {
+
+namespace
+{
+    /** Collects the decoded data of a stream in a string
+     */
+    class StringOutputStream : public PdfOutputStream
+    {
+    public:
+        StringOutputStream( string& rStr )
+            : m_rStr( rStr )
+        {
+        }
+
+        void Close() override
+        {
+        }
+
+    protected:
+        void WriteImpl( const char* pBuffer, size_t lLen ) override
+        {
+            m_rStr.append( pBuffer, lLen );
+        }
+
+    private:
+        string& m_rStr;
+    };
+
+    /** What is needed to decode a stream, gathered on the
+     *  calling thread: the decoding reads nothing else, so
+     *  it can run on any thread
+     */
+    struct DecodeTask
+    {
+        PdfReference Reference;
+        const PdfStream* Stream;
+        TVecFilters Filters;
+        PdfDictionary Parms;    ///< A copy of /DecodeParms with references resolved, if any
+        const char* Buffer;
+        size_t Length;
+    };
+
+    void prepareDecode( const PdfObject& rObject, DecodeTask& rTask )
+    {
+        const PdfMemStream& rStream = static_cast<const PdfMemStream&>( *rObject.GetStream() );
+        rTask.Stream = &rStream;
+        rTask.Filters = PdfFilterFactory::CreateFilterList( &rObject );
+        rTask.Buffer = rStream.Get();
+        rTask.Length = rStream.GetLength();
+
+        // Filters look up the parameters in the /DecodeParms
+        // key, as PdfFilterFactory::CreateDecodeStream does
+        const PdfObject* pParms = rObject.GetDictionary().GetKey( "DecodeParms" );
+        if( pParms == nullptr || !pParms->IsDictionary() )
+            return;
+
+        PdfDictionary parms;
+        const PdfDictionary& rParms = pParms->GetDictionary();
+        for( auto& pair : rParms )
+            parms.AddKey( pair.first, *rParms.FindKey( pair.first ) );
+
+        rTask.Parms.AddKey( "DecodeParms", parms );
+    }
+
+    shared_ptr<const string> decode( const DecodeTask& rTask )
+    {
+        shared_ptr<string> pData = make_shared<string>();
+        StringOutputStream stream( *pData );
+        if( rTask.Filters.size() == 0 )
+        {
+            stream.Write( rTask.Buffer, rTask.Length );
+            return pData;
+        }
+
+        auto pDecodeStream = PdfFilterFactory::CreateDecodeStream( rTask.Filters, stream, &rTask.Parms );
+        pDecodeStream->Write( rTask.Buffer, rTask.Length );
+        pDecodeStream->Close();
+        return pData;
+    }
+}
+
+PdfDecodedStreamCache::PdfDecodedStreamCache( PdfDocument& rDocument, size_t lMaxSize )
+    : m_pDocument( &rDocument ), m_lMaxSize( lMaxSize ), m_lSize( 0 )
+{
+    m_pDocument->GetObjects().Attach( this );
+}
+
+PdfDecodedStreamCache::~PdfDecodedStreamCache()
+{
+    m_pDocument->GetObjects().Detach( this );
+}
+
+void PdfDecodedStreamCache::Decode( const vector<PdfReference>& refs, unsigned nThreads )
+{
+    // Load the streams, their filters and decode parameters on
+    // the calling thread, as that may load objects of the document.
+    // The workers only read the stream buffers and the copies
+    list<DecodeTask> lstTasks;
+    for( const PdfReference& rRef : refs )
+    {
+        if( m_mapEntries.find( rRef ) != m_mapEntries.end() )
+            continue;
+
+        const PdfObject* pObject = getStreamObject( rRef );
+        if( pObject == nullptr )
+            continue;
+
+        lstTasks.emplace_back();
+        try
+        {
+            lstTasks.back().Reference = rRef;
+            prepareDecode( *pObject, lstTasks.back() );
+        }
+        catch( ... )
+        {
+            // Skipped, GetDecoded() will report the error
+            lstTasks.pop_back();
+        }
+    }
+
+    if( lstTasks.size() == 0 )
+        return;
+
+    vector<const DecodeTask*> vecTasks;
+    for( const DecodeTask& rTask : lstTasks )
+        vecTasks.push_back( &rTask );
+
+    vector<shared_ptr<const string>> vecDecoded( vecTasks.size() );
+    if( nThreads == 0 )
+        nThreads = thread::hardware_concurrency();
+    nThreads = std::max( 1u, std::min( nThreads, static_cast<unsigned>(vecTasks.size()) ) );
+    atomic<size_t> nextStream( 0 );
+    auto decodeStreams = [&]()
+    {
+        for( ;; )
+        {
+            size_t i = nextStream.fetch_add( 1 );
+            if( i >= vecTasks.size() )
+                return;
+
+            try
+            {
+                vecDecoded[i] = decode( *vecTasks[i] );
+            }
+            catch( ... )
+            {
+                // Skipped, GetDecoded() will report the error
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for( unsigned i = 1; i < nThreads; i++ )
+        workers.push_back( thread( decodeStreams ) );
+
+    // The calling thread is a worker too
+    decodeStreams();
+    for( auto& worker : workers )
+        worker.join();
+
+    for( size_t i = 0; i < vecTasks.size(); i++ )
+    {
+        if( vecDecoded[i] != nullptr )
+            add( vecTasks[i]->Reference, vecTasks[i]->Stream, vecDecoded[i] );
+    }
+}
+
+void PdfDecodedStreamCache::DecodePages( int nFirstPage, int nPageCount, unsigned nThreads )
+{
+    if( nFirstPage < 0 || nPageCount < 0 || nFirstPage + nPageCount > m_pDocument->GetPageCount() )
+        PODOFO_RAISE_ERROR( EPdfError::ValueOutOfRange );
+
+    vector<PdfReference> refs;
+    TPdfReferenceSet visited;
+    for( int i = nFirstPage; i < nFirstPage + nPageCount; i++ )
+    {
+        PdfPage* pPage = m_pDocument->GetPage( i );
+        PdfObject* pContents = pPage->GetContents();
+        if( pContents != nullptr && pContents->IsArray() )
+        {
+            PdfArray& rArray = pContents->GetArray();
+            for( size_t j = 0; j < rArray.GetSize(); j++ )
+                collectPageStreams( &rArray.FindAt( j ), refs, visited );
+        }
+        else
+        {
+            collectPageStreams( pContents, refs, visited );
+        }
+
+        collectPageStreams( pPage->GetResources(), refs, visited );
+    }
+
+    Decode( refs, nThreads );
+}
+
+void PdfDecodedStreamCache::collectPageStreams( PdfObject* pObject, vector<PdfReference>& refs, TPdfReferenceSet& visited ) const
+{
+    if( pObject == nullptr || !pObject->IsDictionary() )
+        return;
+
+    // Content streams and form XObjects are indirect objects, resource
+    // dictionaries may be direct objects with no reference
+    const PdfReference& rRef = pObject->GetIndirectReference();
+    if( rRef.IsIndirect() )
+    {
+        if( !visited.insert( rRef ).second )
+            return;
+
+        if( pObject->HasStream() )
+            refs.push_back( rRef );
+    }
+
+    // Follow the form XObjects of the resources, also
+    // the ones nested in the resources of other forms
+    PdfDictionary& rDict = pObject->GetDictionary();
+    PdfObject* pResources = rDict.FindKey( "Resources" );
+    PdfObject* pXObjects = rDict.FindKey( "XObject" );
+    if( pResources != nullptr )
+        collectPageStreams( pResources, refs, visited );
+
+    if( pXObjects == nullptr || !pXObjects->IsDictionary() )
+        return;
+
+    for( auto& pair : pXObjects->GetDictionary() )
+    {
+        PdfObject* pXObject = pXObjects->GetDictionary().FindKey( pair.first );
+        if( pXObject == nullptr || !pXObject->IsDictionary() )
+            continue;
+
+        PdfObject* pSubtype = pXObject->GetDictionary().FindKey( PdfName::KeySubtype );
+        if( pSubtype != nullptr && pSubtype->IsName() && pSubtype->GetName() == "Form" )
+            collectPageStreams( pXObject, refs, visited );
+    }
+}
+
+shared_ptr<const string> PdfDecodedStreamCache::GetDecoded( const PdfReference& rRef )
+{
+    auto found = m_mapEntries.find( rRef );
+    if( found != m_mapEntries.end() )
+    {
+        // Move the entry to the front, as the most recently used
+        m_lstEntries.splice( m_lstEntries.begin(), m_lstEntries, found->second );
+        return found->second->Data;
+    }
+
+    const PdfObject* pObject = getStreamObject( rRef );
+    if( pObject == nullptr )
+        return nullptr;
+
+    DecodeTask task;
+    task.Reference = rRef;
+    prepareDecode( *pObject, task );
+    shared_ptr<const string> pData = decode( task );
+    add( rRef, task.Stream, pData );
+    return pData;
+}
+
+void PdfDecodedStreamCache::Remove( const PdfReference& rRef )
+{
+    auto found = m_mapEntries.find( rRef );
+    if( found != m_mapEntries.end() )
+        remove( found->second );
+}
+
+void PdfDecodedStreamCache::Clear()
+{
+    m_lstEntries.clear();
+    m_mapEntries.clear();
+    m_mapStreams.clear();
+    m_lSize = 0;
+}
+
+void PdfDecodedStreamCache::SetMaxSize( size_t lMaxSize )
+{
+    m_lMaxSize = lMaxSize;
+    evict( m_lMaxSize );
+}
+
+const PdfObject* PdfDecodedStreamCache::getStreamObject( const PdfReference& rRef ) const
+{
+    PdfObject* pObject = m_pDocument->GetObjects().GetObject( rRef );
+    if( pObject == nullptr || !pObject->HasStream() )
+        return nullptr;
+
+    // Only the data of memory streams can be read back
+    const PdfStream* pStream = pObject->GetStream();
+    if( dynamic_cast<const PdfMemStream*>( pStream ) == nullptr )
+        return nullptr;
+
+    // Querying the length also encodes data whose encoding was deferred
+    (void)pStream->GetLength();
+    return pObject;
+}
+
+void PdfDecodedStreamCache::add( const PdfReference& rRef, const PdfStream* pStream, const shared_ptr<const string>& pData )
+{
+    Remove( rRef );
+
+    // Data larger than the budget is returned but not cached
+    if( pData->size() > m_lMaxSize )
+        return;
+
+    evict( m_lMaxSize - pData->size() );
+    m_lstEntries.push_front( { rRef, pStream, pData } );
+    m_mapEntries[rRef] = m_lstEntries.begin();
+    m_mapStreams[pStream] = rRef;
+    m_lSize += pData->size();
+}
+
+void PdfDecodedStreamCache::remove( TCacheList::iterator it )
+{
+    m_lSize -= it->Data->size();
+    m_mapEntries.erase( it->Reference );
+    m_mapStreams.erase( it->Stream );
+    m_lstEntries.erase( it );
+}
+
+void PdfDecodedStreamCache::evict( size_t lMaxSize )
+{
+    while( m_lSize > lMaxSize )
+        remove( std::prev( m_lstEntries.end() ) );
+}
+
+void PdfDecodedStreamCache::WriteObject( const PdfObject* )
+{
+}
+
+void PdfDecodedStreamCache::BeginAppendStream( const PdfStream* pStream )
+{
+    // The stream is being changed
+    auto found = m_mapStreams.find( pStream );
+    if( found != m_mapStreams.end() )
+        Remove( found->second );
+}
+
+void PdfDecodedStreamCache::EndAppendStream( const PdfStream* )
+{
+}
+
+void PdfDecodedStreamCache::Finish()
+{
+}
+
+void PdfDecodedStreamCache::ObjectRemoved( const PdfObject* pObject )
+{
+    // The stream is destroyed with the object, or belongs to the caller
+    Remove( pObject->GetIndirectReference() );
+}
+
+};
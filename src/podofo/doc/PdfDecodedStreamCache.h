@@ -0,0 +1,178 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the PoDoFo developers                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License as       *
+ *   published by the Free Software Foundation; either version 2 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this program; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ *   In addition, as a special exception, the copyright holders give       *
+ *   permission to link the code of portions of this program with the      *
+ *   OpenSSL library under certain conditions as described in each         *
+ *   individual source file, and distribute linked combinations            *
+ *   including the two.                                                    *
+ *   You must obey the GNU General Public License in all respects          *
+ *   for all of the code used other than OpenSSL.  If you modify           *
+ *   file(s) with this exception, you may extend this exception to your    *
+ *   version of the file(s), but you are not obligated to do so.  If you   *
+ *   do not wish to do so, delete this exception statement from your       *
+ *   version.  If you delete this exception statement from all source      *
+ *   files in the program, then also delete it here.                       *
+ ***************************************************************************/
+
+#ifndef _PDF_DECODED_STREAM_CACHE_H_
+#define _PDF_DECODED_STREAM_CACHE_H_
+
+#include "podofo/base/PdfDefines.h"
+#include "podofo/base/PdfReference.h"
+#include "podofo/base/PdfVecObjects.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PoDoFo {
+
+class PdfDocument;
+class PdfObject;
+class PdfStream;
+
+/** A cache of decoded stream data of a document, keyed by
+ *  object reference and bounded by a memory budget. The least
+ *  recently used streams are evicted when the budget is exceeded.
+ *
+ *  Streams can be decoded in advance on a pool of threads with
+ *  Decode() or DecodePages(), e.g. before extracting the text of
+ *  a range of pages, so that streams shared by many pages (like
+ *  form XObjects) are decoded only once.
+ *
+ *  The cache observes the document and drops the data of streams
+ *  that are changed or whose objects are removed. It must be used
+ *  from one thread at a time, as the document, and must be destroyed
+ *  before the document.
+ *  The returned data is immutable and can be used on any thread,
+ *  also after being evicted.
+ */
+class PODOFO_DOC_API PdfDecodedStreamCache : private PdfVecObjects::Observer
+{
+public:
+    static constexpr size_t DefaultMaxSize = 64 * 1024 * 1024;
+
+    /** Create a cache for the streams of a document
+     *  \param rDocument the document whose streams are decoded
+     *  \param lMaxSize memory budget in bytes for the decoded data
+     */
+    PdfDecodedStreamCache( PdfDocument& rDocument, size_t lMaxSize = DefaultMaxSize );
+
+    ~PdfDecodedStreamCache();
+
+    /** Decode the streams of a list of objects on a pool of threads
+     *  and store them in the cache. Objects that are missing, without
+     *  a stream, already cached or that fail to decode are skipped.
+     *
+     *  \param refs references of the objects to decode
+     *  \param nThreads number of threads, the calling thread included.
+     *         0 uses one thread per hardware thread
+     */
+    void Decode( const std::vector<PdfReference>& refs, unsigned nThreads = 0 );
+
+    /** Decode the content streams of a range of pages and the form
+     *  XObjects they use, as Decode() does
+     *
+     *  \param nFirstPage index of the first page
+     *  \param nPageCount number of pages, starting from nFirstPage
+     *  \param nThreads number of threads, 0 uses one per hardware thread
+     */
+    void DecodePages( int nFirstPage, int nPageCount, unsigned nThreads = 0 );
+
+    /** Get the decoded data of an object's stream, decoding
+     *  it on the calling thread if it is not cached
+     *
+     *  \param rRef reference of the object
+     *  \returns the decoded data, or nullptr if the object is missing or has no stream in memory
+     */
+    std::shared_ptr<const std::string> GetDecoded( const PdfReference& rRef );
+
+    /** Remove the data of an object's stream from the cache
+     *  \param rRef reference of the object
+     */
+    void Remove( const PdfReference& rRef );
+
+    /** Remove all the data from the cache
+     */
+    void Clear();
+
+    /** Set the memory budget, evicting data if it is exceeded
+     *  \param lMaxSize memory budget in bytes for the decoded data
+     */
+    void SetMaxSize( size_t lMaxSize );
+
+    inline size_t GetMaxSize() const { return m_lMaxSize; }
+
+    /**
+     *  \returns the size in bytes of the cached data
+     */
+    inline size_t GetSize() const { return m_lSize; }
+
+    /**
+     *  \returns the number of cached streams
+     */
+    inline size_t GetCount() const { return m_lstEntries.size(); }
+
+private:
+    struct TCacheEntry
+    {
+        PdfReference Reference;
+        const PdfStream* Stream;
+        std::shared_ptr<const std::string> Data;
+    };
+
+    typedef std::list<TCacheEntry> TCacheList;
+
+    PdfDecodedStreamCache( const PdfDecodedStreamCache& ) = delete;
+    PdfDecodedStreamCache& operator=( const PdfDecodedStreamCache& ) = delete;
+
+    /** \returns the object, with its stream loaded and ready to be
+     *   read on any thread, or nullptr if it has no stream in memory
+     */
+    const PdfObject* getStreamObject( const PdfReference& rRef ) const;
+
+    void add( const PdfReference& rRef, const PdfStream* pStream, const std::shared_ptr<const std::string>& pData );
+
+    void remove( TCacheList::iterator it );
+
+    void evict( size_t lMaxSize );
+
+    void collectPageStreams( PdfObject* pObject, std::vector<PdfReference>& refs, TPdfReferenceSet& visited ) const;
+
+private:
+    void WriteObject( const PdfObject* pObject ) override;
+    void BeginAppendStream( const PdfStream* pStream ) override;
+    void EndAppendStream( const PdfStream* pStream ) override;
+    void Finish() override;
+    void ObjectRemoved( const PdfObject* pObject ) override;
+
+private:
+    PdfDocument* m_pDocument;
+    size_t m_lMaxSize;
+    size_t m_lSize;
+    TCacheList m_lstEntries;    ///< Most recently used first
+    std::map<PdfReference, TCacheList::iterator> m_mapEntries;
+    std::map<const PdfStream*, PdfReference> m_mapStreams;
+};
+
+};
+
+#endif // _PDF_DECODED_STREAM_CACHE_H_
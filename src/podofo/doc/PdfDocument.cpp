@@ -541,15 +541,15 @@ void PdfDocument::FixObjectReferences( PdfObject* pObject, int difference )
 
         while( it != pObject->GetDictionary().end() )
         {
-            if( it->second.IsReference() )
+            if( it->second->IsReference() )
             {
-                it->second = PdfObject(PdfReference( it->second.GetReference().ObjectNumber() + difference,
-                                              it->second.GetReference().GenerationNumber() ));
+                *it->second = PdfObject(PdfReference( it->second->GetReference().ObjectNumber() + difference,
+                                              it->second->GetReference().GenerationNumber() ));
             }
-            else if( it->second.IsDictionary() || 
-                     it->second.IsArray() )
+            else if( it->second->IsDictionary() || 
+                     it->second->IsArray() )
             {
-                FixObjectReferences( &it->second, difference );
+                FixObjectReferences( it->second.get(), difference );
             }
 
             ++it;
@@ -41,6 +41,7 @@
 #include "base/PdfEncoding.h"
 #include "base/PdfInputStream.h"
 #include "base/PdfStream.h"
+#include "base/PdfStringStream.h"
 #include "base/PdfWriter.h"
 #include "base/PdfLocale.h"
 
@@ -163,6 +164,22 @@ void PdfFont::WriteStringToStream( const PdfString & rsString, ostream& rStream
     podofo_free( pBuffer );
 }
 
+void PdfFont::WriteStringToStream( const PdfString & rsString, PdfStringStream& rStream )
+{
+    PdfRefCountedBuffer buffer = m_pEncoding->ConvertToEncoding( rsString, this );
+    size_t lLen = 0;
+    char* pBuffer = nullptr;
+
+    std::unique_ptr<PdfFilter> pFilter = PdfFilterFactory::Create( EPdfFilter::ASCIIHexDecode );    
+    pFilter->Encode( buffer.GetBuffer(), buffer.GetSize(), &pBuffer, &lLen );
+
+    rStream << '<';
+    rStream.Write( pBuffer, lLen );
+    rStream << '>';
+
+    podofo_free( pBuffer );
+}
+
 // Peter Petrov 5 January 2009
 void PdfFont::EmbedFont()
 {
@@ -45,6 +45,7 @@ namespace PoDoFo {
 
 class PdfObject;
 class PdfPage;
+class PdfStringStream;
 class PdfWriter;
 
 
@@ -216,6 +217,17 @@ class PODOFO_DOC_API PdfFont : public PdfElement {
      */
     virtual void WriteStringToStream( const PdfString & rsString, std::ostream & rStream );
 
+    /** Write a PdfString to a PdfStringStream in a format so that it can
+     *  be used with this font.
+     *  This is used by PdfPainter::DrawText to display a text string.
+     *  The following PDF operator will be Tj
+     *
+     *  \param rsString a unicode or ansi string which will be displayed
+     *  \param rStream the string will be appended to the stream without any leading
+     *                 or following whitespaces.
+     */
+    void WriteStringToStream( const PdfString & rsString, PdfStringStream & rStream );
+
     // Peter Petrov 24 September 2008
     /** Embeds the font into PDF page
      *
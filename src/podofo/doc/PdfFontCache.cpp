@@ -46,6 +46,7 @@
 #include "PdfFontFactory.h"
 #include "PdfFontMetricsFreetype.h"
 #include "PdfFontMetricsBase14.h"
+#include "PdfSharedFontCache.h"
 #include "PdfFontTTFSubset.h"
 #include "PdfFontType1.h"
 
@@ -273,6 +274,34 @@ static bool GetDataFromLPFONT( const LOGFONTA* inFont, char** outFontBuffer, uns
 }
 #endif // WIN32
 
+TFontCacheKey::TFontCacheKey( const std::string& sFontName, bool bBold, bool bItalic, bool bIsSymbolCharset,
+                              const PdfEncoding * const pEncoding )
+    : m_sFontName( sFontName ),
+      m_sEncodingId( pEncoding ? pEncoding->GetID().GetString() : std::string() ),
+      m_bBold( bBold ), m_bItalic( bItalic ), m_bIsSymbolCharset( bIsSymbolCharset )
+{
+}
+
+TFontCacheKey::TFontCacheKey( const TFontCacheElement & rElement )
+    : TFontCacheKey( rElement.m_sFontName.GetStringUtf8(), rElement.m_bBold, rElement.m_bItalic,
+                     rElement.m_bIsSymbolCharset, rElement.m_pEncoding )
+{
+}
+
+bool TFontCacheKey::operator==( const TFontCacheKey & rhs ) const
+{
+    return m_bBold == rhs.m_bBold && m_bItalic == rhs.m_bItalic
+        && m_bIsSymbolCharset == rhs.m_bIsSymbolCharset
+        && m_sFontName == rhs.m_sFontName && m_sEncodingId == rhs.m_sEncodingId;
+}
+
+size_t TFontCacheKeyHash::operator()( const TFontCacheKey & rKey ) const
+{
+    size_t nHash = std::hash<std::string>()( rKey.m_sFontName );
+    nHash ^= std::hash<std::string>()( rKey.m_sEncodingId ) + 0x9e3779b9 + (nHash << 6) + (nHash >> 2);
+    return nHash ^ ( (rKey.m_bBold ? 1 : 0) | (rKey.m_bItalic ? 2 : 0) | (rKey.m_bIsSymbolCharset ? 4 : 0) );
+}
+
 PdfFontCache::PdfFontCache( PdfVecObjects* pParent )
     : m_pParent( pParent )
 {
@@ -315,48 +344,38 @@ void PdfFontCache::Init(void)
 
 void PdfFontCache::EmptyCache() 
 {
-    TISortedFontList itFont = m_vecFonts.begin();
+    TIFontList itFont = m_fonts.m_vecFonts.begin();
 
-    while( itFont != m_vecFonts.end() )
+    while( itFont != m_fonts.m_vecFonts.end() )
     {
         delete (*itFont).m_pFont;
         ++itFont;
     }
 
-    itFont = m_vecFontSubsets.begin();
-    while( itFont != m_vecFontSubsets.end() )
+    itFont = m_fontSubsets.m_vecFonts.begin();
+    while( itFont != m_fontSubsets.m_vecFonts.end() )
     {
         delete (*itFont).m_pFont;
         ++itFont;
     }
 
-    m_vecFonts.clear();
-    m_vecFontSubsets.clear();
+    m_fonts.m_vecFonts.clear();
+    m_fonts.m_mapIndex.clear();
+    m_fonts.m_mapAnyEncoding.clear();
+    m_fontSubsets.m_vecFonts.clear();
+    m_fontSubsets.m_mapIndex.clear();
+    m_fontSubsets.m_mapAnyEncoding.clear();
+    m_mapFontsByRef.clear();
 }
 
 PdfFont* PdfFontCache::GetFont( PdfObject* pObject )
 {
-    TCISortedFontList it = m_vecFonts.begin();
     const PdfReference & ref = pObject->GetIndirectReference(); 
 
-    // Search if the object is a cached normal font
-    while( it != m_vecFonts.end() )
-    {
-        if( (*it).m_pFont->GetObject()->GetIndirectReference() == ref ) 
-            return (*it).m_pFont;
-
-        ++it;
-    }
-
-    // Search if the object is a cached font subset
-    it = m_vecFontSubsets.begin();
-    while( it != m_vecFontSubsets.end() )
-    {
-        if( (*it).m_pFont->GetObject()->GetIndirectReference() == ref ) 
-            return (*it).m_pFont;
-
-        ++it;
-    }
+    // Search if the object is a cached normal font or font subset
+    auto found = m_mapFontsByRef.find( ref );
+    if( found != m_mapFontsByRef.end() )
+        return found->second;
 
     // Create a new font
     PdfFont* pFont = PdfFontFactory::CreateFont( &m_ftLibrary, pObject );
@@ -369,10 +388,7 @@ PdfFont* PdfFontCache::GetFont( PdfObject* pObject )
         element.m_sFontName = pFont->GetFontMetrics()->GetFontname();
         element.m_pEncoding = nullptr;
         element.m_bIsSymbolCharset = pFont->GetFontMetrics()->IsSymbol();
-        m_vecFonts.push_back( element );
-        
-        // Now sort the font list
-        std::sort( m_vecFonts.begin(), m_vecFonts.end() );
+        this->addFont( m_fonts, element );
     }
     
     return pFont;
@@ -385,15 +401,11 @@ PdfFont* PdfFontCache::GetFont( const char* pszFontName, bool bBold, bool bItali
 {
     PODOFO_ASSERT( pEncoding );
 
-    PdfFont*          pFont = nullptr;
     PdfFontMetrics*   pMetrics = nullptr;
-    std::pair<TISortedFontList,TCISortedFontList> it;
-
-    it = std::equal_range( m_vecFonts.begin(), m_vecFonts.end(), 
-               TFontCacheElement( pszFontName, bBold, bItalic, bSymbolCharset, pEncoding ) );
+    PdfFont*          pFont = this->findFont( m_fonts,
+        TFontCacheKey( pszFontName, bBold, bItalic, bSymbolCharset, pEncoding ) );
 
-        
-    if( it.first == it.second )
+    if( pFont == nullptr )
     {
         if ( (eFontCreationFlags & EFontCreationFlags::AutoSelectBase14) == EFontCreationFlags::AutoSelectBase14
              && PODOFO_Base14FontDef_FindBuiltinData(pszFontName) )
@@ -425,9 +437,7 @@ PdfFont* PdfFontCache::GetFont( const char* pszFontName, bool bBold, bool bItali
                 element.m_pEncoding = pEncoding;
                 element.m_bIsSymbolCharset = bSymbolCharset;
 
-                // Do a sorted insert, so no need to sort again
-                //rvecContainer.insert( itSorted, element ); 
-                m_vecFonts.insert( it.first, element );
+                this->addFont( m_fonts, element );
                 
              }
 
@@ -445,20 +455,18 @@ PdfFont* PdfFontCache::GetFont( const char* pszFontName, bool bBold, bool bItali
             if( sPath.empty() )
             {
 #if defined(WIN32) && !defined(PODOFO_NO_FONTMANAGER)
-                pFont = GetWin32Font( it.first, m_vecFonts, pszFontName, bBold, bItalic, bSymbolCharset, bEmbedd, pEncoding, bSubsetting  );
+                pFont = GetWin32Font( m_fonts, pszFontName, bBold, bItalic, bSymbolCharset, bEmbedd, pEncoding, bSubsetting  );
 #endif // WIN32
             }
             else
             {
-                pMetrics = new PdfFontMetricsFreetype( &m_ftLibrary, sPath.c_str(), bSymbolCharset, bSubsetting ? genSubsetBasename() : nullptr );
-                pFont    = this->CreateFontObject( it.first, m_vecFonts, pMetrics, 
+                pMetrics = this->createFontMetrics( sPath, bSymbolCharset, bSubsetting ? genSubsetBasename() : nullptr, false );
+                pFont    = this->CreateFontObject( m_fonts, pMetrics, 
                            bEmbedd, bBold, bItalic, pszFontName, pEncoding, bSubsetting );
             }
 
         }
     }
-    else
-        pFont = (*it.first).m_pFont;
 
 #if !(defined(WIN32) && !defined(PODOFO_NO_FONTMANAGER))
         if (!pFont)
@@ -475,7 +483,6 @@ PdfFont* PdfFontCache::GetFont( const wchar_t* pszFontName, bool bBold, bool bIt
     PODOFO_ASSERT( pEncoding );
 
     PdfFont*          pFont;
-    std::pair<TISortedFontList,TCISortedFontList> it;
 
     size_t lMaxLen = wcslen(pszFontName) * 5;
 
@@ -499,12 +506,9 @@ PdfFont* PdfFontCache::GetFont( const wchar_t* pszFontName, bool bBold, bool bIt
     element.m_pEncoding = pEncoding;
     element.m_sFontName = pmbFontName;
 
-    it = std::equal_range( m_vecFonts.begin(), m_vecFonts.end(), element );
-    
-    if( it.first == it.second )
-        return GetWin32Font( it.first, m_vecFonts, pszFontName, bBold, bItalic, bSymbolCharset, bEmbedd, pEncoding );
-    else
-        pFont = (*it.first).m_pFont;
+    pFont = this->findFont( m_fonts, TFontCacheKey( element ) );
+    if( pFont == nullptr )
+        return GetWin32Font( m_fonts, pszFontName, bBold, bItalic, bSymbolCharset, bEmbedd, pEncoding );
     
     return pFont;
 }
@@ -515,14 +519,11 @@ PdfFont* PdfFontCache::GetFont( const LOGFONTA &logFont,
     PODOFO_ASSERT( pEncoding );
 
     PdfFont*          pFont;
-    std::pair<TISortedFontList,TCISortedFontList> it;
 
-    it = std::equal_range( m_vecFonts.begin(), m_vecFonts.end(), 
-         TFontCacheElement( logFont.lfFaceName, logFont.lfWeight >= FW_BOLD ? true : false, logFont.lfItalic ? true : false, logFont.lfCharSet == SYMBOL_CHARSET, pEncoding ) );
-    if( it.first == it.second )
-        return GetWin32Font( it.first, m_vecFonts, logFont, bEmbedd, pEncoding );
-    else
-        pFont = (*it.first).m_pFont;
+    pFont = this->findFont( m_fonts, TFontCacheKey(
+         TFontCacheElement( logFont.lfFaceName, logFont.lfWeight >= FW_BOLD ? true : false, logFont.lfItalic ? true : false, logFont.lfCharSet == SYMBOL_CHARSET, pEncoding ) ) );
+    if( pFont == nullptr )
+        return GetWin32Font( m_fonts, logFont, bEmbedd, pEncoding );
     
     return pFont;
 }
@@ -533,14 +534,11 @@ PdfFont* PdfFontCache::GetFont( const LOGFONTW &logFont,
     PODOFO_ASSERT( pEncoding );
 
     PdfFont*          pFont;
-    std::pair<TISortedFontList,TCISortedFontList> it;
 
-    it = std::equal_range( m_vecFonts.begin(), m_vecFonts.end(), 
-         TFontCacheElement( logFont.lfFaceName, logFont.lfWeight >= FW_BOLD ? true : false, logFont.lfItalic ? true : false, logFont.lfCharSet == SYMBOL_CHARSET, pEncoding ) );
-    if( it.first == it.second )
-        return GetWin32Font( it.first, m_vecFonts, logFont, bEmbedd, pEncoding );
-    else
-        pFont = (*it.first).m_pFont;
+    pFont = this->findFont( m_fonts, TFontCacheKey(
+         TFontCacheElement( logFont.lfFaceName, logFont.lfWeight >= FW_BOLD ? true : false, logFont.lfItalic ? true : false, logFont.lfCharSet == SYMBOL_CHARSET, pEncoding ) ) );
+    if( pFont == nullptr )
+        return GetWin32Font( m_fonts, logFont, bEmbedd, pEncoding );
     
     return pFont;
 }
@@ -550,7 +548,6 @@ PdfFont* PdfFontCache::GetFont( FT_Face face, bool bSymbolCharset, bool bEmbedd,
 {
     PdfFont*          pFont;
     PdfFontMetrics*   pMetrics;
-    std::pair<TISortedFontList,TCISortedFontList> it;
 
     std::string sName = FT_Get_Postscript_Name( face );
     if( sName.empty() )
@@ -562,29 +559,26 @@ PdfFont* PdfFontCache::GetFont( FT_Face face, bool bSymbolCharset, bool bEmbedd,
     bool bBold   = ((face->style_flags & FT_STYLE_FLAG_BOLD)   != 0);
     bool bItalic = ((face->style_flags & FT_STYLE_FLAG_ITALIC) != 0);
 
-    it = std::equal_range( m_vecFonts.begin(), m_vecFonts.end(), 
-               TFontCacheElement( sName.c_str(), bBold, bItalic, bSymbolCharset, pEncoding ) );
-    if( it.first == it.second )
+    pFont = this->findFont( m_fonts, TFontCacheKey( sName, bBold, bItalic, bSymbolCharset, pEncoding ) );
+    if( pFont == nullptr )
     {
         pMetrics = new PdfFontMetricsFreetype( &m_ftLibrary, face, bSymbolCharset );
-        pFont    = this->CreateFontObject( it.first, m_vecFonts, pMetrics, 
+        pFont    = this->CreateFontObject( m_fonts, pMetrics, 
                        bEmbedd, bBold, bItalic, sName.c_str(), pEncoding );
     }
-    else
-        pFont = (*it.first).m_pFont;
 
     return pFont;
 }
 
 PdfFont* PdfFontCache::GetDuplicateFontType1( PdfFont * pFont, const char* pszSuffix )
 {
-    TCISortedFontList it = m_vecFonts.begin();
+    TCIFontList it = m_fonts.m_vecFonts.begin();
 
     std::string id = pFont->GetIdentifier().GetString();
     id += pszSuffix;
 
     // Search if the object is a cached normal font
-    while( it != m_vecFonts.end() )
+    while( it != m_fonts.m_vecFonts.end() )
     {
         if( (*it).m_pFont->GetIdentifier() == id ) 
             return (*it).m_pFont;
@@ -593,8 +587,8 @@ PdfFont* PdfFontCache::GetDuplicateFontType1( PdfFont * pFont, const char* pszSu
     }
 
     // Search if the object is a cached font subset
-    it = m_vecFontSubsets.begin();
-    while( it != m_vecFontSubsets.end() )
+    it = m_fontSubsets.m_vecFonts.begin();
+    while( it != m_fontSubsets.m_vecFonts.end() )
     {
         if( (*it).m_pFont->GetIdentifier() == id ) 
             return (*it).m_pFont;
@@ -617,10 +611,7 @@ PdfFont* PdfFontCache::GetDuplicateFontType1( PdfFont * pFont, const char* pszSu
         element.m_sFontName = name;
         element.m_pEncoding = newFont->GetEncoding();
           element.m_bIsSymbolCharset = pFont->GetFontMetrics()->IsSymbol();
-        m_vecFonts  .push_back( element );
-        
-        // Now sort the font list
-        std::sort( m_vecFonts.begin(), m_vecFonts.end() );
+        this->addFont( m_fonts, element );
     }
 
     return newFont;
@@ -632,13 +623,12 @@ PdfFont* PdfFontCache::GetFontSubset( const char* pszFontName, bool bBold, bool
 {
     PdfFont*        pFont = 0;
     PdfFontMetrics* pMetrics;
-    std::pair<TISortedFontList,TCISortedFontList> it;
 
     // WARNING: The characters are completely ignored right now!
 
-    it = std::equal_range( m_vecFontSubsets.begin(), m_vecFontSubsets.end(), 
-               TFontCacheElement( pszFontName, bBold, bItalic, bSymbolCharset, pEncoding ) );
-    if( it.first == it.second )
+    pFont = this->findFont( m_fontSubsets,
+        TFontCacheKey( pszFontName, bBold, bItalic, bSymbolCharset, pEncoding ) );
+    if( pFont == nullptr )
     {
         std::string sPath; 
         if( pszFileName == nullptr || *pszFileName == 0) 
@@ -647,7 +637,7 @@ PdfFont* PdfFontCache::GetFontSubset( const char* pszFontName, bool bBold, bool
             if( sPath.empty() )
             {
 #if defined(WIN32) && !defined(PODOFO_NO_FONTMANAGER)
-                return GetWin32Font( it.first, m_vecFontSubsets, pszFontName, bBold, bItalic, bSymbolCharset, true, pEncoding, true );
+                return GetWin32Font( m_fontSubsets, pszFontName, bBold, bItalic, bSymbolCharset, true, pEncoding, true );
 #else       
                 PdfError::LogMessage( ELogSeverity::Critical, "No path was found for the specified fontname: %s", pszFontName );
                 return nullptr;
@@ -658,12 +648,10 @@ PdfFont* PdfFontCache::GetFontSubset( const char* pszFontName, bool bBold, bool
             sPath = pszFileName;
         }
         
-        pMetrics = PdfFontMetricsFreetype::CreateForSubsetting( &m_ftLibrary, sPath.c_str(), bSymbolCharset, genSubsetBasename() );
-        pFont = this->CreateFontObject( it.first, m_vecFontSubsets, pMetrics, 
+        pMetrics = this->createFontMetrics( sPath, bSymbolCharset, genSubsetBasename(), true );
+        pFont = this->CreateFontObject( m_fontSubsets, pMetrics, 
                                         true, bBold, bItalic, pszFontName, pEncoding, true );
     }
-    else
-        pFont = (*it.first).m_pFont;
     
     
     return pFont;
@@ -671,9 +659,9 @@ PdfFont* PdfFontCache::GetFontSubset( const char* pszFontName, bool bBold, bool
 
 void PdfFontCache::EmbedSubsetFonts()
 {
-    TCISortedFontList it = m_vecFontSubsets.begin();
+    TCIFontList it = m_fontSubsets.m_vecFonts.begin();
 
-    while( it != m_vecFontSubsets.end() )
+    while( it != m_fontSubsets.m_vecFonts.end() )
     {
         if( (*it).m_pFont->IsSubsetting() )
         {
@@ -685,7 +673,7 @@ void PdfFontCache::EmbedSubsetFonts()
 }
 
 #if defined(WIN32) && !defined(PODOFO_NO_FONTMANAGER)
-PdfFont* PdfFontCache::GetWin32Font( TISortedFontList itSorted, TSortedFontList & vecContainer, 
+PdfFont* PdfFontCache::GetWin32Font( TFontCacheList & rContainer, 
                                      const char* pszFontName, bool bBold, bool bItalic, bool bSymbolCharset,
                                      bool bEmbedd, const PdfEncoding * const pEncoding, bool pSubsetting )
 {
@@ -712,10 +700,10 @@ PdfFont* PdfFontCache::GetWin32Font( TISortedFontList itSorted, TSortedFontList
     //strcpy( lf.lfFaceName, pszFontName );
     /*int destLen =*/ MultiByteToWideChar (0, 0, pszFontName, -1, lf.lfFaceName, LF_FACESIZE);
 
-     return GetWin32Font(itSorted, vecContainer, lf, bEmbedd, pEncoding, pSubsetting);
+     return GetWin32Font(rContainer, lf, bEmbedd, pEncoding, pSubsetting);
 }
 
-PdfFont* PdfFontCache::GetWin32Font( TISortedFontList itSorted, TSortedFontList & vecContainer, 
+PdfFont* PdfFontCache::GetWin32Font( TFontCacheList & rContainer, 
                                      const wchar_t* pszFontName, bool bBold, bool bItalic, bool bSymbolCharset,
                                      bool bEmbedd, const PdfEncoding * const pEncoding, bool pSubsetting )
 {
@@ -744,10 +732,10 @@ PdfFont* PdfFontCache::GetWin32Font( TISortedFontList itSorted, TSortedFontList
     memset(&(lf.lfFaceName), 0, LF_FACESIZE);
     wcscpy( static_cast<wchar_t*>(lf.lfFaceName), pszFontName );
     
-    return GetWin32Font(itSorted, vecContainer, lf, bEmbedd, pEncoding, pSubsetting);
+    return GetWin32Font(rContainer, lf, bEmbedd, pEncoding, pSubsetting);
 }
 
-PdfFont* PdfFontCache::GetWin32Font( TISortedFontList itSorted, TSortedFontList & vecContainer, const LOGFONTA &logFont,
+PdfFont* PdfFontCache::GetWin32Font( TFontCacheList & rContainer, const LOGFONTA &logFont,
                                 bool bEmbedd, const PdfEncoding * const pEncoding, bool pSubsetting)
 {
     char*        pBuffer = nullptr;
@@ -760,7 +748,7 @@ PdfFont* PdfFontCache::GetWin32Font( TISortedFontList itSorted, TSortedFontList
     PdfFont*        pFont = nullptr;
     try {
          pMetrics = new PdfFontMetricsFreetype( &m_ftLibrary, pBuffer, nLen, logFont.lfCharSet == SYMBOL_CHARSET, pSubsetting ? genSubsetBasename() : nullptr );
-        pFont    = this->CreateFontObject( itSorted, vecContainer, pMetrics, 
+        pFont    = this->CreateFontObject( rContainer, pMetrics, 
               bEmbedd, logFont.lfWeight >= FW_BOLD ? true : false, logFont.lfItalic ? true : false, logFont.lfFaceName, pEncoding, pSubsetting );
     } catch( PdfError & error ) {
         podofo_free( pBuffer );
@@ -771,7 +759,7 @@ PdfFont* PdfFontCache::GetWin32Font( TISortedFontList itSorted, TSortedFontList
     return pFont;
 }
 
-PdfFont* PdfFontCache::GetWin32Font( TISortedFontList itSorted, TSortedFontList & vecContainer, const LOGFONTW &logFont,
+PdfFont* PdfFontCache::GetWin32Font( TFontCacheList & rContainer, const LOGFONTW &logFont,
                                 bool bEmbedd, const PdfEncoding * const pEncoding, bool pSubsetting)
 {
     size_t lFontNameLen = wcslen(logFont.lfFaceName);
@@ -800,7 +788,7 @@ PdfFont* PdfFontCache::GetWin32Font( TISortedFontList itSorted, TSortedFontList
     PdfFont*        pFont = nullptr;
     try {
         pMetrics = new PdfFontMetricsFreetype( &m_ftLibrary, pBuffer, nLen, logFont.lfCharSet == SYMBOL_CHARSET, pSubsetting ? genSubsetBasename() : nullptr );
-        pFont    = this->CreateFontObject( itSorted, vecContainer, pMetrics, 
+        pFont    = this->CreateFontObject( rContainer, pMetrics, 
               bEmbedd, logFont.lfWeight >= FW_BOLD ? true : false, logFont.lfItalic ? true : false, pmbFontName, pEncoding, pSubsetting );
         podofo_free( pmbFontName );
         pmbFontName = nullptr;
@@ -820,7 +808,16 @@ PdfFont* PdfFontCache::GetWin32Font( TISortedFontList itSorted, TSortedFontList
 std::string PdfFontCache::GetFontPath( const char* pszFontName, bool bBold, bool bItalic )
 {
 #if defined(PODOFO_HAVE_FONTCONFIG)
-    std::string sPath = m_fontConfig->GetFontConfigFontPath( pszFontName, bBold, bItalic );
+    std::string sPath;
+    if ( !PdfSharedFontCache::IsEnabled() )
+        return m_fontConfig->GetFontConfigFontPath( pszFontName, bBold, bItalic );
+
+    PdfSharedFontCache& sharedCache = PdfSharedFontCache::GetInstance();
+    if ( !sharedCache.TryGetFontPath( pszFontName, bBold, bItalic, sPath ) )
+    {
+        sPath = m_fontConfig->GetFontConfigFontPath( pszFontName, bBold, bItalic );
+        sharedCache.AddFontPath( pszFontName, bBold, bItalic, sPath );
+    }
 #else
     (void)pszFontName;
     (void)bBold;
@@ -830,7 +827,25 @@ std::string PdfFontCache::GetFontPath( const char* pszFontName, bool bBold, bool
     return sPath;
 }
 
-PdfFont* PdfFontCache::CreateFontObject( TISortedFontList itSorted, TSortedFontList & rvecContainer, 
+PdfFontMetrics* PdfFontCache::createFontMetrics( const std::string& sPath, bool bSymbolCharset,
+                                                 const char* pszSubsetPrefix, bool bSubsetting )
+{
+    // Only TrueType fonts can be loaded from the shared memory,
+    // the other formats are read by FreeType from the file
+    if ( PdfSharedFontCache::IsEnabled()
+        && PdfFontFactory::GetFontType( sPath.c_str() ) == EPdfFontType::TrueType )
+    {
+        auto pFile = PdfSharedFontCache::GetInstance().GetFontFile( sPath );
+        return new PdfFontMetricsFreetype( &m_ftLibrary, pFile, bSymbolCharset, pszSubsetPrefix );
+    }
+
+    if ( bSubsetting )
+        return PdfFontMetricsFreetype::CreateForSubsetting( &m_ftLibrary, sPath.c_str(), bSymbolCharset, pszSubsetPrefix );
+    else
+        return new PdfFontMetricsFreetype( &m_ftLibrary, sPath.c_str(), bSymbolCharset, pszSubsetPrefix );
+}
+
+PdfFont* PdfFontCache::CreateFontObject( TFontCacheList & rContainer, 
                      PdfFontMetrics* pMetrics, bool bEmbedd, bool bBold, bool bItalic, 
                      const char* pszFontName, const PdfEncoding * const pEncoding, bool bSubsetting ) 
 {
@@ -863,8 +878,7 @@ PdfFont* PdfFontCache::CreateFontObject( TISortedFontList itSorted, TSortedFontL
             element.m_pEncoding = pEncoding;
             element.m_bIsSymbolCharset = pMetrics->IsSymbol();
             
-            // Do a sorted insert, so no need to sort again
-            rvecContainer.insert( itSorted, element );
+            this->addFont( rContainer, element );
         }
     } catch( PdfError & e ) {
         e.AddToCallstack( __FILE__, __LINE__ );
@@ -876,6 +890,35 @@ PdfFont* PdfFontCache::CreateFontObject( TISortedFontList itSorted, TSortedFontL
     return pFont;
 }
 
+PdfFont* PdfFontCache::findFont( const TFontCacheList & rContainer, const TFontCacheKey & rKey ) const
+{
+    if( rKey.m_sEncodingId.empty() )
+    {
+        auto found = rContainer.m_mapAnyEncoding.find( rKey );
+        return found == rContainer.m_mapAnyEncoding.end() ? nullptr : found->second;
+    }
+
+    auto found = rContainer.m_mapIndex.find( rKey );
+    if( found != rContainer.m_mapIndex.end() )
+        return found->second;
+
+    // Fonts without encoding match any encoding
+    TFontCacheKey anyKey( rKey );
+    anyKey.m_sEncodingId.clear();
+    found = rContainer.m_mapIndex.find( anyKey );
+    return found == rContainer.m_mapIndex.end() ? nullptr : found->second;
+}
+
+void PdfFontCache::addFont( TFontCacheList & rContainer, const TFontCacheElement & rElement )
+{
+    TFontCacheKey key( rElement );
+    rContainer.m_vecFonts.push_back( rElement );
+    rContainer.m_mapIndex.emplace( key, rElement.m_pFont );
+    key.m_sEncodingId.clear();
+    rContainer.m_mapAnyEncoding.emplace( key, rElement.m_pFont );
+    m_mapFontsByRef.emplace( rElement.m_pFont->GetObject()->GetIndirectReference(), rElement.m_pFont );
+}
+
 const char *PdfFontCache::genSubsetBasename(void)
 {
     int ii = 0;
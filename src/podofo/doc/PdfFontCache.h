@@ -42,6 +42,9 @@
 #include "podofo/base/PdfEncodingFactory.h"
 
 #include "PdfFont.h"
+
+#include <unordered_map>
+
 #ifdef PODOFO_HAVE_FONTCONFIG
 #include "PdfFontConfigWrapper.h"
 #endif
@@ -140,6 +143,30 @@ struct TFontCacheElement {
     bool               m_bIsSymbolCharset;
 };
 
+/** A private structure, which is the
+ *  key of a font in the cache indices
+ */
+struct TFontCacheKey
+{
+    TFontCacheKey( const std::string& sFontName, bool bBold, bool bItalic, bool bIsSymbolCharset,
+                   const PdfEncoding * const pEncoding );
+
+    TFontCacheKey( const TFontCacheElement & rElement );
+
+    bool operator==( const TFontCacheKey & rhs ) const;
+
+    std::string m_sFontName;
+    std::string m_sEncodingId;  ///< Empty for fonts matching any encoding
+    bool        m_bBold;
+    bool        m_bItalic;
+    bool        m_bIsSymbolCharset;
+};
+
+struct TFontCacheKeyHash
+{
+    size_t operator()( const TFontCacheKey & rKey ) const;
+};
+
 /**
  * Flags to control font creation.
  */
@@ -168,9 +195,26 @@ enum class EFontCreationFlags
  */
 class PODOFO_DOC_API PdfFontCache
 {
-    typedef std::vector<TFontCacheElement>  TSortedFontList;
-    typedef TSortedFontList::iterator       TISortedFontList;
-    typedef TSortedFontList::const_iterator TCISortedFontList;
+    typedef std::vector<TFontCacheElement>  TFontList;
+    typedef TFontList::iterator             TIFontList;
+    typedef TFontList::const_iterator       TCIFontList;
+
+    /** A list of fonts in the cache, indexed by TFontCacheKey
+     */
+    struct TFontCacheList
+    {
+        TFontList m_vecFonts;
+        std::unordered_map<TFontCacheKey, PdfFont*, TFontCacheKeyHash> m_mapIndex;
+        std::unordered_map<TFontCacheKey, PdfFont*, TFontCacheKeyHash> m_mapAnyEncoding; ///< Index ignoring the encoding
+    };
+
+    struct TReferenceHash
+    {
+        inline size_t operator()( const PdfReference & rRef ) const
+        {
+            return std::hash<uint64_t>()( static_cast<uint64_t>(rRef.ObjectNumber()) << 16 | rRef.GenerationNumber() );
+        }
+    };
 
  public:
 
@@ -330,11 +374,36 @@ class PODOFO_DOC_API PdfFontCache
      */
     std::string GetFontPath( const char* pszFontName, bool bBold, bool bItalic );
 
+    /** Create the metrics of a font file, loading TrueType
+     *  files through PdfSharedFontCache when it's enabled
+     *  \param sPath path to the font file
+     *  \param bSymbolCharset whether to use symbol charset, rather than unicode charset
+     *  \param pszSubsetPrefix unique prefix for font subsets, or nullptr
+     *  \param bSubsetting if true the metrics are used for a font subset
+     *  \returns the font metrics
+     */
+    PdfFontMetrics* createFontMetrics( const std::string& sPath, bool bSymbolCharset,
+                                       const char* pszSubsetPrefix, bool bSubsetting );
+
+    /** Find a font in a list of the cache. As for the sorted
+     *  lists used before, a font or a key without encoding
+     *  matches any encoding
+     *  \param rContainer the list to search
+     *  \param rKey the key of the font
+     *  \returns the font or nullptr if it is not in the list
+     */
+    PdfFont* findFont( const TFontCacheList & rContainer, const TFontCacheKey & rKey ) const;
+
+    /** Add a font to a list of the cache and to the
+     *  index of the fonts by object reference
+     *  \param rContainer the list the font should be added to
+     *  \param rElement the font to add
+     */
+    void addFont( TFontCacheList & rContainer, const TFontCacheElement & rElement );
+
     /** Create a font and put it into the fontcache
      *
-     *  \param itSorted iterator pointing to a location in vecContainer
-     *                  where a sorted insert can be made
-     *  \param vecContainer container where the font object should be added
+     *  \param rContainer container where the font object should be added
      *  \param pMetrics a font metrics
      *  \param bEmbedd if true the font will be embedded in the pdf file
      *  \param bBold if true this font will be treated as bold font
@@ -345,7 +414,7 @@ class PODOFO_DOC_API PdfFontCache
      *
      *  \returns a font handle or nullptr in case of error
      */
-    PdfFont* CreateFontObject( TISortedFontList itSorted, TSortedFontList & vecContainer,
+    PdfFont* CreateFontObject( TFontCacheList & rContainer,
                                PdfFontMetrics* pMetrics, bool bEmbedd, bool bBold, 
                                bool bItalic, const char* pszFontName, const PdfEncoding * const pEncoding,
 							   bool bSubsetting = false );
@@ -368,9 +437,7 @@ class PODOFO_DOC_API PdfFontCache
      *
      *  This method is only available on Windows systems.
      * 
-     *  \param itSorted iterator pointing to a location in vecContainer
-     *                  where a sorted insert can be made
-     *  \param vecContainer container where the font object should be added
+     *  \param rContainer container where the font object should be added
      *  \param pszFontName a fontname
      *  \param bBold if true search for a bold font
      *  \param bItalic if true search for an italic font
@@ -379,16 +446,16 @@ class PODOFO_DOC_API PdfFontCache
      *
      *  \returns a font handle or nullptr in case of error
      */
-    PdfFont* GetWin32Font( TISortedFontList itSorted, TSortedFontList & vecContainer, const char* pszFontName, 
+    PdfFont* GetWin32Font( TFontCacheList & rContainer, const char* pszFontName, 
 			               bool bBold, bool bItalic, bool bSymbolCharset, bool bEmbedd, const PdfEncoding * const pEncoding, bool pSubsetting = false );
 
-    PdfFont* GetWin32Font( TISortedFontList itSorted, TSortedFontList & vecContainer, const wchar_t* pszFontName, 
+    PdfFont* GetWin32Font( TFontCacheList & rContainer, const wchar_t* pszFontName, 
 			               bool bBold, bool bItalic, bool bSymbolCharset, bool bEmbedd, const PdfEncoding * const pEncoding, bool pSubsetting = false );
 
-    PdfFont* GetWin32Font( TISortedFontList itSorted, TSortedFontList & vecContainer, const LOGFONTA &logFont,
+    PdfFont* GetWin32Font( TFontCacheList & rContainer, const LOGFONTA &logFont,
 								bool bEmbedd, const PdfEncoding * const pEncoding, bool pSubsetting = false );
 
-    PdfFont* GetWin32Font( TISortedFontList itSorted, TSortedFontList & vecContainer, const LOGFONTW &logFont,
+    PdfFont* GetWin32Font( TFontCacheList & rContainer, const LOGFONTW &logFont,
 								bool bEmbedd, const PdfEncoding * const pEncoding, bool pSubsetting = false );
 #endif // WIN32
 
@@ -401,8 +468,9 @@ class PODOFO_DOC_API PdfFontCache
     void Init(void);
 	
  private:
-    TSortedFontList m_vecFonts;              ///< Sorted list of all fonts, currently in the cache
-    TSortedFontList m_vecFontSubsets;
+    TFontCacheList  m_fonts;                 ///< All fonts, currently in the cache
+    TFontCacheList  m_fontSubsets;
+    std::unordered_map<PdfReference, PdfFont*, TReferenceHash> m_mapFontsByRef; ///< All fonts, by object reference
     FT_Library      m_ftLibrary;             ///< Handle to the freetype library
 
     PdfVecObjects*  m_pParent;               ///< Handle to parent for creating new fonts and objects
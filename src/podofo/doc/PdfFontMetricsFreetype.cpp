@@ -40,8 +40,12 @@
 #include "base/PdfVariant.h"
 
 #include "PdfFontFactory.h"
+#include "PdfSharedFontCache.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 #include <wchar.h>
@@ -146,6 +150,23 @@ PdfFontMetricsFreetype::PdfFontMetricsFreetype( FT_Library* pLibrary,
     InitFromBuffer(pIsSymbol);
 }
 
+PdfFontMetricsFreetype::PdfFontMetricsFreetype( FT_Library* pLibrary, 
+                                                const std::shared_ptr<const PdfSharedFontFile>& pFile,
+                                                bool pIsSymbol,
+                                                const char* pszSubsetPrefix )
+    : PdfFontMetrics( EPdfFontType::Unknown, pFile->GetFilename().c_str(), pszSubsetPrefix ),
+      m_pLibrary( pLibrary ),
+      m_pFace( nullptr ),
+      m_bSymbol( pIsSymbol ),
+      m_bufFontData( const_cast<char*>( pFile->GetData() ), pFile->GetSize() ),
+      m_pSharedFile( pFile )
+{
+    // The data is owned by the shared file
+    m_bufFontData.SetTakePossesion( false );
+
+    InitFromBuffer(pIsSymbol);
+}
+
 PdfFontMetricsFreetype::PdfFontMetricsFreetype( FT_Library* pLibrary, 
                                                 FT_Face face, 
                                                                 bool pIsSymbol,
@@ -243,6 +264,7 @@ void PdfFontMetricsFreetype::InitFromFace(bool pIsSymbol)
         // we cache the 256 first width entries as they
         // are most likely needed quite often
         m_vecWidth.clear();
+        m_vecWidthPages.clear();
         m_vecWidth.reserve( PODOFO_WIDTH_CACHE_SIZE );
         for( unsigned int i=0; i < PODOFO_WIDTH_CACHE_SIZE; i++ )
         {
@@ -331,14 +353,10 @@ void PdfFontMetricsFreetype::GetWidthArray( PdfVariant & var, unsigned int nFirs
                 list.push_back( PdfVariant( (int64_t)this->GetGlyphWidth(this->GetGlyphId(shCode)) ) );
                 continue;
             }
-            else if( FT_Load_Char( m_pFace, i, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP ) == 0 )  // | FT_LOAD_NO_RENDER
-            {
-                // zero return code is success!
-                list.push_back( PdfVariant( m_pFace->glyph->metrics.horiAdvance * 1000.0 / m_pFace->units_per_EM ) );
-                continue;
-            }
-            //PODOFO_RAISE_ERROR( EPdfError::FreeType );
-            list.push_back( PdfVariant( 0.0 ) );
+
+            double dWidth;
+            tryGetCharWidth( i, dWidth );
+            list.push_back( PdfVariant( dWidth ) );
         }
     }
 
@@ -390,7 +408,6 @@ double PdfFontMetricsFreetype::CharWidth( unsigned char c ) const
 
 double PdfFontMetricsFreetype::UnicodeCharWidth( unsigned short c ) const
 {
-    FT_Error ftErr;
     double   dWidth = 0.0;
 
     if( static_cast<int>(c) < PODOFO_WIDTH_CACHE_SIZE ) 
@@ -399,17 +416,49 @@ double PdfFontMetricsFreetype::UnicodeCharWidth( unsigned short c ) const
     }
     else
     {
-        ftErr = FT_Load_Char( m_pFace, static_cast<FT_UInt>(c), FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP );
-        if( ftErr )
+        if( !tryGetCharWidth( c, dWidth ) )
             return dWidth;
-
-        dWidth = m_pFace->glyph->metrics.horiAdvance * 1000.0 / m_pFace->units_per_EM;
     }
 
     return dWidth * static_cast<double>(this->GetFontSize() * this->GetFontScale() / 100.0) / 1000.0 +
         static_cast<double>( this->GetFontSize() * this->GetFontScale() / 100.0 * this->GetFontCharSpace() / 100.0);
 }
 
+bool PdfFontMetricsFreetype::tryGetCharWidth( unsigned int nCode, double& dWidth ) const
+{
+    unsigned int nPage = nCode / PODOFO_WIDTH_CACHE_SIZE;
+    if( nPage >= m_vecWidthPages.size() )
+        m_vecWidthPages.resize( nPage + 1 );
+
+    auto& page = m_vecWidthPages[nPage];
+    if( page == nullptr )
+    {
+        // Widths are loaded on first use, NaN marks the ones not loaded
+        // yet and a negative width the ones FreeType can't load
+        page.reset( new double[PODOFO_WIDTH_CACHE_SIZE] );
+        std::fill( page.get(), page.get() + PODOFO_WIDTH_CACHE_SIZE, std::numeric_limits<double>::quiet_NaN() );
+    }
+
+    double& dCached = page[nCode % PODOFO_WIDTH_CACHE_SIZE];
+    if( std::isnan( dCached ) )
+    {
+        // zero return code is success!
+        if( FT_Load_Char( m_pFace, static_cast<FT_ULong>(nCode), FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP ) == 0 )  // | FT_LOAD_NO_RENDER
+            dCached = m_pFace->glyph->metrics.horiAdvance * 1000.0 / m_pFace->units_per_EM;
+        else
+            dCached = -1.0;
+    }
+
+    if( dCached < 0.0 )
+    {
+        dWidth = 0.0;
+        return false;
+    }
+
+    dWidth = dCached;
+    return true;
+}
+
 long PdfFontMetricsFreetype::GetGlyphId( long lUnicode ) const
 {
     long lGlyph = 0L;
@@ -39,10 +39,14 @@
 #include "podofo/base/PdfString.h"
 #include "PdfFontMetrics.h"
 
+#include <memory>
+#include <vector>
+
 namespace PoDoFo {
 
 class PdfArray;
 class PdfObject;
+class PdfSharedFontFile;
 class PdfVariant;
 
 class PODOFO_DOC_API PdfFontMetricsFreetype : public PdfFontMetrics {
@@ -75,6 +79,16 @@ class PODOFO_DOC_API PdfFontMetricsFreetype : public PdfFontMetrics {
     PdfFontMetricsFreetype( FT_Library* pLibrary, const PdfRefCountedBuffer & rBuffer,
 		    bool  pIsSymbol, const char* pszSubsetPrefix = nullptr);
 
+    /** Create a font metrics object for a true type file shared
+     *  with other documents. The file data is not copied
+     *  \param pLibrary handle to an initialized FreeType2 library handle
+     *  \param pFile a true type file from PdfSharedFontCache
+	  *  \param pIsSymbol whether use a symbol encoding, rather than unicode
+     *  \param pszSubsetPrefix unique prefix for font subsets (see GetFontSubsetPrefix)
+     */
+    PdfFontMetricsFreetype( FT_Library* pLibrary, const std::shared_ptr<const PdfSharedFontFile>& pFile,
+		    bool  pIsSymbol, const char* pszSubsetPrefix = nullptr);
+
     /** Create a font metrics object for a given freetype font.
      *  \param pLibrary handle to an initialized FreeType2 library handle
      *  \param face a valid freetype font face
@@ -283,6 +297,14 @@ class PODOFO_DOC_API PdfFontMetricsFreetype : public PdfFontMetrics {
     void InitFromFace(bool pIsSymbol);
 
     void InitFontSizes();
+
+    /** Get the unscaled width of a character, in 1/1000 of the em,
+     *  loading it with FreeType only the first time it is requested
+     *  \param nCode unicode code point of the character
+     *  \param dWidth the width of the character, 0 if it can't be loaded
+     *  \returns false if the character can't be loaded
+     */
+    bool tryGetCharWidth( unsigned int nCode, double& dWidth ) const;
  protected:
     FT_Library*   m_pLibrary;
     FT_Face       m_pFace;
@@ -307,7 +329,13 @@ class PODOFO_DOC_API PdfFontMetricsFreetype : public PdfFontMetrics {
     double        m_dStrikeOutPosition;
 
     PdfRefCountedBuffer m_bufFontData;
+    std::shared_ptr<const PdfSharedFontFile> m_pSharedFile;   ///< Keeps alive the data of m_bufFontData, if shared
     std::vector<double> m_vecWidth;
+
+    /** Sparse cache of the widths of characters not in m_vecWidth,
+     *  allocated lazily in pages of PODOFO_WIDTH_CACHE_SIZE entries
+     */
+    mutable std::vector<std::unique_ptr<double[]>> m_vecWidthPages;
 };
 
 // -----------------------------------------------------
@@ -49,8 +49,6 @@ PdfFontMetricsObject::PdfFontMetricsObject( PdfObject* pFont, PdfObject* pDescri
     : PdfFontMetrics( EPdfFontType::Unknown, "", nullptr ),
       m_pEncoding( pEncoding ), m_dDefWidth(0.0)
 {
-    m_missingWidth = nullptr;
-
     const PdfName & rSubType = pFont->GetDictionary().GetKey( PdfName::KeySubtype )->GetName();
 
     PdfObject* fontmatrix = nullptr;
@@ -79,7 +77,6 @@ PdfFontMetricsObject::PdfFontMetricsObject( PdfObject* pFont, PdfObject* pDescri
         if( widths != nullptr )
         {
             m_width        = widths->GetArray();
-            m_missingWidth = nullptr;
         }
         else
         {
@@ -92,7 +89,7 @@ PdfFontMetricsObject::PdfFontMetricsObject( PdfObject* pFont, PdfObject* pDescri
             {
                 PODOFO_RAISE_ERROR_INFO( EPdfError::NoObject, "Font object defines neither Widths, nor MissingWidth values!" );
             }
-            m_missingWidth = widths;
+            m_dDefWidth = widths->GetReal();
         }
     }
     else if (rSubType == PdfName("CIDFontType0") || rSubType == PdfName("CIDFontType2"))
@@ -222,10 +219,7 @@ double PdfFontMetricsObject::CharWidth( unsigned char c ) const
 
     }
 
-    if( m_missingWidth != nullptr )
-        return m_missingWidth->GetReal ();
-    else
-        return m_dDefWidth;
+    return m_dDefWidth;
 }
 
 double PdfFontMetricsObject::UnicodeCharWidth( unsigned short c ) const
@@ -238,10 +232,7 @@ double PdfFontMetricsObject::UnicodeCharWidth( unsigned short c ) const
         return (dWidth * m_matrix[0] * m_fFontSize + m_fFontCharSpace) * m_fFontScale / 100.0;
     }
 
-    if( m_missingWidth != nullptr )
-        return m_missingWidth->GetReal ();
-    else
-        return m_dDefWidth;
+    return m_dDefWidth;
 }
 
 void PdfFontMetricsObject::GetWidthArray( PdfVariant & var, unsigned int, unsigned int, const PdfEncoding* ) const
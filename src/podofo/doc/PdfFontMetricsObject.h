@@ -230,7 +230,6 @@ class PODOFO_DOC_API PdfFontMetricsObject : public PdfFontMetrics {
     PdfArray      m_bbox;
     std::array<double, 6> m_matrix;
     PdfArray      m_width;
-    PdfObject    *m_missingWidth;
     int           m_nFirst;
     int           m_nLast;
     unsigned int  m_nWeight;
@@ -36,6 +36,7 @@
 #include "PdfImage.h"
 
 #include <utfcpp/utf8.h>
+#include <algorithm>
 #include <sstream>
 
 #include "base/PdfDefinesPrivate.h"
@@ -796,8 +797,197 @@ void PdfImage::LoadFromTiffData(const unsigned char* pData, size_t dwLen)
 
 #ifdef PODOFO_HAVE_PNG_LIB
 
+/** Image parameters and compressed data of a PNG whose
+ *  IDAT chunks can be embedded as a FlateDecode stream
+ */
+struct PngPassthroughData
+{
+    png_uint_32 Width;
+    png_uint_32 Height;
+    int Depth;
+    int Colors;
+    std::string Idat;
+};
+
+static bool readPngBytes( PdfInputStream& rStream, char* pBuffer, size_t lLen )
+{
+    bool eof = false;
+    size_t lRead = 0;
+    while( lRead < lLen && !eof )
+        lRead += rStream.Read( pBuffer + lRead, lLen - lRead, eof );
+
+    return lRead == lLen;
+}
+
+// Chunk data is read in blocks of this size
+constexpr size_t nPngChunkReadBlock = 65536;
+
+/** Append the data of a chunk to rData. The buffer grows only as
+ *  the data is read, as the chunk length can't be trusted
+ */
+static bool readPngChunkData( PdfInputStream& rStream, std::string& rData, size_t lLen )
+{
+    if( lLen > rData.max_size() - rData.size() )
+        PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidDataType, "The PNG data is too large" );
+
+    while( lLen != 0 )
+    {
+        size_t lBlock = std::min( lLen, nPngChunkReadBlock );
+        size_t lOffset = rData.size();
+        rData.resize( lOffset + lBlock );
+        if( !readPngBytes( rStream, &rData[lOffset], lBlock ) )
+            return false;
+
+        lLen -= lBlock;
+    }
+
+    return true;
+}
+
+static png_uint_32 readPngUInt32( const char* pBuffer )
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(pBuffer);
+    return ( static_cast<png_uint_32>(p[0]) << 24 ) | ( static_cast<png_uint_32>(p[1]) << 16 )
+        | ( static_cast<png_uint_32>(p[2]) << 8 ) | static_cast<png_uint_32>(p[3]);
+}
+
+static bool checkPngChunkCrc( const char* pType, const char* pData, size_t lLen, const char* pCrc )
+{
+    uLong crc = crc32( 0, reinterpret_cast<const Bytef*>(pType), 4 );
+    crc = crc32( crc, reinterpret_cast<const Bytef*>(pData), static_cast<uInt>(lLen) );
+    return crc == readPngUInt32( pCrc );
+}
+
+/** Read the chunks of a PNG and collect its IDAT data if the image
+ *  can be embedded without decompressing it. This is possible for
+ *  non interlaced grayscale and RGB images with no transparency:
+ *  their zlib stream is a valid FlateDecode stream using the PNG
+ *  predictors.
+ *
+ *  \returns false if the image is not suitable or is malformed
+ */
+static bool readPngPassthrough( PdfInputStream& rStream, PngPassthroughData& rData )
+{
+    char header[8];
+    if( !readPngBytes( rStream, header, 8 ) ||
+        png_sig_cmp( reinterpret_cast<png_const_bytep>(header), 0, 8 ) )
+        return false;
+
+    bool bIdatDone = false;
+    std::string chunk;
+    for( bool bFirst = true; ; bFirst = false )
+    {
+        char crc[4];
+        if( !readPngBytes( rStream, header, 8 ) )
+            return false;
+
+        png_uint_32 lLen = readPngUInt32( header );
+        const char* pType = header + 4;
+        if( lLen > PNG_UINT_31_MAX || bFirst != ( memcmp( pType, "IHDR", 4 ) == 0 ) )
+            return false;
+
+        // Transparency needs a soft mask, made when decoding
+        if( memcmp( pType, "tRNS", 4 ) == 0 )
+            return false;
+
+        if( memcmp( pType, "IDAT", 4 ) == 0 )
+        {
+            // IDAT chunks must be consecutive
+            if( bIdatDone )
+                return false;
+
+            size_t lOffset = rData.Idat.size();
+            if( !readPngChunkData( rStream, rData.Idat, lLen ) || !readPngBytes( rStream, crc, 4 ) ||
+                !checkPngChunkCrc( pType, rData.Idat.data() + lOffset, lLen, crc ) )
+                return false;
+
+            continue;
+        }
+
+        bIdatDone = !rData.Idat.empty();
+        chunk.clear();
+        if( !readPngChunkData( rStream, chunk, lLen ) || !readPngBytes( rStream, crc, 4 ) )
+            return false;
+
+        if( bFirst )
+        {
+            if( lLen != 13 || !checkPngChunkCrc( pType, chunk.data(), lLen, crc ) )
+                return false;
+
+            rData.Width = readPngUInt32( chunk.data() );
+            rData.Height = readPngUInt32( chunk.data() + 4 );
+            rData.Depth = static_cast<unsigned char>(chunk[8]);
+            int nColorType = static_cast<unsigned char>(chunk[9]);
+            if( rData.Width == 0 || rData.Width > PNG_UINT_31_MAX ||
+                rData.Height == 0 || rData.Height > PNG_UINT_31_MAX )
+                return false;
+
+            // Compression and filter method must be 0, no interlacing
+            if( chunk[10] != 0 || chunk[11] != 0 || chunk[12] != 0 )
+                return false;
+
+            switch( nColorType )
+            {
+                case PNG_COLOR_TYPE_GRAY:
+                    if( rData.Depth != 1 && rData.Depth != 2 && rData.Depth != 4 &&
+                        rData.Depth != 8 && rData.Depth != 16 )
+                        return false;
+
+                    rData.Colors = 1;
+                    break;
+                case PNG_COLOR_TYPE_RGB:
+                    if( rData.Depth != 8 && rData.Depth != 16 )
+                        return false;
+
+                    rData.Colors = 3;
+                    break;
+                default:
+                    // Palette images and images with an alpha
+                    // channel need to be decoded
+                    return false;
+            }
+        }
+        else if( memcmp( pType, "IEND", 4 ) == 0 )
+        {
+            return !rData.Idat.empty();
+        }
+    }
+}
+
+bool PdfImage::LoadFromPngPassthrough(PdfInputStream& rStream)
+{
+    PngPassthroughData png;
+    if( !readPngPassthrough( rStream, png ) )
+        return false;
+
+    // 16 bits per component need PDF 1.5
+    if( png.Depth == 16 && this->GetObject()->GetDocument()->GetPdfVersion() < EPdfVersion::V1_5 )
+        return false;
+
+    this->SetImageColorSpace( png.Colors == 3 ? EPdfColorSpace::DeviceRGB : EPdfColorSpace::DeviceGray );
+
+    PdfDictionary decodeParms;
+    decodeParms.AddKey( "Predictor", static_cast<int64_t>(EPdfPredictor::PngOptimum) );
+    decodeParms.AddKey( "Colors", static_cast<int64_t>(png.Colors) );
+    decodeParms.AddKey( "BitsPerComponent", static_cast<int64_t>(png.Depth) );
+    decodeParms.AddKey( "Columns", static_cast<int64_t>(png.Width) );
+    this->GetObject()->GetDictionary().AddKey( PdfName::KeyFilter, PdfName("FlateDecode") );
+    this->GetObject()->GetDictionary().AddKey( "DecodeParms", decodeParms );
+
+    // The IDAT data is a zlib stream of rows with PNG filters: embed it as is
+    PdfMemoryInputStream stream( png.Idat.data(), png.Idat.size() );
+    this->SetImageDataRaw( png.Width, png.Height, png.Depth, stream );
+    return true;
+}
+
 void PdfImage::LoadFromPng(const std::string_view& filename)
 {
+    {
+        PdfFileInputStream stream( filename );
+        if( LoadFromPngPassthrough( stream ) )
+            return;
+    }
+
     FILE* file = io::fopen(filename, "rb");
 
     try
@@ -1005,6 +1195,12 @@ void PdfImage::LoadFromPngData(const unsigned char* pData, size_t dwLen)
     {
         PODOFO_RAISE_ERROR( EPdfError::InvalidHandle );
     }
+
+    {
+        PdfMemoryInputStream stream( reinterpret_cast<const char*>(pData), dwLen );
+        if( LoadFromPngPassthrough( stream ) )
+            return;
+    }
     
     pngData data(pData, dwLen);
     png_byte header[8];
@@ -221,6 +221,9 @@ class PODOFO_DOC_API PdfImage : public PdfXObject {
 #endif // PODOFO_HAVE_TIFF_LIB
 #ifdef PODOFO_HAVE_PNG_LIB
     /** Load the image data from a PNG file
+     *
+     *  The compressed data of non interlaced grayscale and RGB images
+     *  is embedded as is, other images are decoded and compressed again.
      *  \param pszFilename
      */
     void LoadFromPng(const std::string_view& filename);
@@ -267,6 +270,13 @@ class PODOFO_DOC_API PdfImage : public PdfXObject {
 #endif // PODOFO_HAVE_TIFF_LIB
 #ifdef PODOFO_HAVE_PNG_LIB
 	void LoadFromPngHandle(FILE* pInStream);
+
+    /** Embed the compressed data of a PNG without decoding it,
+     *  if the image format allows it
+     *
+     *  \returns false if the PNG has to be decoded
+     */
+    bool LoadFromPngPassthrough(PdfInputStream& rStream);
 #endif // PODOFO_HAVE_PNG_LIB
 };
 
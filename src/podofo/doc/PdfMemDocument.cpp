@@ -69,6 +69,7 @@ PdfMemDocument::PdfMemDocument()
 {
     m_eVersion    = PdfVersionDefault;
     m_eWriteMode  = PdfWriteModeDefault;
+    m_nRealPrecision = PdfRealPrecisionDefault;
     m_bLinearized = false;
     m_eSourceVersion = m_eVersion;
 }
@@ -78,6 +79,7 @@ PdfMemDocument::PdfMemDocument(bool bOnlyTrailer)
 {
     m_eVersion    = PdfVersionDefault;
     m_eWriteMode  = PdfWriteModeDefault;
+    m_nRealPrecision = PdfRealPrecisionDefault;
     m_bLinearized = false;
     m_eSourceVersion = m_eVersion;
 }
@@ -97,6 +99,7 @@ void PdfMemDocument::Clear()
 {
     m_pEncrypt = nullptr;
     m_eWriteMode = PdfWriteModeDefault;
+    m_nRealPrecision = PdfRealPrecisionDefault;
 
     m_bSoureHasXRefStream = false;
     m_lPrevXRefOffset = -1;
@@ -269,8 +272,8 @@ std::vector<PdfExtension> PdfMemDocument::GetPdfExtensions() const {
         // Loop through all declared extensions
         for (TKeyMap::const_iterator it = pExtensions->GetDictionary().begin(); it != pExtensions->GetDictionary().end(); ++it) {
 
-            PdfObject *bv = it->second.GetIndirectKey("BaseVersion");
-            PdfObject *el = it->second.GetIndirectKey("ExtensionLevel");
+            PdfObject *bv = it->second->GetIndirectKey("BaseVersion");
+            PdfObject *el = it->second->GetIndirectKey("ExtensionLevel");
             
             if (bv && el && bv->IsName() && el->IsNumber()) {
 
@@ -303,6 +306,7 @@ void PdfMemDocument::Write(const std::string_view& filename, PdfSaveOptions opti
 {
     PdfOutputDevice device(filename);
     this->Write(device, options);
+    device.Flush();
 }
 
 void PdfMemDocument::Write(PdfOutputDevice& device, PdfSaveOptions options)
@@ -314,6 +318,7 @@ void PdfMemDocument::Write(PdfOutputDevice& device, PdfSaveOptions options)
     writer.SetPdfVersion( this->GetPdfVersion() );
     writer.SetSaveOptions(options);
     writer.SetWriteMode( m_eWriteMode );
+    writer.SetRealPrecision( m_nRealPrecision );
 
     if( m_pEncrypt ) 
         writer.SetEncrypted( *m_pEncrypt );
@@ -325,6 +330,7 @@ void PdfMemDocument::WriteUpdate(const string_view& filename, PdfSaveOptions opt
 {
     PdfOutputDevice device(filename, false);
     this->WriteUpdate(device, options);
+    device.Flush();
 }
 
 void PdfMemDocument::WriteUpdate(PdfOutputDevice& device, PdfSaveOptions options)
@@ -335,6 +341,7 @@ void PdfMemDocument::WriteUpdate(PdfOutputDevice& device, PdfSaveOptions options
     writer.SetSaveOptions(options);
     writer.SetPdfVersion( this->GetPdfVersion() );
     writer.SetWriteMode( m_eWriteMode );
+    writer.SetRealPrecision( m_nRealPrecision );
     writer.SetPrevXRefOffset(m_lPrevXRefOffset);
     writer.SetUseXRefStream(m_bSoureHasXRefStream);
     writer.SetIncrementalUpdate(m_bLinearized);
@@ -417,6 +424,14 @@ const PdfMemDocument & PdfMemDocument::InsertPages( const PdfMemDocument & rDoc,
     return *this;
 }
 
+void PdfMemDocument::SetRealPrecision( unsigned short nPrecision )
+{
+    if( nPrecision > utls::MaxRealPrecision )
+        PODOFO_RAISE_ERROR_INFO( EPdfError::ValueOutOfRange, "The real precision is too high" );
+
+    m_nRealPrecision = nPrecision;
+}
+
 void PdfMemDocument::SetEncrypted( const std::string & userPassword, const std::string & ownerPassword, 
                                    EPdfPermissions protection, EPdfEncryptAlgorithm eAlgorithm,
                                    EPdfKeyLength eKeyLength )
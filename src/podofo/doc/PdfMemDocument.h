@@ -228,6 +228,20 @@ public:
      */
     EPdfWriteMode GetWriteMode() const  override { return m_eWriteMode; }
 
+    /** Set the number of decimal digits used when writing real numbers.
+     *  Lower values produce smaller files, at the cost of accuracy.
+     *  The default is 6 and the maximum is 20
+     *
+     *  \param nPrecision the number of decimal digits
+     */
+    void SetRealPrecision( unsigned short nPrecision );
+
+    /**
+     *  \returns the number of decimal digits used when writing real numbers
+     *  \see SetRealPrecision
+     */
+    unsigned short GetRealPrecision() const { return m_nRealPrecision; }
+
     /** Set the PDF Version of the document. Has to be called before Write() to
      *  have an effect.
      *  \param eVersion  version of the pdf document
@@ -512,6 +526,7 @@ private:
     std::unique_ptr<PdfEncrypt> m_pEncrypt;
 
     EPdfWriteMode   m_eWriteMode;
+    unsigned short  m_nRealPrecision;
 
     bool m_bSoureHasXRefStream;
     EPdfVersion m_eSourceVersion;
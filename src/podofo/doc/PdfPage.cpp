@@ -65,18 +65,9 @@ PdfPage::PdfPage( const PdfRect & rSize, PdfVecObjects* pParent )
 PdfPage::PdfPage( PdfObject* pObject, const std::deque<PdfObject*> & rListOfParents )
     : PdfElement(*pObject), PdfCanvas(), m_pContents(nullptr)
 {
-    m_pResources = GetObject()->GetDictionary().FindKey( "Resources" );
-    if( !m_pResources ) 
-    {
-        // Resources might be inherited
-        std::deque<PdfObject*>::const_reverse_iterator it = rListOfParents.rbegin();
-
-        while( it != rListOfParents.rend() && !m_pResources )
-        {
-            m_pResources = (*it)->GetIndirectKey( "Resources" );
-            ++it;
-        }
-    }
+    // NOTE: The resources, which might be inherited from
+    // the parents, are looked up by GetResources()
+    (void)rListOfParents;
 
     PdfObject* contents = GetObject()->GetDictionary().FindKey("Contents");
     if (contents != nullptr)
@@ -120,10 +111,31 @@ void PdfPage::InitNewPage( const PdfRect & rSize )
     SetMediaBox(rSize);
 
     // The PDF specification suggests that we send all available PDF Procedure sets
-    this->GetObject()->GetDictionary().AddKey( "Resources", PdfObject( PdfDictionary() ) );
+    PdfObject& resources = this->GetObject()->GetDictionary().AddKey( "Resources", PdfObject( PdfDictionary() ) );
+    resources.GetDictionary().AddKey( "ProcSet", PdfCanvas::GetProcSet() );
+}
+
+PdfObject* PdfPage::GetResources() const
+{
+    // NOTE: Look up the resources every time, as the key may be
+    // replaced or inherited from the parents
+    const int maxRecursionDepth = 1000;
+    const PdfObject* pObject = this->GetObject();
+    for ( int depth = 0; pObject != nullptr && depth <= maxRecursionDepth; depth++ )
+    {
+        PdfObject* pResources = pObject->GetIndirectKey( "Resources" );
+        if ( pResources != nullptr )
+            return pResources;
+
+        // Resources might be inherited
+        PdfObject* pParent = pObject->GetIndirectKey( "Parent" );
+        if ( pParent == pObject )
+            break;
+
+        pObject = pParent;
+    }
 
-    m_pResources = this->GetObject()->GetIndirectKey( "Resources" );
-    m_pResources->GetDictionary().AddKey( "ProcSet", PdfCanvas::GetProcSet() );
+    return nullptr;
 }
 
 void PdfPage::EnsureContentsCreated() const
@@ -610,15 +622,16 @@ size_t PdfPage::GetPageNumber() const
 
 PdfObject* PdfPage::GetFromResources( const PdfName & rType, const PdfName & rKey )
 {
-    if( m_pResources == nullptr ) // Fix CVE-2017-7381
+    PdfObject* pResources = GetResources();
+    if( pResources == nullptr ) // Fix CVE-2017-7381
     {
         PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidHandle, "No Resources" );
     } 
-    if( m_pResources->GetDictionary().HasKey( rType ) ) 
+    if( pResources->GetDictionary().HasKey( rType ) ) 
     {
         // OC 15.08.2010 BugFix: Ghostscript creates here sometimes an indirect reference to a directory
-     // PdfObject* pType = m_pResources->GetDictionary().GetKey( rType );
-        PdfObject* pType = m_pResources->GetIndirectKey( rType );
+     // PdfObject* pType = pResources->GetDictionary().GetKey( rType );
+        PdfObject* pType = pResources->GetIndirectKey( rType );
         if( pType && pType->IsDictionary() && pType->GetDictionary().HasKey( rKey ) )
         {
             PdfObject* pObj = pType->GetDictionary().GetKey( rKey ); // CB 08.12.2017 Can be an array
@@ -157,7 +157,7 @@ class PODOFO_DOC_API PdfPage : public PdfElement, public PdfCanvas {
      *  This is most likely an internal object.
      *  \returns a resources object
      */
-    inline PdfObject* GetResources() const override;
+    PdfObject* GetResources() const override;
 
     /** Get the current MediaBox (physical page size) in PDF units.
      *  \returns PdfRect the page box
@@ -294,19 +294,10 @@ private:
 
  private:
     PdfContents*   m_pContents;
-    PdfObject*     m_pResources;
 
     TMapAnnotationDirect m_mapAnnotations;
 };
 
-// -----------------------------------------------------
-// 
-// -----------------------------------------------------
-inline PdfObject* PdfPage::GetResources() const
-{
-    return m_pResources;
-}
-
 // -----------------------------------------------------
 // 
 // -----------------------------------------------------
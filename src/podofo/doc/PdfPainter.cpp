@@ -71,8 +71,9 @@
 
 using namespace PoDoFo;
 
-static const long clPainterHighPrecision    = 15L;
-static const long clPainterDefaultPrecision = 3L;
+static const unsigned short clPainterHighPrecision    = 15;
+static const unsigned short clPainterDefaultPrecision = 3;
+static const size_t clPainterAppendSize = 64 * 1024;
 
 static inline unsigned short SwapBytes(unsigned short val)
 {
@@ -101,15 +102,10 @@ static inline bool IsSpaceChar(pdf_utf16be ch)
 PdfPainter::PdfPainter(EPdfPainterFlags flags)
 : m_flags(flags), m_stream( nullptr ), m_canvas( nullptr ), m_pFont( nullptr ),
   m_nTabWidth( 4 ), m_curColor( PdfColor( 0.0, 0.0, 0.0 ) ),
-  m_isTextOpen( false ), m_tmpStream(), m_curPath(), m_isCurColorICCDepend( false ), m_CSTag()
+  m_isTextOpen( false ), m_tmpStream(), m_curPath(), m_isAppending( false ), m_isCurColorICCDepend( false ), m_CSTag()
 {
-    m_tmpStream.flags( std::ios_base::fixed );
-    m_tmpStream.precision( clPainterDefaultPrecision );
-    PdfLocaleImbue(m_tmpStream);
-
-    m_curPath.flags( std::ios_base::fixed );
-    m_curPath.precision( clPainterDefaultPrecision );
-    PdfLocaleImbue(m_curPath);
+    m_tmpStream.SetPrecision( clPainterDefaultPrecision );
+    m_curPath.SetPrecision( clPainterDefaultPrecision );
 
     lpx  = 
     lpy  = 
@@ -146,6 +142,7 @@ void PdfPainter::SetCanvas( PdfCanvas* canvas )
         return;
 
     finishDrawing();
+    clearResources();
 
     m_canvas = canvas;
     m_stream = nullptr;
@@ -160,73 +157,102 @@ void PdfPainter::FinishDrawing()
     }
     catch (PdfError & e)
     {
-        // clean up, even in case of error
+        // clean up, even in case of error. The stream must not
+        // be left in appending mode, or it can't be used anymore
+        if (m_stream != nullptr && m_stream->IsAppending())
+        {
+            try
+            {
+                m_stream->EndAppend();
+            }
+            catch (PdfError&)
+            {
+                // Report the original error
+            }
+        }
+
+        m_tmpStream.Clear();
         m_stream = nullptr;
         m_canvas = nullptr;
+        m_isAppending = false;
+        clearResources();
 
         throw e;
     }
 
     m_stream = nullptr;
     m_canvas = nullptr;
+    clearResources();
     currentTextRenderingMode = EPdfTextRenderingMode::Fill;
 }
 
 void PdfPainter::finishDrawing()
 {
+    flushResources();
+
 	if ( m_stream )
     {
-        if ((m_flags & EPdfPainterFlags::NoSaveRestorePrior) == EPdfPainterFlags::NoSaveRestorePrior)
+        if ( !m_isAppending )
+            beginAppendContent();
+
+        endAppendContent();
+    }
+
+    // Reset temporary stream
+    m_tmpStream.Clear();
+    m_isAppending = false;
+}
+
+void PdfPainter::beginAppendContent()
+{
+    if ((m_flags & EPdfPainterFlags::NoSaveRestorePrior) == EPdfPainterFlags::NoSaveRestorePrior)
+    {
+        // GetLength() must be called before BeginAppend()
+        if (m_stream->GetLength() == 0)
         {
-            // GetLength() must be called before BeginAppend()
-            if (m_stream->GetLength() == 0)
-            {
-                m_stream->BeginAppend(false);
-            }
-            else
-            {
-                m_stream->BeginAppend(false);
-                // there is already content here - so let's assume we are appending
-                // as such, we MUST put in a "space" to separate whatever we do.
-                m_stream->Append("\n");
-            }
+            m_stream->BeginAppend(false);
         }
         else
         {
-            PdfMemoryOutputStream memstream;
-            if ( m_stream->GetLength() != 0 )
-                m_stream->GetFilteredCopy( &memstream );
-
-            size_t length = memstream.GetLength();
-            if ( length == 0 )
-            {
-                m_stream->BeginAppend( false );
-            }
-            else
-            {
-                m_stream->BeginAppend( true );
-                m_stream->Append( "q\n" );
-                m_stream->Append(memstream.GetBuffer(), length );
-                m_stream->Append( "Q\n" );
-            }
+            m_stream->BeginAppend(false);
+            // there is already content here - so let's assume we are appending
+            // as such, we MUST put in a "space" to separate whatever we do.
+            m_stream->Append("\n");
         }
+    }
+    else
+    {
+        PdfMemoryOutputStream memstream;
+        if ( m_stream->GetLength() != 0 )
+            m_stream->GetFilteredCopy( &memstream );
 
-        if ((m_flags & EPdfPainterFlags::NoSaveRestore) == EPdfPainterFlags::NoSaveRestore)
+        size_t length = memstream.GetLength();
+        if ( length == 0 )
         {
-            m_stream->Append(m_tmpStream.str());
+            m_stream->BeginAppend( false );
         }
         else
         {
-            m_stream->Append("q\n");
-            m_stream->Append(m_tmpStream.str());
-            m_stream->Append("Q\n");
+            m_stream->BeginAppend( true );
+            m_stream->Append( "q\n" );
+            m_stream->Append(memstream.GetBuffer(), length );
+            m_stream->Append( "Q\n" );
         }
-
-        m_stream->EndAppend();
     }
 
-    // Reset temporary stream
-    m_tmpStream.str("");
+    if ((m_flags & EPdfPainterFlags::NoSaveRestore) != EPdfPainterFlags::NoSaveRestore)
+        m_stream->Append("q\n");
+}
+
+void PdfPainter::endAppendContent()
+{
+    m_stream->Append(m_tmpStream.GetString());
+    m_tmpStream.Clear();
+
+    if ((m_flags & EPdfPainterFlags::NoSaveRestore) != EPdfPainterFlags::NoSaveRestore)
+        m_stream->Append("Q\n");
+
+    m_stream->EndAppend();
 }
 
 void PdfPainter::SetStrokingShadingPattern( const PdfShadingPattern & rPattern )
@@ -235,7 +261,7 @@ void PdfPainter::SetStrokingShadingPattern( const PdfShadingPattern & rPattern )
 
     this->AddToPageResources( rPattern.GetIdentifier(), rPattern.GetObject()->GetIndirectReference(), PdfName("Pattern") );
 
-    m_tmpStream << "/Pattern CS /" << rPattern.GetIdentifier().GetString() << " SCN" << std::endl;
+    m_tmpStream << "/Pattern CS /" << rPattern.GetIdentifier().GetString() << " SCN" << '\n';
 }
 
 void PdfPainter::SetShadingPattern( const PdfShadingPattern & rPattern )
@@ -244,7 +270,7 @@ void PdfPainter::SetShadingPattern( const PdfShadingPattern & rPattern )
 
     this->AddToPageResources( rPattern.GetIdentifier(), rPattern.GetObject()->GetIndirectReference(), PdfName("Pattern") );
 
-    m_tmpStream << "/Pattern cs /" << rPattern.GetIdentifier().GetString() << " scn" << std::endl;
+    m_tmpStream << "/Pattern cs /" << rPattern.GetIdentifier().GetString() << " scn" << '\n';
 }
 
 void PdfPainter::SetStrokingTilingPattern( const PdfTilingPattern & rPattern )
@@ -253,14 +279,14 @@ void PdfPainter::SetStrokingTilingPattern( const PdfTilingPattern & rPattern )
 
     this->AddToPageResources( rPattern.GetIdentifier(), rPattern.GetObject()->GetIndirectReference(), PdfName("Pattern") );
 
-    m_tmpStream << "/Pattern CS /" << rPattern.GetIdentifier().GetString() << " SCN" << std::endl;
+    m_tmpStream << "/Pattern CS /" << rPattern.GetIdentifier().GetString() << " SCN" << '\n';
 }
 
 void PdfPainter::SetStrokingTilingPattern( const std::string &rPatternName )
 {
     CheckStream();
 
-    m_tmpStream << "/Pattern CS /" << rPatternName << " SCN" << std::endl;
+    m_tmpStream << "/Pattern CS /" << rPatternName << " SCN" << '\n';
 }
 
 void PdfPainter::SetTilingPattern( const PdfTilingPattern & rPattern )
@@ -269,14 +295,14 @@ void PdfPainter::SetTilingPattern( const PdfTilingPattern & rPattern )
 
     this->AddToPageResources( rPattern.GetIdentifier(), rPattern.GetObject()->GetIndirectReference(), PdfName("Pattern") );
 
-    m_tmpStream << "/Pattern cs /" << rPattern.GetIdentifier().GetString() << " scn" << std::endl;
+    m_tmpStream << "/Pattern cs /" << rPattern.GetIdentifier().GetString() << " scn" << '\n';
 }
 
 void PdfPainter::SetTilingPattern( const std::string &rPatternName )
 {
     CheckStream();
 
-    m_tmpStream << "/Pattern cs /" << rPatternName << " scn" << std::endl;
+    m_tmpStream << "/Pattern cs /" << rPatternName << " scn" << '\n';
 }
 
 void PdfPainter::SetStrokingColor( const PdfColor & rColor )
@@ -290,21 +316,21 @@ void PdfPainter::SetStrokingColor( const PdfColor & rColor )
             m_tmpStream << rColor.GetRed()   << " "
                   << rColor.GetGreen() << " "
                   << rColor.GetBlue() 
-                  << " RG" << std::endl;
+                  << " RG" << '\n';
             break;
         case EPdfColorSpace::DeviceCMYK:
             m_tmpStream << rColor.GetCyan()    << " " 
                   << rColor.GetMagenta() << " " 
                   << rColor.GetYellow()  << " " 
                   << rColor.GetBlack() 
-                  << " K" << std::endl;
+                  << " K" << '\n';
             break;
         case EPdfColorSpace::DeviceGray:
-            m_tmpStream << rColor.GetGrayScale() << " G" << std::endl;
+            m_tmpStream << rColor.GetGrayScale() << " G" << '\n';
             break;
         case EPdfColorSpace::Separation:
 			m_canvas->AddColorResource( rColor );
-			m_tmpStream << "/ColorSpace" << PdfName( rColor.GetName() ).GetEscapedName() << " CS " << rColor.GetDensity() << " SCN" << std::endl;
+			m_tmpStream << "/ColorSpace" << PdfName( rColor.GetName() ).GetEscapedName() << " CS " << rColor.GetDensity() << " SCN" << '\n';
             break;
         case EPdfColorSpace::CieLab:
 			m_canvas->AddColorResource( rColor );
@@ -312,7 +338,7 @@ void PdfPainter::SetStrokingColor( const PdfColor & rColor )
 				  << rColor.GetCieL() << " " 
                   << rColor.GetCieA() << " " 
                   << rColor.GetCieB() <<
-				  " SCN" << std::endl;
+				  " SCN" << '\n';
             break;
         case EPdfColorSpace::Unknown:
         case EPdfColorSpace::Indexed:
@@ -336,21 +362,21 @@ void PdfPainter::SetColor( const PdfColor & rColor )
             m_tmpStream << rColor.GetRed()   << " "
                   << rColor.GetGreen() << " "
                   << rColor.GetBlue() 
-                  << " rg" << std::endl;
+                  << " rg" << '\n';
             break;
         case EPdfColorSpace::DeviceCMYK:
             m_tmpStream << rColor.GetCyan()    << " " 
                   << rColor.GetMagenta() << " " 
                   << rColor.GetYellow()  << " " 
                   << rColor.GetBlack() 
-                  << " k" << std::endl;
+                  << " k" << '\n';
             break;
         case EPdfColorSpace::DeviceGray:
-            m_tmpStream << rColor.GetGrayScale() << " g" << std::endl;
+            m_tmpStream << rColor.GetGrayScale() << " g" << '\n';
             break;
         case EPdfColorSpace::Separation:
 			m_canvas->AddColorResource( rColor );
-            m_tmpStream << "/ColorSpace" << PdfName( rColor.GetName() ).GetEscapedName() << " cs " << rColor.GetDensity() << " scn" << std::endl;
+            m_tmpStream << "/ColorSpace" << PdfName( rColor.GetName() ).GetEscapedName() << " cs " << rColor.GetDensity() << " scn" << '\n';
             break;
         case EPdfColorSpace::CieLab:
 			m_canvas->AddColorResource( rColor );
@@ -358,7 +384,7 @@ void PdfPainter::SetColor( const PdfColor & rColor )
 				  << rColor.GetCieL() << " " 
                   << rColor.GetCieA() << " " 
                   << rColor.GetCieB() <<
-				  " scn" << std::endl;
+				  " scn" << '\n';
 			break;
         case EPdfColorSpace::Unknown:
         case EPdfColorSpace::Indexed:
@@ -372,7 +398,7 @@ void PdfPainter::SetStrokeWidth( double dWidth )
 {
     CheckStream();
 
-    m_tmpStream << dWidth << " w" << std::endl;
+    m_tmpStream << dWidth << " w" << '\n';
 }
 
 void PdfPainter::SetStrokeStyle( EPdfStrokeStyle eStyle, const char* pszCustom, bool inverted, double scale, bool subtractJoinCap)
@@ -469,21 +495,21 @@ void PdfPainter::SetStrokeStyle( EPdfStrokeStyle eStyle, const char* pszCustom,
         m_tmpStream << "] 0";
     }
 
-    m_tmpStream << " d" << std::endl;
+    m_tmpStream << " d" << '\n';
 }
 
 void PdfPainter::SetLineCapStyle( EPdfLineCapStyle eCapStyle )
 {
     CheckStream();
 
-    m_tmpStream << static_cast<int>(eCapStyle) << " J" << std::endl;
+    m_tmpStream << static_cast<int>(eCapStyle) << " J" << '\n';
 }
 
 void PdfPainter::SetLineJoinStyle( EPdfLineJoinStyle eJoinStyle )
 {
     CheckStream();
 
-    m_tmpStream << static_cast<int>(eJoinStyle) << " j" << std::endl;
+    m_tmpStream << static_cast<int>(eJoinStyle) << " j" << '\n';
 }
 
 void PdfPainter::SetFont( PdfFont* pFont )
@@ -515,7 +541,7 @@ void PdfPainter::SetCurrentTextRenderingMode( void )
 {
     CheckStream();
 
-    m_tmpStream << (int) currentTextRenderingMode << " Tr" << std::endl;
+    m_tmpStream << (int) currentTextRenderingMode << " Tr" << '\n';
 }
 
 void PdfPainter::SetClipRect( double dX, double dY, double dWidth, double dHeight )
@@ -526,42 +552,42 @@ void PdfPainter::SetClipRect( double dX, double dY, double dWidth, double dHeigh
           << dY << " "
           << dWidth << " "
           << dHeight        
-          << " re W n" << std::endl;
+          << " re W n" << '\n';
 
 	 m_curPath
 			 << dX << " "
           << dY << " "
           << dWidth << " "
           << dHeight        
-          << " re W n" << std::endl;
+          << " re W n" << '\n';
 }
 
 void PdfPainter::SetMiterLimit(double value)
 {
     CheckStream();
 
-    m_tmpStream << value << " M" << std::endl;
+    m_tmpStream << value << " M" << '\n';
 }
 
 void PdfPainter::DrawLine( double dStartX, double dStartY, double dEndX, double dEndY )
 {
     CheckStream();
 
-	 m_curPath.str("");
+	 m_curPath.Clear();
     m_curPath
 		    << dStartX << " "
           << dStartY
           << " m "
           << dEndX << " "
           << dEndY        
-          << " l" << std::endl;
+          << " l" << '\n';
 
     m_tmpStream << dStartX << " "
           << dStartY
           << " m "
           << dEndX << " "
           << dEndY        
-          << " l S" << std::endl;
+          << " l S" << '\n';
 }
 
 void PdfPainter::Rectangle( double dX, double dY, double dWidth, double dHeight,
@@ -593,13 +619,13 @@ void PdfPainter::Rectangle( double dX, double dY, double dWidth, double dHeight,
               << dY << " "
               << dWidth << " "
               << dHeight        
-              << " re" << std::endl;
+              << " re" << '\n';
 
         m_tmpStream << dX << " "
             << dY << " "
             << dWidth << " "
             << dHeight        
-              << " re" << std::endl;
+              << " re" << '\n';
     }
 }
 
@@ -616,11 +642,11 @@ void PdfPainter::Ellipse( double dX, double dY, double dWidth, double dHeight )
     m_curPath
 			 << dPointX[0] << " "
           << dPointY[0]
-          << " m" << std::endl;
+          << " m" << '\n';
 
     m_tmpStream << dPointX[0] << " "
           << dPointY[0]
-          << " m" << std::endl;
+          << " m" << '\n';
 
     for( i=1;i<BEZIER_POINTS; i+=3 )
     {
@@ -631,7 +657,7 @@ void PdfPainter::Ellipse( double dX, double dY, double dWidth, double dHeight )
               << dPointY[i+1] << " "
               << dPointX[i+2] << " "
               << dPointY[i+2]    
-              << " c" << std::endl;
+              << " c" << '\n';
 
         m_tmpStream << dPointX[i] << " "
               << dPointY[i] << " "
@@ -639,7 +665,7 @@ void PdfPainter::Ellipse( double dX, double dY, double dWidth, double dHeight )
               << dPointY[i+1] << " "
               << dPointX[i+2] << " "
               << dPointY[i+2]    
-              << " c" << std::endl;
+              << " c" << '\n';
     }
 }
 
@@ -728,22 +754,22 @@ void PdfPainter::DrawText( double dX, double dY, const PdfString & sText, size_t
         this->Restore();
     }
     
-    m_tmpStream << "BT" << std::endl << "/" << m_pFont->GetIdentifier().GetString()
+    m_tmpStream << "BT" << '\n' << "/" << m_pFont->GetIdentifier().GetString()
           << " "  << m_pFont->GetFontSize()
-          << " Tf" << std::endl;
+          << " Tf" << '\n';
 
     if (currentTextRenderingMode != EPdfTextRenderingMode::Fill) {
         SetCurrentTextRenderingMode();
     }
 
     //if( m_pFont->GetFontScale() != 100.0F ) - this value is kept between text blocks
-    m_tmpStream << m_pFont->GetFontScale() << " Tz" << std::endl;
+    m_tmpStream << m_pFont->GetFontScale() << " Tz" << '\n';
 
     //if( m_pFont->GetFontCharSpace() != 0.0F )  - this value is kept between text blocks
-    m_tmpStream << m_pFont->GetFontCharSpace() * (double)m_pFont->GetFontSize() / 100.0 << " Tc" << std::endl;
+    m_tmpStream << m_pFont->GetFontCharSpace() * (double)m_pFont->GetFontSize() / 100.0 << " Tc" << '\n';
 
-    m_tmpStream << dX << std::endl
-          << dY << std::endl << "Td ";
+    m_tmpStream << dX << '\n'
+          << dY << '\n' << "Td ";
 
     m_pFont->WriteStringToStream( sString, m_tmpStream );
 
@@ -770,21 +796,21 @@ void PdfPainter::BeginText( double dX, double dY )
 
     this->AddToPageResources( m_pFont->GetIdentifier(), m_pFont->GetObject()->GetIndirectReference(), PdfName("Font") );
 
-    m_tmpStream << "BT" << std::endl << "/" << m_pFont->GetIdentifier().GetString()
+    m_tmpStream << "BT" << '\n' << "/" << m_pFont->GetIdentifier().GetString()
           << " "  << m_pFont->GetFontSize()
-          << " Tf" << std::endl;
+          << " Tf" << '\n';
 
     if (currentTextRenderingMode != EPdfTextRenderingMode::Fill) {
         SetCurrentTextRenderingMode();
     }
 
     //if( m_pFont->GetFontScale() != 100.0F ) - this value is kept between text blocks
-    m_tmpStream << m_pFont->GetFontScale() << " Tz" << std::endl;
+    m_tmpStream << m_pFont->GetFontScale() << " Tz" << '\n';
 
     //if( m_pFont->GetFontCharSpace() != 0.0F )  - this value is kept between text blocks
-    m_tmpStream << m_pFont->GetFontCharSpace() * (double)m_pFont->GetFontSize() / 100.0 << " Tc" << std::endl;
+    m_tmpStream << m_pFont->GetFontCharSpace() * (double)m_pFont->GetFontSize() / 100.0 << " Tc" << '\n';
 
-    m_tmpStream << dX << " " << dY << " Td" << std::endl ;
+    m_tmpStream << dX << " " << dY << " Td" << '\n' ;
 
 	m_isTextOpen = true;
 }
@@ -798,7 +824,7 @@ void PdfPainter::MoveTextPos( double dX, double dY )
         PODOFO_RAISE_ERROR( EPdfError::InvalidHandle );
     }
 
-    m_tmpStream << dX << " " << dY << " Td" << std::endl ;
+    m_tmpStream << dX << " " << dY << " Td" << '\n' ;
 }
 
 void PdfPainter::AddText( const PdfString & sText )
@@ -1248,21 +1274,22 @@ void PdfPainter::DrawXObject( double dX, double dY, const PdfXObject* pObject, d
     // already and is not in memory anymore in this case.
     this->AddToPageResources( pObject->GetIdentifier(), pObject->GetObjectReference(), "XObject" );
 
-	std::streamsize oldPrecision = m_tmpStream.precision(clPainterHighPrecision);
-    m_tmpStream << "q" << std::endl
+	unsigned short oldPrecision = m_tmpStream.GetPrecision();
+	m_tmpStream.SetPrecision(clPainterHighPrecision);
+    m_tmpStream << "q" << '\n'
           << dScaleX << " 0 0 "
           << dScaleY << " "
           << dX << " " 
-          << dY << " cm" << std::endl
-          << "/" << pObject->GetIdentifier().GetString() << " Do" << std::endl << "Q" << std::endl;
-	m_tmpStream.precision(oldPrecision);
+          << dY << " cm" << '\n'
+          << "/" << pObject->GetIdentifier().GetString() << " Do" << '\n' << "Q" << '\n';
+	m_tmpStream.SetPrecision(oldPrecision);
 }
 
 void PdfPainter::ClosePath()
 {
     CheckStream();
 
-	 m_curPath << "h" << std::endl;
+	 m_curPath << "h" << '\n';
 
      m_tmpStream << "h\n";
 }
@@ -1274,11 +1301,11 @@ void PdfPainter::LineTo( double dX, double dY )
 	 m_curPath
 			 << dX << " "
           << dY
-          << " l" << std::endl;
+          << " l" << '\n';
 
     m_tmpStream << dX << " "
           << dY
-          << " l" << std::endl;
+          << " l" << '\n';
 }
 
 void PdfPainter::MoveTo( double dX, double dY )
@@ -1288,11 +1315,11 @@ void PdfPainter::MoveTo( double dX, double dY )
     m_curPath
         << dX << " "
         << dY
-        << " m" << std::endl;
+        << " m" << '\n';
 
     m_tmpStream << dX << " "
           << dY
-          << " m" << std::endl;
+          << " m" << '\n';
 }
 
 void PdfPainter::CubicBezierTo( double dX1, double dY1, double dX2, double dY2, double dX3, double dY3 )
@@ -1306,7 +1333,7 @@ void PdfPainter::CubicBezierTo( double dX1, double dY1, double dX2, double dY2,
          << dY2 << " "
          << dX3 << " "
          << dY3 
-         << " c" << std::endl;
+         << " c" << '\n';
 
     m_tmpStream << dX1 << " "
           << dY1 << " "
@@ -1314,7 +1341,7 @@ void PdfPainter::CubicBezierTo( double dX1, double dY1, double dX2, double dY2,
           << dY2 << " "
           << dX3 << " "
           << dY3 
-          << " c" << std::endl;
+          << " c" << '\n';
 }
 
 void PdfPainter::HorizontalLineTo( double inX )
@@ -1587,7 +1614,7 @@ void PdfPainter::Close()
 {
     CheckStream();
 
-    m_curPath << "h" << std::endl;
+    m_curPath << "h" << '\n';
 
     m_tmpStream << "h\n";
 }
@@ -1596,7 +1623,7 @@ void PdfPainter::Stroke()
 {
     CheckStream();
 
-    m_curPath.str("");
+    m_curPath.Clear();
 
     m_tmpStream << "S\n";
 }
@@ -1605,7 +1632,7 @@ void PdfPainter::Fill(bool useEvenOddRule)
 {
     CheckStream();
 
-    m_curPath.str("");
+    m_curPath.Clear();
 
     if (useEvenOddRule)
         m_tmpStream << "f*\n";
@@ -1617,7 +1644,7 @@ void PdfPainter::FillAndStroke(bool useEvenOddRule)
 {
     CheckStream();
 
-    m_curPath.str("");
+    m_curPath.Clear();
 
     if (useEvenOddRule)
         m_tmpStream << "B*\n";
@@ -1639,7 +1666,7 @@ void PdfPainter::EndPath(void)
 {
     CheckStream();
 
-    m_curPath << "n" << std::endl;
+    m_curPath << "n" << '\n';
 
     m_tmpStream << "n\n";
 }
@@ -1665,7 +1692,27 @@ void PdfPainter::AddToPageResources( const PdfName & rIdentifier, const PdfRefer
         PODOFO_RAISE_ERROR( EPdfError::InvalidHandle );
     }
 
-    m_canvas->AddResource( rIdentifier, rRef, rName );
+    // Touch the resource dictionary only once per identifier,
+    // the pending resources are added by finishDrawing()
+    if ( m_registeredResources.emplace( rName, rIdentifier ).second )
+        m_pendingResources.push_back( { rIdentifier, rRef, rName } );
+}
+
+void PdfPainter::flushResources()
+{
+    if ( m_canvas != nullptr )
+    {
+        for ( auto& resource : m_pendingResources )
+            m_canvas->AddResource( resource.Identifier, resource.Ref, resource.Name );
+    }
+
+    m_pendingResources.clear();
+}
+
+void PdfPainter::clearResources()
+{
+    m_registeredResources.clear();
+    m_pendingResources.clear();
 }
 
 void PdfPainter::ConvertRectToBezier( double dX, double dY, double dWidth, double dHeight, double pdPointX[], double pdPointY[] )
@@ -1720,7 +1767,7 @@ void PdfPainter::SetCurrentStrokingColor()
         m_tmpStream << m_curColor.GetRed()   << " "
               << m_curColor.GetGreen() << " "
               << m_curColor.GetBlue()
-              << " SC" << std::endl;
+              << " SC" << '\n';
     }
     else
     {
@@ -1733,14 +1780,15 @@ void PdfPainter::SetTransformationMatrix( double a, double b, double c, double d
     CheckStream();
 
 	// Need more precision for transformation-matrix !!
-	std::streamsize oldPrecision = m_tmpStream.precision(clPainterHighPrecision);
+	unsigned short oldPrecision = m_tmpStream.GetPrecision();
+	m_tmpStream.SetPrecision(clPainterHighPrecision);
     m_tmpStream << a << " "
           << b << " "
           << c << " "
           << d << " "
           << e << " "
-          << f << " cm" << std::endl;
-	m_tmpStream.precision(oldPrecision);
+          << f << " cm" << '\n';
+	m_tmpStream.SetPrecision(oldPrecision);
 }
 
 void PdfPainter::SetExtGState( PdfExtGState* inGState )
@@ -1750,7 +1798,7 @@ void PdfPainter::SetExtGState( PdfExtGState* inGState )
     this->AddToPageResources( inGState->GetIdentifier(), inGState->GetObject()->GetIndirectReference(), PdfName("ExtGState") );
     
     m_tmpStream << "/" << inGState->GetIdentifier().GetString()
-          << " gs" << std::endl;
+          << " gs" << '\n';
 }
 
 void PdfPainter::SetRenderingIntent( char* intent )
@@ -1758,7 +1806,7 @@ void PdfPainter::SetRenderingIntent( char* intent )
     CheckStream();
 
     m_tmpStream << "/" << intent
-          << " ri" << std::endl;
+          << " ri" << '\n';
 }
 
 void PdfPainter::SetDependICCProfileColor( const PdfColor &rColor, const std::string &pCSTag )
@@ -1771,7 +1819,7 @@ void PdfPainter::SetDependICCProfileColor( const PdfColor &rColor, const std::st
     m_tmpStream << rColor.GetRed()   << " "
           << rColor.GetGreen() << " "
           << rColor.GetBlue()
-          << " sc" << std::endl;
+          << " sc" << '\n';
 }
 
 template<typename C>
@@ -1854,20 +1902,36 @@ PdfString PdfPainter::ExpandTabs( const PdfString & rsString, ssize_t lStringLen
 void PdfPainter::CheckStream()
 {
     if (m_stream != nullptr)
+    {
+        // Hand the content to the stream filters in big chunks
+        if (m_isAppending && m_tmpStream.GetSize() >= clPainterAppendSize)
+        {
+            m_stream->Append(m_tmpStream.GetString());
+            m_tmpStream.Clear();
+        }
+
         return;
+    }
 
     PODOFO_RAISE_LOGIC_IF(m_canvas == nullptr, "Call SetCanvas() first before doing drawing operations.");
-    m_stream = &m_canvas->GetStreamForAppending((EPdfStreamAppendFlags)(m_flags & (~EPdfPainterFlags::NoSaveRestore)));
+    m_stream = &m_canvas->GetStreamForAppending((EPdfStreamAppendFlags)(m_flags
+        & (EPdfPainterFlags::Prepend | EPdfPainterFlags::NoSaveRestorePrior)));
+
+    if ((m_flags & EPdfPainterFlags::Incremental) == EPdfPainterFlags::Incremental)
+    {
+        beginAppendContent();
+        m_isAppending = true;
+    }
 }
 
 void PdfPainter::SetPrecision(unsigned short inPrec)
 {
-    m_tmpStream.precision(inPrec);
+    m_tmpStream.SetPrecision(inPrec);
 }
 
 unsigned short PdfPainter::GetPrecision() const
 {
-    return static_cast<unsigned short>(m_tmpStream.precision());
+    return m_tmpStream.GetPrecision();
 }
 
 void PdfPainter::SetClipRect(const PdfRect& rRect)
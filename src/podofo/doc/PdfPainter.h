@@ -40,9 +40,13 @@
 
 #include "podofo/base/PdfRect.h"
 #include "podofo/base/PdfColor.h"
+#include "podofo/base/PdfName.h"
+#include "podofo/base/PdfReference.h"
 #include <podofo/base/PdfCanvas.h>
+#include <podofo/base/PdfStringStream.h>
 
-#include <sstream>
+#include <set>
+#include <vector>
 
 namespace PoDoFo {
 
@@ -50,9 +54,7 @@ class PdfExtGState;
 class PdfFont;
 class PdfImage;
 class PdfMemDocument;
-class PdfName;
 class PdfObject;
-class PdfReference;
 class PdfShadingPattern;
 class PdfStream;
 class PdfString;
@@ -74,6 +76,11 @@ enum class EPdfPainterFlags
     /** Does nothing for now
      */
     RawCoordinates = 8,
+    /** Append the content to the canvas stream, and compress it, while
+     *  drawing, instead of keeping it in memory until FinishDrawing().
+     *  The canvas stream can't be accessed until FinishDrawing() is called
+     */
+    Incremental = 16,
 };
 
 /**
@@ -719,13 +726,13 @@ public:
 
     /** Get current path string stream.
      * Stroke/Fill commands clear current path.
-     * \returns std::ostringstream representing current path
+     * \returns PdfStringStream representing current path
      */
-    inline std::ostringstream &GetCurrentPath(void) { return m_curPath; }
+    inline PdfStringStream &GetCurrentPath(void) { return m_curPath; }
 
     /** Get current temporary stream
      */
-    inline std::ostringstream & GetStream() { return m_tmpStream; }
+    inline PdfStringStream & GetStream() { return m_tmpStream; }
 
     /** Set rgb color that depend on color space setting, "cs" tag.
      *
@@ -759,6 +766,10 @@ public:
 
     /** Register an object in the resource dictionary of this page
      *  so that it can be used for any following drawing operations.
+     *
+     *  Only the first registration of an identifier in a painting
+     *  session is recorded; the resource dictionary is updated
+     *  once by FinishDrawing().
      *  
      *  \param rIdentifier identifier of this object, e.g. /Ft0
      *  \param rRef reference to the object you want to register
@@ -797,6 +808,10 @@ public:
  private:
     void CheckStream();
     void finishDrawing();
+    void beginAppendContent();
+    void endAppendContent();
+    void flushResources();
+    void clearResources();
 
  protected:
      EPdfPainterFlags m_flags;
@@ -831,11 +846,30 @@ public:
 
     /** temporary stream buffer 
      */
-    std::ostringstream  m_tmpStream;
+    PdfStringStream  m_tmpStream;
 
     /** current path
      */
-    std::ostringstream  m_curPath;
+    PdfStringStream  m_curPath;
+
+    /** True if the content is being appended to m_stream while drawing
+     */
+    bool m_isAppending;
+
+    /** Resource category and identifier pairs already
+     *  registered on the current canvas
+     */
+    std::set<std::pair<PdfName, PdfName>> m_registeredResources;
+
+    /** Resources not yet added to the canvas resource dictionary
+     */
+    struct PendingResource
+    {
+        PdfName Identifier;
+        PdfReference Ref;
+        PdfName Name;
+    };
+    std::vector<PendingResource> m_pendingResources;
 
     /** True if should use color with ICC Profile
      */
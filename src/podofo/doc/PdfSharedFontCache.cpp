@@ -0,0 +1,169 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the PoDoFo developers                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License as       *
+ *   published by the Free Software Foundation; either version 2 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this program; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ *   In addition, as a special exception, the copyright holders give       *
+ *   permission to link the code of portions of this program with the      *
+ *   OpenSSL library under certain conditions as described in each         *
+ *   individual source file, and distribute linked combinations            *
+ *   including the two.                                                    *
+ *   You must obey the GNU General Public License in all respects          *
+ *   for all of the code used other than OpenSSL.  If you modify           *
+ *   file(s) with this exception, you may extend this exception to your    *
+ *   version of the file(s), but you are not obligated to do so.  If you   *
+ *   do not wish to do so, delete this exception statement from your       *
+ *   version.  If you delete this exception statement from all source      *
+ *   files in the program, then also delete it here.                       *
+ ***************************************************************************/
+
+#include "PdfSharedFontCache.h"
+
+#include "base/PdfDefinesPrivate.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace PoDoFo {
+
+atomic<bool> PdfSharedFontCache::s_bEnabled( false );
+
+PdfSharedFontFile::PdfSharedFontFile( const string& sFilename )
+    : m_sFilename( sFilename ), m_pData( nullptr ), m_lSize( 0 ), m_bMapped( false )
+{
+#ifndef WIN32
+    int fd = ::open( sFilename.c_str(), O_RDONLY | O_CLOEXEC );
+    if( fd == -1 )
+        PODOFO_RAISE_ERROR_INFO( EPdfError::FileNotFound, sFilename.c_str() );
+
+    struct stat st;
+    if( fstat( fd, &st ) != 0 || st.st_size == 0 )
+    {
+        ::close( fd );
+        PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidDeviceOperation, sFilename.c_str() );
+    }
+
+    void* pData = mmap( nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+    if( pData == MAP_FAILED )
+        PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidDeviceOperation, sFilename.c_str() );
+
+    m_pData = static_cast<char*>(pData);
+    m_lSize = static_cast<size_t>(st.st_size);
+    m_bMapped = true;
+#else
+    auto stream = io::open_ifstream( sFilename, ios_base::in | ios_base::binary );
+    if( stream.fail() )
+        PODOFO_RAISE_ERROR_INFO( EPdfError::FileNotFound, sFilename.c_str() );
+
+    size_t lSize = io::FileSize( sFilename );
+    m_pData = static_cast<char*>(podofo_malloc( lSize ));
+    if( m_pData == nullptr )
+        PODOFO_RAISE_ERROR( EPdfError::OutOfMemory );
+
+    if( io::Read( stream, m_pData, lSize ) != lSize )
+    {
+        podofo_free( m_pData );
+        PODOFO_RAISE_ERROR_INFO( EPdfError::InvalidDeviceOperation, sFilename.c_str() );
+    }
+
+    m_lSize = lSize;
+#endif
+}
+
+PdfSharedFontFile::~PdfSharedFontFile()
+{
+#ifndef WIN32
+    if( m_bMapped )
+    {
+        munmap( m_pData, m_lSize );
+        return;
+    }
+#endif
+    podofo_free( m_pData );
+}
+
+PdfSharedFontCache::PdfSharedFontCache() { }
+
+PdfSharedFontCache& PdfSharedFontCache::GetInstance()
+{
+    static PdfSharedFontCache cache;
+    return cache;
+}
+
+void PdfSharedFontCache::SetEnabled( bool bEnabled )
+{
+    s_bEnabled = bEnabled;
+}
+
+bool PdfSharedFontCache::IsEnabled()
+{
+    return s_bEnabled;
+}
+
+bool PdfSharedFontCache::TryGetFontPath( const char* pszFontName, bool bBold, bool bItalic, string& rsPath ) const
+{
+    unique_lock<mutex> lock( m_mutex );
+    auto found = m_mapPaths.find( TFontPathKey( pszFontName, bBold, bItalic ) );
+    if( found == m_mapPaths.end() )
+        return false;
+
+    rsPath = found->second;
+    return true;
+}
+
+void PdfSharedFontCache::AddFontPath( const char* pszFontName, bool bBold, bool bItalic, const string& sPath )
+{
+    unique_lock<mutex> lock( m_mutex );
+    m_mapPaths[TFontPathKey( pszFontName, bBold, bItalic )] = sPath;
+}
+
+shared_ptr<const PdfSharedFontFile> PdfSharedFontCache::GetFontFile( const string& sFilename )
+{
+    unique_lock<mutex> lock( m_mutex );
+    auto& file = m_mapFiles[sFilename];
+    if( file == nullptr )
+    {
+        // NOTE: The file is loaded with the lock held, so
+        // concurrent requests for it don't load it twice
+        try
+        {
+            file.reset( new PdfSharedFontFile( sFilename ) );
+        }
+        catch( PdfError& )
+        {
+            m_mapFiles.erase( sFilename );
+            throw;
+        }
+    }
+
+    return file;
+}
+
+void PdfSharedFontCache::Clear()
+{
+    unique_lock<mutex> lock( m_mutex );
+    m_mapPaths.clear();
+    m_mapFiles.clear();
+}
+
+};
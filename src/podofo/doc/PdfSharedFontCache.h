@@ -0,0 +1,153 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the PoDoFo developers                           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License as       *
+ *   published by the Free Software Foundation; either version 2 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this program; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ *                                                                         *
+ *   In addition, as a special exception, the copyright holders give       *
+ *   permission to link the code of portions of this program with the      *
+ *   OpenSSL library under certain conditions as described in each         *
+ *   individual source file, and distribute linked combinations            *
+ *   including the two.                                                    *
+ *   You must obey the GNU General Public License in all respects          *
+ *   for all of the code used other than OpenSSL.  If you modify           *
+ *   file(s) with this exception, you may extend this exception to your    *
+ *   version of the file(s), but you are not obligated to do so.  If you   *
+ *   do not wish to do so, delete this exception statement from your       *
+ *   version.  If you delete this exception statement from all source      *
+ *   files in the program, then also delete it here.                       *
+ ***************************************************************************/
+
+#ifndef _PDF_SHARED_FONT_CACHE_H_
+#define _PDF_SHARED_FONT_CACHE_H_
+
+#include "podofo/base/PdfDefines.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace PoDoFo {
+
+/** The read only contents of a font file, shared by all
+ *  the documents using the font. On POSIX systems the file
+ *  is memory mapped, otherwise it is read in memory.
+ *
+ *  \see PdfSharedFontCache
+ */
+class PODOFO_DOC_API PdfSharedFontFile
+{
+    friend class PdfSharedFontCache;
+
+private:
+    PdfSharedFontFile( const std::string& sFilename );
+
+public:
+    ~PdfSharedFontFile();
+
+    inline const char* GetData() const { return m_pData; }
+
+    inline size_t GetSize() const { return m_lSize; }
+
+    inline const std::string& GetFilename() const { return m_sFilename; }
+
+private:
+    PdfSharedFontFile( const PdfSharedFontFile& ) = delete;
+    PdfSharedFontFile& operator=( const PdfSharedFontFile& ) = delete;
+
+private:
+    std::string m_sFilename;
+    char* m_pData;
+    size_t m_lSize;
+    bool m_bMapped;     ///< True if m_pData is a memory mapping
+};
+
+/** A process wide cache of resolved font paths and of
+ *  font files, which can be shared by many documents,
+ *  also on different threads.
+ *
+ *  The cache is disabled by default. When enabled, PdfFontCache
+ *  resolves font names and loads TrueType/OpenType font files
+ *  through it, so they are read only once per process. Each
+ *  document still creates its own FreeType face and metrics,
+ *  as those are not thread safe and carry per font state.
+ *
+ *  \see PdfFontCache
+ */
+class PODOFO_DOC_API PdfSharedFontCache
+{
+private:
+    PdfSharedFontCache();
+
+public:
+    /** \returns the process wide instance of the cache
+     */
+    static PdfSharedFontCache& GetInstance();
+
+    /** Enable or disable the use of the cache by PdfFontCache.
+     *  Fonts already created by a document are not affected
+     *  \param bEnabled if true, fonts are loaded through the cache
+     */
+    static void SetEnabled( bool bEnabled );
+
+    /** \returns true if the cache is used by PdfFontCache
+     */
+    static bool IsEnabled();
+
+    /** Look up the path of a font resolved before
+     *  \param pszFontName name of the font
+     *  \param bBold if true look for a bold font
+     *  \param bItalic if true look for an italic font
+     *  \param rsPath the cached path, empty if the font was not found
+     *  \returns false if the font was never resolved
+     */
+    bool TryGetFontPath( const char* pszFontName, bool bBold, bool bItalic, std::string& rsPath ) const;
+
+    /** Store the resolved path of a font
+     *  \param pszFontName name of the font
+     *  \param bBold true for a bold font
+     *  \param bItalic true for an italic font
+     *  \param sPath the path of the font file, may be empty
+     */
+    void AddFontPath( const char* pszFontName, bool bBold, bool bItalic, const std::string& sPath );
+
+    /** Get the contents of a font file, loading it
+     *  the first time it is requested
+     *  \param sFilename path of the font file
+     *  \returns the shared font file
+     */
+    std::shared_ptr<const PdfSharedFontFile> GetFontFile( const std::string& sFilename );
+
+    /** Remove all the paths and files from the cache. Files still
+     *  used by some fonts are released when the fonts are deleted
+     */
+    void Clear();
+
+private:
+    typedef std::tuple<std::string, bool, bool> TFontPathKey;
+
+    mutable std::mutex m_mutex;
+    std::map<TFontPathKey, std::string> m_mapPaths;
+    std::map<std::string, std::shared_ptr<const PdfSharedFontFile>> m_mapFiles;
+
+    static std::atomic<bool> s_bEnabled;
+};
+
+};
+
+#endif // _PDF_SHARED_FONT_CACHE_H_
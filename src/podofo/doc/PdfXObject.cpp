@@ -54,7 +54,7 @@ using namespace std;
 using namespace PoDoFo;
 
 PdfXObject::PdfXObject( const PdfRect & rRect, PdfDocument* pParent, const char* pszPrefix, bool bWithoutIdentifier )
-    : PdfElement(*pParent, "XObject"), PdfCanvas(), m_rRect( rRect ), m_pResources( nullptr )
+    : PdfElement(*pParent, "XObject"), PdfCanvas(), m_rRect( rRect )
 {
     InitXObject( rRect, pszPrefix );
     if( bWithoutIdentifier )
@@ -64,13 +64,13 @@ PdfXObject::PdfXObject( const PdfRect & rRect, PdfDocument* pParent, const char*
 }
 
 PdfXObject::PdfXObject( const PdfRect & rRect, PdfVecObjects* pParent, const char* pszPrefix )
-    : PdfElement(*pParent, "XObject"), PdfCanvas(), m_rRect( rRect ), m_pResources( nullptr )
+    : PdfElement(*pParent, "XObject"), PdfCanvas(), m_rRect( rRect )
 {
     InitXObject( rRect, pszPrefix );
 }
 
 PdfXObject::PdfXObject( const PdfDocument & rDoc, int nPage, PdfDocument* pParent, const char* pszPrefix, bool bUseTrimBox )
-    : PdfElement(*pParent, "XObject"), PdfCanvas(), m_pResources( nullptr )
+    : PdfElement(*pParent, "XObject"), PdfCanvas()
 {
     m_rRect = PdfRect();
 
@@ -89,7 +89,7 @@ PdfXObject::PdfXObject( const PdfDocument & rDoc, int nPage, PdfDocument* pParen
 }
 
 PdfXObject::PdfXObject( PdfDocument *pDoc, int nPage, const char* pszPrefix, bool bUseTrimBox )
-    : PdfElement(*pDoc, "XObject"), PdfCanvas(), m_pResources( nullptr )
+    : PdfElement(*pDoc, "XObject"), PdfCanvas()
 {
     m_rRect = PdfRect();
 
@@ -102,17 +102,16 @@ PdfXObject::PdfXObject( PdfDocument *pDoc, int nPage, const char* pszPrefix, boo
 }
 
 PdfXObject::PdfXObject(PdfObject* pObject)
-    : PdfElement(*pObject), PdfCanvas(), m_pResources(nullptr)
+    : PdfElement(*pObject), PdfCanvas()
 {
     InitIdentifiers(getPdfXObjectType(*pObject));
-    m_pResources = pObject->GetIndirectKey("Resources");
 
     if (this->GetObject()->GetIndirectKey("BBox"))
         m_rRect = PdfRect(this->GetObject()->GetIndirectKey("BBox")->GetArray());
 }
 
 PdfXObject::PdfXObject(EPdfXObject subType, PdfDocument* pParent, const char* pszPrefix)
-    : PdfElement(*pParent, "XObject"), m_pResources(nullptr)
+    : PdfElement(*pParent, "XObject")
 {
     InitIdentifiers(subType, pszPrefix);
 
@@ -120,7 +119,7 @@ PdfXObject::PdfXObject(EPdfXObject subType, PdfDocument* pParent, const char* ps
 }
 
 PdfXObject::PdfXObject(EPdfXObject subType, PdfVecObjects* pParent, const char* pszPrefix)
-    : PdfElement(*pParent, "XObject"), m_pResources(nullptr)
+    : PdfElement(*pParent, "XObject")
 {
     InitIdentifiers(subType, pszPrefix);
 
@@ -128,7 +127,7 @@ PdfXObject::PdfXObject(EPdfXObject subType, PdfVecObjects* pParent, const char*
 }
 
 PdfXObject::PdfXObject(EPdfXObject subType, PdfObject* pObject)
-    : PdfElement(*pObject), m_pResources(nullptr)
+    : PdfElement(*pObject)
 {
     if (getPdfXObjectType(*pObject) != subType)
     {
@@ -308,7 +307,7 @@ void PdfXObject::SetRect( const PdfRect & rect )
 
 void PdfXObject::EnsureResourcesInitialized()
 {
-    if ( m_pResources == nullptr )
+    if ( GetResources() == nullptr )
         InitResources();
 
     // A Form XObject must have a stream
@@ -372,12 +371,12 @@ void PdfXObject::InitIdentifiers(EPdfXObject subType, const char * pszPrefix)
 void PdfXObject::InitResources()
 {
     // The PDF specification suggests that we send all available PDF Procedure sets
-    this->GetObject()->GetDictionary().AddKey("Resources", PdfObject(PdfDictionary()));
-    m_pResources = this->GetObject()->GetDictionary().GetKey("Resources");
-    m_pResources->GetDictionary().AddKey("ProcSet", PdfCanvas::GetProcSet());
+    PdfObject& resources = this->GetObject()->GetDictionary().AddKey("Resources", PdfObject(PdfDictionary()));
+    resources.GetDictionary().AddKey("ProcSet", PdfCanvas::GetProcSet());
 }
 
 PdfObject* PdfXObject::GetResources() const
 {
-    return m_pResources;
+    // NOTE: Look up the resources every time, as the key may be replaced
+    return this->GetObject()->GetIndirectKey("Resources");
 }
@@ -181,7 +181,6 @@ public:
 private:
     EPdfXObject      m_type;
     PdfArray         m_matrix;
-    PdfObject*       m_pResources;
     PdfName          m_Identifier;
     PdfReference     m_Reference;
 };
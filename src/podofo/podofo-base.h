@@ -60,7 +60,9 @@
 #include "base/PdfInputDevice.h"
 #include "base/PdfInputStream.h"
 #include "base/PdfLocale.h"
+#include "base/PdfMemoryArena.h"
 #include "base/PdfMemoryManagement.h"
+#include "base/PdfMemoryMappedInputDevice.h"
 #include "base/PdfMemStream.h"
 #include "base/PdfName.h"
 #include "base/PdfObject.h"
@@ -75,6 +77,7 @@
 #include "base/PdfSigner.h"
 #include "base/PdfStream.h"
 #include "base/PdfString.h"
+#include "base/PdfStringStream.h"
 #include "base/PdfTokenizer.h"
 #include "base/PdfVariant.h"
 #include "base/PdfVecObjects.h"
@@ -54,6 +54,7 @@
 #include "doc/PdfAnnotation.h"
 #include "doc/PdfCMapEncoding.h"
 #include "doc/PdfContents.h"
+#include "doc/PdfDecodedStreamCache.h"
 #include "doc/PdfDestination.h"
 #include "doc/PdfDifferenceEncoding.h"
 #include "doc/PdfDocument.h"
@@ -89,6 +90,7 @@
 #include "doc/PdfPagesTree.h"
 #include "doc/PdfPainter.h"
 #include "doc/PdfShadingPattern.h"
+#include "doc/PdfSharedFontCache.h"
 #include "doc/PdfSignatureField.h"
 #include "doc/PdfStreamedDocument.h"
 #include "doc/PdfTable.h"
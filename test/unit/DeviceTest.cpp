@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include "DeviceTest.h"
+#include "TestUtils.h"
 #include <podofo.h>
 
 #include <stdio.h>
@@ -120,3 +121,94 @@ void DeviceTest::testDevices()
     
 }
 
+void DeviceTest::testSpanDevices()
+{
+    const std::string_view testString = "Hello World Buffer!";
+
+    PdfInputDevice copied( testString.data(), testString.length() );
+    testSpanDevice( copied, testString );
+
+    PdfInputDevice borrowed( testString.data(), testString.length(), false );
+    CPPUNIT_ASSERT( borrowed.GetSpan().data() == testString.data() );
+    testSpanDevice( borrowed, testString );
+
+    std::string filename = TestUtils::getTempFilename();
+    {
+        PdfOutputDevice output( filename );
+        output.Write( testString.data(), testString.length() );
+    }
+
+    {
+        PdfMemoryMappedInputDevice mapped( filename );
+        testSpanDevice( mapped, testString );
+    }
+
+    TestUtils::deleteFile( filename.c_str() );
+}
+
+void DeviceTest::testFileOutputDevice()
+{
+    // Many small writes, bigger than the internal write buffer
+    std::string expected;
+    for ( int i = 0; i < 100000; i++ )
+        expected += "obj " + std::to_string( i ) + "\n";
+
+    std::string filename = TestUtils::getTempFilename();
+    {
+        PdfOutputDevice output( filename );
+        for ( size_t i = 0; i < expected.length(); i += 7 )
+            output.Write( expected.data() + i, std::min( static_cast<size_t>(7), expected.length() - i ) );
+
+        CPPUNIT_ASSERT_EQUAL( expected.length(), output.GetLength() );
+
+        // Overwrite some data and read it back
+        output.Seek( 4 );
+        output.Write( "X", 1 );
+        expected[4] = 'X';
+        output.Seek( 0 );
+        char buffer[8];
+        CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(8), output.Read( buffer, 8 ) );
+        CPPUNIT_ASSERT( std::string( buffer, 8 ) == expected.substr( 0, 8 ) );
+        output.Flush();
+    }
+
+    {
+        // Append to the existing file
+        PdfOutputDevice output( filename, false );
+        CPPUNIT_ASSERT_EQUAL( expected.length(), output.Tell() );
+        output.Print( "%%%%EOF\n" );
+        expected += "%%EOF\n";
+    }
+
+    {
+        PdfMemoryMappedInputDevice mapped( filename );
+        CPPUNIT_ASSERT( mapped.GetSpan() == expected );
+    }
+
+    TestUtils::deleteFile( filename.c_str() );
+}
+
+void DeviceTest::testSpanDevice( PdfInputDevice& device, const std::string_view& expected )
+{
+    CPPUNIT_ASSERT( device.HasSpan() );
+    CPPUNIT_ASSERT( device.GetSpan() == expected );
+
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(expected[0]), device.Look() );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(expected[0]), device.GetChar() );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(1), device.Tell() );
+
+    device.Seek( -1, std::ios_base::end );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(expected.back()), device.GetChar() );
+    CPPUNIT_ASSERT( !device.Eof() );
+    CPPUNIT_ASSERT_EQUAL( -1, device.Look() );
+    CPPUNIT_ASSERT( device.Eof() );
+
+    char buffer[64];
+    device.Seek( 0 );
+    CPPUNIT_ASSERT_EQUAL( expected.length(), device.Read( buffer, sizeof( buffer ) ) );
+    CPPUNIT_ASSERT( std::string_view( buffer, expected.length() ) == expected );
+    CPPUNIT_ASSERT( device.Eof() );
+
+    // The span must be unaffected by the position of the device
+    CPPUNIT_ASSERT( device.GetSpan() == expected );
+}
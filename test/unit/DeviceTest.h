@@ -23,16 +23,25 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <podofo.h>
+
 class DeviceTest : public CppUnit::TestFixture
 {
     CPPUNIT_TEST_SUITE( DeviceTest );
     CPPUNIT_TEST( testDevices );
+    CPPUNIT_TEST( testSpanDevices );
+    CPPUNIT_TEST( testFileOutputDevice );
     CPPUNIT_TEST_SUITE_END();
 public:
     void setUp();
     void tearDown();
 
     void testDevices();
+    void testSpanDevices();
+    void testFileOutputDevice();
+
+private:
+    void testSpanDevice( PoDoFo::PdfInputDevice& device, const std::string_view& expected );
 };
 
 #endif // _DEVICE_TEST_H_
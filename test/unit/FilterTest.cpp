@@ -23,6 +23,7 @@
 #include <cppunit/Asserter.h>
 
 #include <stdlib.h>
+#include <zlib.h>
 
 using namespace PoDoFo;
 
@@ -132,3 +133,307 @@ void FilterTest::testCCITT()
 
 
 }
+
+void FilterTest::testFilteredInputStream()
+{
+    std::string data;
+    for( int i = 0; i < 100000; i++ )
+        data += std::to_string( i ) + " 0 0 1 re f\n";
+
+    PdfMemDocument doc;
+    TVecFilters vecFilters;
+    vecFilters.push_back( EPdfFilter::ASCIIHexDecode );
+    vecFilters.push_back( EPdfFilter::FlateDecode );
+    PdfObject* pFiltered = doc.GetObjects().CreateDictionaryObject();
+    pFiltered->GetOrCreateStream().Set( data, vecFilters );
+    PdfObject* pPlain = doc.GetObjects().CreateDictionaryObject();
+    pPlain->GetOrCreateStream().Set( data, TVecFilters() );
+
+    PdfObject* pObjects[] = { pFiltered, pPlain };
+    for( PdfObject* pObject : pObjects )
+    {
+        // Read with small chunks, so that the filters are fed many times
+        PdfFilteredInputStream stream( pObject->GetOrCreateStream(), 1000 );
+        std::string decoded;
+        char buffer[777];
+        bool eof = false;
+        while( !eof )
+            decoded.append( buffer, stream.Read( buffer, sizeof( buffer ), eof ) );
+
+        CPPUNIT_ASSERT_EQUAL( data.size(), decoded.size() );
+        CPPUNIT_ASSERT( data == decoded );
+        CPPUNIT_ASSERT( stream.Eof() );
+    }
+}
+
+void FilterTest::testFlateSettings()
+{
+    std::string data;
+    for( int i = 0; i < 20000; i++ )
+        data += std::to_string( i * 7919 % 10007 ) + " 0 0 1 re f\n";
+
+    PdfMemDocument doc;
+    TVecFilters vecFilters;
+    vecFilters.push_back( EPdfFilter::FlateDecode );
+
+    PdfFlateSettings fast;
+    fast.Level = 1;
+    PdfFlateSettings best;
+    best.Level = 9;
+    doc.GetObjects().SetFlateSettings( fast );
+
+    PdfObject* pFast = doc.GetObjects().CreateDictionaryObject();
+    pFast->GetOrCreateStream().Set( data, vecFilters );
+    PdfObject* pBest = doc.GetObjects().CreateDictionaryObject();
+    pBest->GetOrCreateStream().SetFlateSettings( best );
+    pBest->GetOrCreateStream().Set( data, vecFilters );
+    PdfObject* pStored = doc.GetObjects().CreateDictionaryObject();
+    PdfFlateSettings stored;
+    stored.Level = 0;
+    pStored->GetOrCreateStream().SetFlateSettings( stored );
+    pStored->GetOrCreateStream().Set( data, vecFilters );
+
+    CPPUNIT_ASSERT_EQUAL( 1, pFast->GetOrCreateStream().GetFlateSettings().Level );
+    CPPUNIT_ASSERT_EQUAL( 9, pBest->GetOrCreateStream().GetFlateSettings().Level );
+    CPPUNIT_ASSERT( pBest->GetOrCreateStream().GetLength() < pFast->GetOrCreateStream().GetLength() );
+    CPPUNIT_ASSERT( pStored->GetOrCreateStream().GetLength() > data.size() );
+
+    PdfObject* pObjects[] = { pFast, pBest, pStored };
+    for( PdfObject* pObject : pObjects )
+    {
+        std::unique_ptr<char> pBuffer;
+        size_t lLen;
+        pObject->GetOrCreateStream().GetFilteredCopy( pBuffer, lLen );
+        CPPUNIT_ASSERT( data == std::string( pBuffer.get(), lLen ) );
+    }
+
+    pBest->GetOrCreateStream().ResetFlateSettings();
+    CPPUNIT_ASSERT_EQUAL( 1, pBest->GetOrCreateStream().GetFlateSettings().Level );
+
+    PdfFlateSettings invalid;
+    invalid.Level = 10;
+    CPPUNIT_ASSERT_THROW( pBest->GetOrCreateStream().SetFlateSettings( invalid ), PdfError );
+    CPPUNIT_ASSERT_THROW( doc.GetObjects().SetFlateSettings( invalid ), PdfError );
+    CPPUNIT_ASSERT_EQUAL( 1, doc.GetObjects().GetFlateSettings().Level );
+}
+
+void FilterTest::testFlatePredictors()
+{
+    // A RGB gradient, 8 and 16 bits per component
+    const int nColumns = 301;
+    const int nRows = 64;
+    std::string data8;
+    std::string data16;
+    for( int y = 0; y < nRows; y++ )
+    {
+        for( int x = 0; x < nColumns; x++ )
+        {
+            for( int c = 0; c < 3; c++ )
+            {
+                int nValue = ( x * ( c + 1 ) + y * 3 ) & 0xFFFF;
+                data8 += static_cast<char>( nValue & 0xFF );
+                data16 += static_cast<char>( nValue >> 8 );
+                data16 += static_cast<char>( nValue & 0xFF );
+            }
+        }
+    }
+
+    PdfMemDocument doc;
+    TVecFilters vecFilters;
+    vecFilters.push_back( EPdfFilter::FlateDecode );
+
+    PdfObject* pPlain = doc.GetObjects().CreateDictionaryObject();
+    pPlain->GetOrCreateStream().Set( data8, vecFilters );
+
+    EPdfPredictor predictors[] = { EPdfPredictor::PngNone, EPdfPredictor::PngSub, EPdfPredictor::PngUp,
+                                   EPdfPredictor::PngAverage, EPdfPredictor::PngPaeth, EPdfPredictor::PngOptimum };
+    for( EPdfPredictor ePredictor : predictors )
+    {
+        for( int nBPC : { 8, 16 } )
+        {
+            const std::string& data = nBPC == 8 ? data8 : data16;
+            PdfFlateSettings settings;
+            settings.Predictor = ePredictor;
+            settings.Colors = 3;
+            settings.BitsPerComponent = nBPC;
+            settings.Columns = nColumns;
+
+            PdfObject* pObject = doc.GetObjects().CreateDictionaryObject();
+            pObject->GetOrCreateStream().SetFlateSettings( settings );
+            pObject->GetOrCreateStream().Set( data, vecFilters );
+
+            const PdfObject* pDecodeParms = pObject->GetDictionary().GetKey( "DecodeParms" );
+            CPPUNIT_ASSERT( pDecodeParms != nullptr );
+            CPPUNIT_ASSERT_EQUAL( static_cast<int64_t>(ePredictor), pDecodeParms->GetDictionary().GetKeyAsNumber( "Predictor" ) );
+
+            std::unique_ptr<char> pBuffer;
+            size_t lLen;
+            pObject->GetOrCreateStream().GetFilteredCopy( pBuffer, lLen );
+            CPPUNIT_ASSERT( data == std::string( pBuffer.get(), lLen ) );
+
+            if( ePredictor == EPdfPredictor::PngOptimum && nBPC == 8 )
+                CPPUNIT_ASSERT( pObject->GetOrCreateStream().GetLength() < pPlain->GetOrCreateStream().GetLength() / 2 );
+        }
+    }
+
+    // The data must be made of whole rows
+    PdfFlateSettings settings;
+    settings.Predictor = EPdfPredictor::PngUp;
+    settings.Columns = 7;
+    PdfObject* pObject = doc.GetObjects().CreateDictionaryObject();
+    pObject->GetOrCreateStream().SetFlateSettings( settings );
+    CPPUNIT_ASSERT_THROW( pObject->GetOrCreateStream().Set( "12345678", vecFilters ), PdfError );
+
+    // Predictors depend on the data of each stream
+    CPPUNIT_ASSERT_THROW( doc.GetObjects().SetFlateSettings( settings ), PdfError );
+    CPPUNIT_ASSERT( doc.GetObjects().GetFlateSettings().Predictor == EPdfPredictor::None );
+}
+
+#ifdef PODOFO_HAVE_PNG_LIB
+static std::string getRawCopy( const PdfStream& rStream )
+{
+    char* pBuffer;
+    size_t lLen;
+    rStream.GetCopy( &pBuffer, &lLen );
+    std::string copy( pBuffer, lLen );
+    podofo_free( pBuffer );
+    return copy;
+}
+
+static void appendPngUInt32( std::string& rPng, uint32_t nValue )
+{
+    rPng += static_cast<char>( nValue >> 24 );
+    rPng += static_cast<char>( ( nValue >> 16 ) & 0xFF );
+    rPng += static_cast<char>( ( nValue >> 8 ) & 0xFF );
+    rPng += static_cast<char>( nValue & 0xFF );
+}
+
+static void appendPngChunk( std::string& rPng, const char* pszType, const std::string& rData )
+{
+    std::string chunk( pszType );
+    chunk += rData;
+    appendPngUInt32( rPng, static_cast<uint32_t>(rData.size()) );
+    rPng += chunk;
+    appendPngUInt32( rPng, static_cast<uint32_t>(crc32( 0, reinterpret_cast<const Bytef*>(chunk.data()),
+                                                         static_cast<uInt>(chunk.size()) )) );
+}
+
+void FilterTest::testPngPassthrough()
+{
+    const int nWidth = 50;
+    const int nHeight = 20;
+    PdfMemDocument doc;
+    TVecFilters vecFilters;
+    vecFilters.push_back( EPdfFilter::FlateDecode );
+
+    // Create a RGB PNG, with alpha channel if nColors is 4, and get its IDAT data
+    auto createPng = [&]( const std::string& pixels, int nColors, int nDepth, const std::string& trns, std::string& idat )
+    {
+        // The IDAT data is a Flate stream with PNG predictors
+        PdfFlateSettings settings;
+        settings.Predictor = EPdfPredictor::PngOptimum;
+        settings.Colors = nColors;
+        settings.BitsPerComponent = nDepth;
+        settings.Columns = nWidth;
+        PdfObject* pObject = doc.GetObjects().CreateDictionaryObject();
+        pObject->GetOrCreateStream().SetFlateSettings( settings );
+        pObject->GetOrCreateStream().Set( pixels, vecFilters );
+
+        idat = getRawCopy( pObject->GetOrCreateStream() );
+
+        std::string ihdr;
+        appendPngUInt32( ihdr, nWidth );
+        appendPngUInt32( ihdr, nHeight );
+        ihdr += static_cast<char>( nDepth );
+        ihdr += static_cast<char>( nColors == 3 ? 2 : 6 );
+        ihdr += std::string( 3, '\0' );
+
+        std::string png( "\x89PNG\r\n\x1a\n", 8 );
+        appendPngChunk( png, "IHDR", ihdr );
+        if( !trns.empty() )
+            appendPngChunk( png, "tRNS", trns );
+
+        // Split the data in two IDAT chunks
+        appendPngChunk( png, "IDAT", idat.substr( 0, idat.size() / 2 ) );
+        appendPngChunk( png, "IDAT", idat.substr( idat.size() / 2 ) );
+        appendPngChunk( png, "IEND", std::string() );
+        return png;
+    };
+
+    // PNG color type 2 (RGB) and 6 (RGB with alpha)
+    for( int nColors : { 3, 4 } )
+    {
+        std::string pixels;
+        std::string rgb;
+        for( int i = 0; i < nWidth * nHeight; i++ )
+        {
+            for( int c = 0; c < nColors; c++ )
+            {
+                char value = static_cast<char>( i * ( c + 1 ) );
+                pixels += value;
+                if( c < 3 )
+                    rgb += value;
+            }
+        }
+
+        std::string idat;
+        std::string png = createPng( pixels, nColors, 8, std::string(), idat );
+
+        PdfImage image( &doc );
+        image.LoadFromPngData( reinterpret_cast<const unsigned char*>(png.data()), png.size() );
+        CPPUNIT_ASSERT_EQUAL( static_cast<double>(nWidth), image.GetWidth() );
+        CPPUNIT_ASSERT_EQUAL( static_cast<double>(nHeight), image.GetHeight() );
+        CPPUNIT_ASSERT( image.GetImageColorSpace() == EPdfColorSpace::DeviceRGB );
+
+        // Images without alpha channel are embedded without being decoded
+        PdfStream& rStream = image.GetObject()->GetOrCreateStream();
+        CPPUNIT_ASSERT_EQUAL( nColors == 3, idat == getRawCopy( rStream ) );
+        if( nColors == 3 )
+        {
+            const PdfObject* pDecodeParms = image.GetObject()->GetDictionary().GetKey( "DecodeParms" );
+            CPPUNIT_ASSERT( pDecodeParms != nullptr );
+            CPPUNIT_ASSERT_EQUAL( static_cast<int64_t>(15), pDecodeParms->GetDictionary().GetKeyAsNumber( "Predictor" ) );
+            CPPUNIT_ASSERT_EQUAL( static_cast<int64_t>(nWidth), pDecodeParms->GetDictionary().GetKeyAsNumber( "Columns" ) );
+        }
+
+        std::unique_ptr<char> pBuffer;
+        size_t lLen;
+        rStream.GetFilteredCopy( pBuffer, lLen );
+        CPPUNIT_ASSERT( rgb == std::string( pBuffer.get(), lLen ) );
+    }
+
+    // 16 bits per component are embedded as is only from PDF 1.5
+    std::string pixels16;
+    for( int i = 0; i < nWidth * nHeight * 3; i++ )
+    {
+        pixels16 += static_cast<char>( i >> 8 );
+        pixels16 += static_cast<char>( i & 0xFF );
+    }
+
+    std::string idat16;
+    std::string png16 = createPng( pixels16, 3, 16, std::string(), idat16 );
+    for( EPdfVersion eVersion : { EPdfVersion::V1_4, EPdfVersion::V1_5 } )
+    {
+        doc.SetPdfVersion( eVersion );
+        PdfImage image( &doc );
+        image.LoadFromPngData( reinterpret_cast<const unsigned char*>(png16.data()), png16.size() );
+        CPPUNIT_ASSERT_EQUAL( eVersion == EPdfVersion::V1_5, idat16 == getRawCopy( image.GetObject()->GetOrCreateStream() ) );
+    }
+
+    // Images with a transparent color are decoded
+    std::string idatTrns;
+    std::string pngTrns = createPng( pixels16, 3, 16, std::string( 6, '\0' ), idatTrns );
+    PdfImage image( &doc );
+    image.LoadFromPngData( reinterpret_cast<const unsigned char*>(pngTrns.data()), pngTrns.size() );
+    CPPUNIT_ASSERT( idatTrns != getRawCopy( image.GetObject()->GetOrCreateStream() ) );
+
+    // A truncated IDAT chunk claiming a huge length is rejected
+    std::string pngTruncated = png16.substr( 0, 8 + 25 );
+    appendPngUInt32( pngTruncated, 0x7FFFFFFF );
+    pngTruncated += "IDAT";
+    pngTruncated += idat16.substr( 0, 16 );
+    PdfImage truncatedImage( &doc );
+    CPPUNIT_ASSERT_THROW( truncatedImage.LoadFromPngData( reinterpret_cast<const unsigned char*>(pngTruncated.data()),
+        pngTruncated.size() ), PdfError );
+}
+#endif // PODOFO_HAVE_PNG_LIB
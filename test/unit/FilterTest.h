@@ -32,6 +32,12 @@ class FilterTest : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE( FilterTest );
   CPPUNIT_TEST( testFilters );
   CPPUNIT_TEST( testCCITT );
+  CPPUNIT_TEST( testFilteredInputStream );
+  CPPUNIT_TEST( testFlateSettings );
+  CPPUNIT_TEST( testFlatePredictors );
+#ifdef PODOFO_HAVE_PNG_LIB
+  CPPUNIT_TEST( testPngPassthrough );
+#endif // PODOFO_HAVE_PNG_LIB
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -42,6 +48,13 @@ class FilterTest : public CppUnit::TestFixture
 
   void testCCITT();
 
+  void testFilteredInputStream();
+  void testFlateSettings();
+  void testFlatePredictors();
+#ifdef PODOFO_HAVE_PNG_LIB
+  void testPngPassthrough();
+#endif // PODOFO_HAVE_PNG_LIB
+
  private:
   void TestFilter( PoDoFo::EPdfFilter eFilter, const char * pTestBuffer, const long lTestLength );
 };
@@ -22,6 +22,8 @@
 
 #include <cppunit/Asserter.h>
 
+#include <fstream>
+
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
@@ -144,6 +146,86 @@ void FontTest::testCreateFontFtFace()
     }
 }
 
+void FontTest::testUnicodeCharWidth()
+{
+    PdfFont* pFont = m_pDoc->CreateFont( "LiberationSans" );
+    CPPUNIT_ASSERT( pFont != NULL );
+
+    PdfFontMetrics* pMetrics = pFont->GetFontMetrics2();
+    pMetrics->SetFontSize( 1000.0f );
+    pMetrics->SetFontScale( 100.0f );
+    pMetrics->SetFontCharSpace( 0.0f );
+
+    // Cyrillic, CJK and a code point missing from the font, which gets
+    // the .notdef width, each requested twice to read the cached widths
+
+    const unsigned short ranges[][2] = { { 0x0400, 0x04FF }, { 0x4E00, 0x4E10 }, { 0xFFF0, 0xFFF0 } };
+    for ( int pass = 0; pass < 2; pass++ )
+    {
+        for ( auto& range : ranges )
+        {
+            for ( unsigned c = range[0]; c <= range[1]; c++ )
+            {
+                long lGlyph = pMetrics->GetGlyphId( static_cast<long>( c ) );
+                double dExpected = pMetrics->GetGlyphWidth( static_cast<int>( lGlyph ) );
+                CPPUNIT_ASSERT_DOUBLES_EQUAL( dExpected, pMetrics->UnicodeCharWidth( static_cast<unsigned short>( c ) ), 1e-9 );
+            }
+        }
+    }
+}
+
+void FontTest::testSharedFontCache()
+{
+    PdfSharedFontCache::SetEnabled( true );
+    PdfMemDocument doc1;
+    PdfMemDocument doc2;
+    PdfFont* pFont1 = doc1.CreateFont( "LiberationSans" );
+    PdfFont* pFont2 = doc2.CreateFontSubset( "LiberationSans", false, false );
+    PdfSharedFontCache::SetEnabled( false );
+    PdfFont* pFont3 = m_pDoc->CreateFont( "LiberationSans" );
+
+    CPPUNIT_ASSERT( pFont1 != NULL && pFont2 != NULL && pFont3 != NULL );
+
+    // Both documents use the same file data
+    const PdfFontMetrics* pMetrics1 = pFont1->GetFontMetrics();
+    const PdfFontMetrics* pMetrics3 = pFont3->GetFontMetrics();
+    CPPUNIT_ASSERT( pMetrics1->GetFontData() != NULL );
+    CPPUNIT_ASSERT( pMetrics1->GetFontData() == pFont2->GetFontMetrics()->GetFontData() );
+    CPPUNIT_ASSERT_EQUAL( std::string( pMetrics3->GetFilename() ), std::string( pMetrics1->GetFilename() ) );
+    std::ifstream file( pMetrics3->GetFilename(), std::ios_base::binary | std::ios_base::ate );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( file.tellg() ), pMetrics1->GetFontDataLen() );
+
+    // Fonts loaded from the shared file have the same metrics
+    CPPUNIT_ASSERT( pMetrics1->GetFontname() == std::string( pMetrics3->GetFontname() ) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( pMetrics3->StringWidth( "Hello World" ), pMetrics1->StringWidth( "Hello World" ), 1e-9 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( pMetrics3->GetLineSpacing(), pMetrics1->GetLineSpacing(), 1e-9 );
+
+    PdfSharedFontCache::GetInstance().Clear();
+}
+
+void FontTest::testFontCacheLookup()
+{
+    PdfFont* pFont = m_pDoc->CreateFont( "LiberationSans" );
+    CPPUNIT_ASSERT( pFont != NULL );
+
+    // The same request returns the cached font
+    CPPUNIT_ASSERT( m_pDoc->CreateFont( "LiberationSans" ) == pFont );
+    CPPUNIT_ASSERT( m_pDoc->CreateFont( "LiberationSans", false, false ) == pFont );
+
+    // Different styles and encodings are different fonts
+    PdfFont* pBold = m_pDoc->CreateFont( "LiberationSans", true, false );
+    PdfFont* pMacRoman = m_pDoc->CreateFont( "LiberationSans", false,
+        PdfEncodingFactory::GlobalMacRomanEncodingInstance() );
+    CPPUNIT_ASSERT( pBold != NULL && pBold != pFont );
+    CPPUNIT_ASSERT( pMacRoman != NULL && pMacRoman != pFont );
+    CPPUNIT_ASSERT( m_pDoc->CreateFont( "LiberationSans", false,
+        PdfEncodingFactory::GlobalMacRomanEncodingInstance() ) == pMacRoman );
+
+    // Fonts are found by their object as well
+    CPPUNIT_ASSERT( m_pDoc->GetFont( pFont->GetObject() ) == pFont );
+    CPPUNIT_ASSERT( m_pDoc->GetFont( pBold->GetObject() ) == pBold );
+}
+
 bool FontTest::GetFontInfo( FcPattern* pFont, std::string & rsFamily, std::string & rsPath, 
                             bool & rbBold, bool & rbItalic )
 {
@@ -37,6 +37,9 @@ class FontTest : public CppUnit::TestFixture
 #if defined(PODOFO_HAVE_FONTCONFIG)
   CPPUNIT_TEST( testFonts );
   CPPUNIT_TEST( testCreateFontFtFace );
+  CPPUNIT_TEST( testUnicodeCharWidth );
+  CPPUNIT_TEST( testSharedFontCache );
+  CPPUNIT_TEST( testFontCacheLookup );
 #endif
   CPPUNIT_TEST_SUITE_END();
 
@@ -47,6 +50,9 @@ class FontTest : public CppUnit::TestFixture
 #if defined(PODOFO_HAVE_FONTCONFIG)
   void testFonts();
   void testCreateFontFtFace();
+  void testUnicodeCharWidth();
+  void testSharedFontCache();
+  void testFontCacheLookup();
 #endif
 
 private:
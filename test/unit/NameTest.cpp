@@ -120,6 +120,33 @@ void NameTest::testFromEscaped()
     TestFromEscape( "Length#20With#20Spaces", "Length With Spaces" );
 }
 
+void NameTest::testInterning()
+{
+    CPPUNIT_ASSERT( PdfName::KeyType.IsInterned() );
+    CPPUNIT_ASSERT( PdfName::KeyNull.IsInterned() );
+    CPPUNIT_ASSERT( PdfName( "Length" ).IsInterned() );
+    CPPUNIT_ASSERT( PdfName::FromEscaped( "Filter" ).IsInterned() );
+    CPPUNIT_ASSERT( PdfName::FromEscaped( "#46ilter" ).IsInterned() );
+    CPPUNIT_ASSERT( !PdfName( "NotAWellKnownName" ).IsInterned() );
+
+    // Interned and not interned names still compare by value
+    CPPUNIT_ASSERT( PdfName::FromEscaped( "Type" ) == PdfName::KeyType );
+    CPPUNIT_ASSERT( PdfName( "NotAWellKnownName" ) == PdfName::FromEscaped( "NotAWellKnownName" ) );
+    CPPUNIT_ASSERT( PdfName( "Type" ) < PdfName( "Typf" ) );
+    CPPUNIT_ASSERT_EQUAL( PdfName::FromEscaped( "Type" ).GetString(), std::string( "Type" ) );
+
+    // Moved-from names are left valid and empty
+    PdfName moved( "NotAWellKnownName" );
+    PdfName target( std::move( moved ) );
+    CPPUNIT_ASSERT( target == PdfName( "NotAWellKnownName" ) );
+    CPPUNIT_ASSERT( moved == PdfName() );
+    CPPUNIT_ASSERT_EQUAL( moved.GetString(), std::string() );
+
+    moved = std::move( target );
+    CPPUNIT_ASSERT( moved == PdfName( "NotAWellKnownName" ) );
+    CPPUNIT_ASSERT( target == PdfName() );
+}
+
 //
 // Test encoding of names.
 // pszString : internal representation, ie unencoded name
@@ -34,6 +34,7 @@ class NameTest : public CppUnit::TestFixture
   CPPUNIT_TEST( testEquality );
   CPPUNIT_TEST( testWrite );
   CPPUNIT_TEST( testFromEscaped );
+  CPPUNIT_TEST( testInterning );
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -46,6 +47,7 @@ class NameTest : public CppUnit::TestFixture
   void testEquality();
   void testWrite();
   void testFromEscaped();
+  void testInterning();
 
  private:
 
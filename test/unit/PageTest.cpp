@@ -76,3 +76,117 @@ void PageTest::testEmptyContentsStream()
     TestUtils::deleteFile( sFilename.c_str() );
 }
 
+void PageTest::testDecodedStreamCache()
+{
+    // Three pages sharing a form XObject
+    PdfMemDocument doc;
+    PdfObject* pForm = doc.GetObjects().CreateDictionaryObject();
+    pForm->GetDictionary().AddKey( PdfName::KeyType, PdfName( "XObject" ) );
+    pForm->GetDictionary().AddKey( PdfName::KeySubtype, PdfName( "Form" ) );
+    pForm->GetOrCreateStream().Set( "0 0 10 10 re f" );
+    for( int i = 0; i < 3; i++ )
+    {
+        PdfPage* pPage = doc.CreatePage( PdfPage::CreateStandardPageSize( EPdfPageSize::A4 ) );
+        PdfObject* pContents = doc.GetObjects().CreateDictionaryObject();
+        pContents->GetOrCreateStream().Set( "/Fm0 Do " + std::to_string( i ) );
+        pPage->GetObject()->GetDictionary().AddKey( "Contents", pContents->GetIndirectReference() );
+        PdfDictionary xobjects;
+        xobjects.AddKey( "Fm0", pForm->GetIndirectReference() );
+        pPage->GetResources()->GetDictionary().AddKey( "XObject", xobjects );
+    }
+
+    PdfDecodedStreamCache cache( doc );
+    cache.DecodePages( 0, 3, 4 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(4), cache.GetCount() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "0 0 10 10 re f" ), *cache.GetDecoded( pForm->GetIndirectReference() ) );
+    PdfReference contentsRef = doc.GetPage( 1 )->GetContents()->GetIndirectReference();
+    CPPUNIT_ASSERT_EQUAL( std::string( "/Fm0 Do 1" ), *cache.GetDecoded( contentsRef ) );
+
+    // Changing a stream drops its cached data
+    pForm->GetOrCreateStream().Set( "0 0 20 20 re f" );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(3), cache.GetCount() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "0 0 20 20 re f" ), *cache.GetDecoded( pForm->GetIndirectReference() ) );
+
+    // The least recently used streams are evicted first
+    size_t lSize = cache.GetSize();
+    cache.SetMaxSize( lSize - 1 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(3), cache.GetCount() );
+    CPPUNIT_ASSERT( cache.GetSize() < lSize );
+    cache.SetMaxSize( 14 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(1), cache.GetCount() );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(14), cache.GetSize() );
+
+    // Removing an object drops its cached data
+    PdfReference formRef = pForm->GetIndirectReference();
+    std::unique_ptr<PdfObject> pRemoved = doc.GetObjects().RemoveObject( formRef );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(0), cache.GetCount() );
+    CPPUNIT_ASSERT( cache.GetDecoded( formRef ) == nullptr );
+
+    CPPUNIT_ASSERT( cache.GetDecoded( PdfReference( 9999, 0 ) ) == nullptr );
+
+    // Decode parameters referencing objects not loaded yet
+    std::string pdf;
+    PdfReference streamRef;
+    {
+        PdfMemDocument predictorDoc;
+        PdfObject* pColumns = predictorDoc.GetObjects().CreateObject( PdfVariant( static_cast<int64_t>(3) ) );
+        PdfObject* pStream = predictorDoc.GetObjects().CreateDictionaryObject();
+        TVecFilters filters = { EPdfFilter::FlateDecode };
+        // Two rows with the PNG Up predictor
+        pStream->GetOrCreateStream().Set( "\x02" "abc" "\x02\x00\x00\x00", 8, filters );
+        PdfDictionary parms;
+        parms.AddKey( "Predictor", static_cast<int64_t>(12) );
+        parms.AddKey( "Columns", pColumns->GetIndirectReference() );
+        pStream->GetDictionary().AddKey( "DecodeParms", parms );
+        streamRef = pStream->GetIndirectReference();
+
+        PdfRefCountedBuffer buffer;
+        PdfOutputDevice device( &buffer );
+        predictorDoc.Write( device );
+        pdf.assign( buffer.GetBuffer(), device.GetLength() );
+    }
+
+    PdfMemDocument loadedDoc;
+    loadedDoc.LoadFromBuffer( pdf );
+    PdfDecodedStreamCache loadedCache( loadedDoc );
+    loadedCache.Decode( { streamRef }, 2 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(1), loadedCache.GetCount() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "abcabc" ), *loadedCache.GetDecoded( streamRef ) );
+}
+
+void PageTest::testDirectContentsArray()
+{
+    std::string pdf;
+    {
+        PdfMemDocument doc;
+        PdfPage* pPage = doc.CreatePage( PdfPage::CreateStandardPageSize( EPdfPageSize::A4 ) );
+        PdfObject* pStream = doc.GetObjects().CreateDictionaryObject();
+        pStream->GetOrCreateStream().Set( "0 0 10 10 re f" );
+        PdfArray contents;
+        contents.push_back( pStream->GetIndirectReference() );
+        pPage->GetObject()->GetDictionary().AddKey( "Contents", contents );
+
+        PdfRefCountedBuffer buffer;
+        PdfOutputDevice device( &buffer );
+        doc.Write( device );
+        pdf.assign( buffer.GetBuffer(), device.GetLength() );
+    }
+
+    PdfMemDocument doc;
+    doc.LoadFromBuffer( pdf );
+    PdfPage* pPage = doc.GetPage( 0 );
+    PdfObject* pContents = pPage->GetContents();
+    CPPUNIT_ASSERT( pContents != nullptr && pContents->IsArray() );
+
+    // Adding /Annots, which is sorted before /Contents, leaves the
+    // direct /Contents array used by the page where it was
+    pPage->CreateAnnotation( EPdfAnnotation::Link, PdfRect( 0.0, 0.0, 10.0, 10.0 ) );
+    CPPUNIT_ASSERT( pPage->GetObject()->GetDictionary().GetKey( "Contents" ) == pContents );
+
+    PdfPainter painter;
+    painter.SetCanvas( pPage );
+    painter.DrawLine( 0.0, 0.0, 10.0, 10.0 );
+    painter.FinishDrawing();
+    CPPUNIT_ASSERT( pPage->GetContents() == pContents );
+    CPPUNIT_ASSERT( pContents->GetArray().GetSize() > 1 );
+}
@@ -70,3 +70,61 @@ void PainterTest::testAppend()
 
     this->CompareStreamContent(pPage->GetContents()->GetStream(), newContent.c_str());
 }
+
+static std::string drawRectangles( PdfMemDocument& doc, EPdfPainterFlags flags )
+{
+    PdfPage* pPage = doc.CreatePage( PdfPage::CreateStandardPageSize( EPdfPageSize::A4 ) );
+    PdfPainter painter( flags );
+    painter.SetCanvas( pPage );
+    for ( int i = 0; i < 20000; i++ )
+    {
+        painter.SetColor( PdfColor( i / 20000.0, 0.5, 0.25 ) );
+        painter.Rectangle( i * 0.1, i * 0.2, 10, 20 );
+        painter.Fill();
+    }
+    painter.FinishDrawing();
+
+    PdfObject* pContents = pPage->GetObject()->GetDictionary().FindKey( "Contents" );
+    if ( pContents->IsArray() )
+        pContents = doc.GetObjects().GetObject( pContents->GetArray()[0].GetReference() );
+
+    std::unique_ptr<char> pBuffer;
+    size_t lLen;
+    pContents->GetStream()->GetFilteredCopy( pBuffer, lLen );
+    return std::string( pBuffer.get(), lLen );
+}
+
+void PainterTest::testIncremental()
+{
+    PdfMemDocument doc;
+    std::string content = drawRectangles( doc, EPdfPainterFlags::None );
+    std::string incremental = drawRectangles( doc, EPdfPainterFlags::Incremental );
+
+    CPPUNIT_ASSERT( content.length() > 1024 * 1024 );
+    CPPUNIT_ASSERT( content == incremental );
+    const std::string expected = "q\n0.000 0.500 0.250 rg\n0.000 0.000 10.000 20.000 re\nf\n";
+    CPPUNIT_ASSERT( content.compare( 0, expected.length(), expected ) == 0 );
+}
+
+void PainterTest::testResources()
+{
+    PdfMemDocument doc;
+    PdfPage* pPage = doc.CreatePage( PdfPage::CreateStandardPageSize( EPdfPageSize::A4 ) );
+    PdfXObject xObj1( PdfRect( 0, 0, 10, 10 ), &doc );
+    PdfXObject xObj2( PdfRect( 0, 0, 20, 20 ), &doc );
+
+    PdfPainter painter;
+    painter.SetCanvas( pPage );
+    for ( int i = 0; i < 1000; i++ )
+    {
+        painter.DrawXObject( i, i, &xObj1 );
+        painter.DrawXObject( i, i, &xObj2 );
+    }
+    painter.FinishDrawing();
+
+    const PdfObject* pXObjects = pPage->GetResources()->GetDictionary().GetKey( "XObject" );
+    CPPUNIT_ASSERT( pXObjects != nullptr );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>( 2 ), pXObjects->GetDictionary().GetSize() );
+    CPPUNIT_ASSERT( pXObjects->GetDictionary().GetKey( xObj1.GetIdentifier() )->GetReference() == xObj1.GetObjectReference() );
+    CPPUNIT_ASSERT( pXObjects->GetDictionary().GetKey( xObj2.GetIdentifier() )->GetReference() == xObj2.GetObjectReference() );
+}
@@ -34,6 +34,8 @@ class PainterTest : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE( PainterTest );
   CPPUNIT_TEST( testAppend );
+  CPPUNIT_TEST( testIncremental );
+  CPPUNIT_TEST( testResources );
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -46,6 +48,18 @@ class PainterTest : public CppUnit::TestFixture
    */
   void testAppend();
 
+  /**
+   * Test that content appended while drawing
+   * matches the content appended at the end
+   */
+  void testIncremental();
+
+  /**
+   * Test that resources used many times are
+   * registered once in the page resources
+   */
+  void testResources();
+
  private:
   /**
    * Compare the filtered contents of a PdfStream object
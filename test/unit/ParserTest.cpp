@@ -31,6 +31,7 @@
 */
 
 #include "ParserTest.h"
+#include "TestUtils.h"
 
 #include <cppunit/Asserter.h>
 
@@ -2109,4 +2110,320 @@ bool ParserTest::canOutOfMemoryKillUnitTests()
     return bCanTerminateProcess;
 }
 
+void ParserTest::testParallelReadObjects()
+{
+    // Objects parsed by multiple threads must match
+    // the ones parsed by the calling thread
+    const int nObjects = 300;
+    std::string buffer = TestUtils::createObjectsPdf( nObjects );
+
+    PoDoFo::PdfMemDocument sequentialDoc( true );
+    PoDoFo::PdfParser sequentialParser( sequentialDoc.GetObjects() );
+    sequentialParser.ParseBuffer( buffer, false );
+
+    PoDoFo::PdfMemDocument parallelDoc( true );
+    PoDoFo::PdfParser parallelParser( parallelDoc.GetObjects() );
+    parallelParser.SetLoadThreadCount( 4 );
+    parallelParser.ParseBuffer( buffer, false );
+
+    for ( int i = 1; i < nObjects; i++ )
+    {
+        PoDoFo::PdfReference ref( i, 0 );
+        PoDoFo::PdfObject* pSequential = sequentialDoc.GetObjects().GetObject( ref );
+        PoDoFo::PdfObject* pParallel = parallelDoc.GetObjects().GetObject( ref );
+        CPPUNIT_ASSERT( pSequential != nullptr );
+        CPPUNIT_ASSERT( pParallel != nullptr );
+
+        std::string sequential;
+        std::string parallel;
+        pSequential->ToString( sequential );
+        pParallel->ToString( parallel );
+        CPPUNIT_ASSERT_EQUAL( sequential, parallel );
+    }
+}
+
+void ParserTest::testDelayedObjectStream()
+{
+    // Objects 2 and 3 are in the object stream 4, object 3 with a wrong index
+    std::ostringstream oss;
+    oss << "%PDF-1.5\n";
+    // The trailer is searched in the last 512 bytes
+    oss << "%" << std::string( 512, 'x' ) << "\n";
+    size_t catalogPos = static_cast<size_t>(oss.tellp());
+    oss << "1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n";
+
+    std::string objects = "<< /Type /Pages /Kids [] /Count 0 >> << /Value 42 >>";
+    std::string header = "2 0 3 36 ";
+    size_t streamPos = static_cast<size_t>(oss.tellp());
+    oss << "4 0 obj\n<< /Type /ObjStm /N 2 /First " << header.length()
+        << " /Length " << header.length() + objects.length() << " >>\nstream\n"
+        << header << objects << "\nendstream\nendobj\n";
+
+    size_t xrefPos = static_cast<size_t>(oss.tellp());
+    std::string entries;
+    auto addEntry = [&entries]( int type, size_t field2, int field3 )
+    {
+        entries.push_back( static_cast<char>(type) );
+        entries.push_back( static_cast<char>((field2 >> 8) & 0xFF) );
+        entries.push_back( static_cast<char>(field2 & 0xFF) );
+        entries.push_back( static_cast<char>(field3) );
+    };
+    addEntry( 0, 0, 0 );
+    addEntry( 1, catalogPos, 0 );
+    addEntry( 2, 4, 0 );
+    addEntry( 2, 4, 0 );
+    addEntry( 1, streamPos, 0 );
+    addEntry( 1, xrefPos, 0 );
+    oss << "5 0 obj\n<< /Type /XRef /Size 6 /W [ 1 2 1 ] /Root 1 0 R /Length " << entries.length() << " >>\nstream\n"
+        << entries << "\nendstream\nendobj\n";
+    oss << "startxref\n" << xrefPos << "\n%%EOF\n";
+
+    PoDoFo::PdfMemDocument doc;
+    doc.LoadFromBuffer( oss.str() );
+
+    // The object stream can be removed before its objects are read
+    doc.GetObjects().RemoveObject( PoDoFo::PdfReference( 4, 0 ) );
+
+    PoDoFo::PdfObject* pObj = doc.GetObjects().GetObject( PoDoFo::PdfReference( 3, 0 ) );
+    CPPUNIT_ASSERT( pObj != nullptr );
+    CPPUNIT_ASSERT( !pObj->DelayedLoadDone() );
+    CPPUNIT_ASSERT_EQUAL( pObj->GetDictionary().GetKeyAsNumber( "Value" ), static_cast<int64_t>(42) );
+    CPPUNIT_ASSERT( pObj->DelayedLoadDone() );
+
+    pObj = doc.GetObjects().GetObject( PoDoFo::PdfReference( 2, 0 ) );
+    CPPUNIT_ASSERT( pObj != nullptr );
+    CPPUNIT_ASSERT( pObj->GetDictionary().GetKey( "Type" )->GetName() == PoDoFo::PdfName( "Pages" ) );
+}
+
+void ParserTest::testWriteObjectStreams()
+{
+    // Objects packed in object streams must be read back unchanged
+    PoDoFo::PdfMemDocument doc;
+    std::vector<PoDoFo::PdfReference> refs;
+    for ( int i = 0; i < 250; i++ )
+    {
+        PoDoFo::PdfObject* pObj = doc.GetObjects().CreateDictionaryObject();
+        pObj->GetDictionary().AddKey( "Index", static_cast<int64_t>(i) );
+        pObj->GetDictionary().AddKey( "Name", PoDoFo::PdfString( "str" + std::to_string( i ) ) );
+        refs.push_back( pObj->GetIndirectReference() );
+    }
+
+    // Objects with streams are still written as indirect objects
+    PoDoFo::PdfObject* pStreamObj = doc.GetObjects().CreateDictionaryObject();
+    pStreamObj->GetOrCreateStream().Set( "stream data" );
+    refs.push_back( pStreamObj->GetIndirectReference() );
+
+    size_t nObjectCount = doc.GetObjects().GetObjectCount();
+    PoDoFo::PdfRefCountedBuffer buffer;
+    PoDoFo::PdfOutputDevice device( &buffer );
+    doc.Write( device, PoDoFo::PdfSaveOptions::ObjectStreams );
+    std::string output( buffer.GetBuffer(), device.GetLength() );
+    CPPUNIT_ASSERT( output.find( "/ObjStm" ) != std::string::npos );
+
+    // The numbers of the object streams are released after writing,
+    // only the XRef stream object is left in the document
+    CPPUNIT_ASSERT_EQUAL( nObjectCount + 1, doc.GetObjects().GetObjectCount() );
+    CPPUNIT_ASSERT( output.find( "/XRef" ) != std::string::npos );
+
+    PoDoFo::PdfMemDocument loaded;
+    loaded.LoadFromBuffer( output );
+    for ( auto& ref : refs )
+    {
+        PoDoFo::PdfObject* pObj = doc.GetObjects().GetObject( ref );
+        PoDoFo::PdfObject* pLoaded = loaded.GetObjects().GetObject( ref );
+        CPPUNIT_ASSERT( pLoaded != nullptr );
+
+        if ( pObj->HasStream() )
+        {
+            CPPUNIT_ASSERT( pLoaded->HasStream() );
+            continue;
+        }
+
+        std::string expected;
+        std::string actual;
+        pObj->ToString( expected );
+        pLoaded->ToString( actual );
+        CPPUNIT_ASSERT_EQUAL( expected, actual );
+    }
+
+    std::unique_ptr<char> streamData;
+    size_t lLength;
+    loaded.GetObjects().GetObject( pStreamObj->GetIndirectReference() )->GetOrCreateStream().GetFilteredCopy( streamData, lLength );
+    CPPUNIT_ASSERT_EQUAL( std::string( "stream data" ), std::string( streamData.get(), lLength ) );
+}
+
+void ParserTest::testWriteParallelCompression()
+{
+    // The last stream is large enough to be split in blocks
+    std::vector<std::string> contents;
+    for ( int i = 0; i < 40; i++ )
+    {
+        std::string data;
+        int nLines = i == 39 ? 300000 : 100 * i;
+        for ( int j = 0; j < nLines; j++ )
+            data += std::to_string( j * 7919 % 10007 ) + " " + std::to_string( i ) + " m\n";
+        contents.push_back( data );
+    }
+
+    auto fillDocument = [&]( PoDoFo::PdfMemDocument& doc, std::vector<PoDoFo::PdfReference>& refs )
+    {
+        for ( auto& data : contents )
+        {
+            PoDoFo::PdfObject* pObj = doc.GetObjects().CreateDictionaryObject();
+            pObj->GetOrCreateStream().Set( data );
+            refs.push_back( pObj->GetIndirectReference() );
+        }
+    };
 
+    auto write = []( PoDoFo::PdfMemDocument& doc, PoDoFo::PdfSaveOptions options )
+    {
+        PoDoFo::PdfRefCountedBuffer buffer;
+        PoDoFo::PdfOutputDevice device( &buffer );
+        doc.Write( device, options );
+        return std::string( buffer.GetBuffer(), device.GetLength() );
+    };
+
+    std::vector<PoDoFo::PdfReference> refs;
+    PoDoFo::PdfMemDocument serialDoc;
+    fillDocument( serialDoc, refs );
+    std::string serial = write( serialDoc, PoDoFo::PdfSaveOptions::ObjectStreams );
+
+    // Deferred streams encoded in parallel are identical to the ones encoded immediately.
+    // The creation date is copied, as the documents may be created in different seconds
+    PoDoFo::PdfMemDocument parallelDoc;
+    parallelDoc.GetObjects().SetDeferStreamEncoding( true );
+    fillDocument( parallelDoc, refs );
+    const PoDoFo::PdfObject* pDate = serialDoc.GetInfo().GetObject()->GetDictionary().GetKey( "CreationDate" );
+    CPPUNIT_ASSERT( pDate != nullptr );
+    parallelDoc.GetInfo().GetObject()->GetDictionary().AddKey( "CreationDate", *pDate );
+    std::string parallel = write( parallelDoc, PoDoFo::PdfSaveOptions::ObjectStreams | PoDoFo::PdfSaveOptions::ParallelCompression );
+    CPPUNIT_ASSERT( serial.substr( 0, serial.find( "/ID" ) ) == parallel.substr( 0, parallel.find( "/ID" ) ) );
+
+    PoDoFo::PdfMemDocument splitDoc;
+    splitDoc.GetObjects().SetDeferStreamEncoding( true );
+    fillDocument( splitDoc, refs );
+
+    // A copy of a deferred stream is encoded independently of it
+    PoDoFo::PdfObject* pCopy = splitDoc.GetObjects().CreateDictionaryObject();
+    *pCopy = *splitDoc.GetObjects().GetObject( refs[0] );
+    PoDoFo::PdfReference copyRef = pCopy->GetIndirectReference();
+    std::string split = write( splitDoc, PoDoFo::PdfSaveOptions::ParallelCompression | PoDoFo::PdfSaveOptions::SplitFlateStreams );
+
+    PoDoFo::PdfMemDocument loaded;
+    loaded.LoadFromBuffer( split );
+    for ( size_t i = 0; i < contents.size(); i++ )
+    {
+        std::unique_ptr<char> streamData;
+        size_t lLength;
+        loaded.GetObjects().GetObject( refs[i] )->GetOrCreateStream().GetFilteredCopy( streamData, lLength );
+        CPPUNIT_ASSERT( contents[i] == std::string( streamData.get(), lLength ) );
+    }
+
+    std::unique_ptr<char> copyData;
+    size_t lCopyLength;
+    loaded.GetObjects().GetObject( copyRef )->GetOrCreateStream().GetFilteredCopy( copyData, lCopyLength );
+    CPPUNIT_ASSERT( contents[0] == std::string( copyData.get(), lCopyLength ) );
+}
+
+void ParserTest::testObjectLookup()
+{
+    // Lookups must stay consistent while objects are added
+    // out of order, replaced and removed
+    PoDoFo::PdfMemDocument doc;
+    PoDoFo::PdfVecObjects& objects = doc.GetObjects();
+    size_t nInitialSize = objects.GetSize();
+    for ( int i = 0; i < 100; i++ )
+    {
+        PoDoFo::PdfObject* pObj = objects.CreateObject( PoDoFo::PdfVariant( static_cast<int64_t>(i) ) );
+        CPPUNIT_ASSERT( objects.GetObject( pObj->GetIndirectReference() ) == pObj );
+    }
+
+    PoDoFo::PdfReference removed( 50, 0 );
+    CPPUNIT_ASSERT( objects.RemoveObject( removed ) != nullptr );
+    CPPUNIT_ASSERT( objects.GetObject( removed ) == nullptr );
+    CPPUNIT_ASSERT( objects.RemoveObject( removed ) == nullptr );
+
+    // The removed number is reused with an incremented generation
+    PoDoFo::PdfObject* pReused = objects.CreateObject( PoDoFo::PdfVariant( true ) );
+    CPPUNIT_ASSERT( pReused->GetIndirectReference() == PoDoFo::PdfReference( 50, 1 ) );
+    CPPUNIT_ASSERT( objects.GetObject( PoDoFo::PdfReference( 50, 1 ) ) == pReused );
+    CPPUNIT_ASSERT( objects.GetObject( removed ) == nullptr );
+
+    // Numbers beyond the highest object are not found
+    CPPUNIT_ASSERT( objects.GetObject( PoDoFo::PdfReference( 100000, 0 ) ) == nullptr );
+    CPPUNIT_ASSERT_EQUAL( nInitialSize + 100, objects.GetSize() );
+
+    // Iteration is ordered by reference
+    const PoDoFo::PdfObject* pPrevious = nullptr;
+    for ( const PoDoFo::PdfObject* pObj : objects )
+    {
+        if ( pPrevious != nullptr )
+            CPPUNIT_ASSERT( *pPrevious < *pObj );
+
+        pPrevious = pObj;
+    }
+}
+
+void ParserTest::testMemoryArena()
+{
+    PoDoFo::PdfMemoryArena arena( 1024 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(0), arena.GetBlockCount() );
+    void* pFirst = arena.Allocate( 3 );
+    void* pSecond = arena.Allocate( 5 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(1), arena.GetBlockCount() );
+    CPPUNIT_ASSERT( reinterpret_cast<uintptr_t>(pFirst) % alignof(std::max_align_t) == 0 );
+    CPPUNIT_ASSERT( reinterpret_cast<uintptr_t>(pSecond) % alignof(std::max_align_t) == 0 );
+    CPPUNIT_ASSERT( pFirst != pSecond );
+
+    // Big allocations get their own block
+    void* pBig = arena.Allocate( 4096 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(2), arena.GetBlockCount() );
+    CPPUNIT_ASSERT( arena.Contains( pSecond ) );
+    CPPUNIT_ASSERT( arena.Contains( static_cast<char*>(pBig) + 4095 ) );
+    CPPUNIT_ASSERT( !arena.Contains( &arena ) );
+    arena.Reset();
+    CPPUNIT_ASSERT_EQUAL( static_cast<size_t>(0), arena.GetBlockCount() );
+
+    // Objects parsed into the arena must match the heap allocated ones
+    const int nObjects = 100;
+    std::string buffer = TestUtils::createObjectsPdf( nObjects );
+
+    PoDoFo::PdfMemDocument heapDoc( true );
+    PoDoFo::PdfParser heapParser( heapDoc.GetObjects() );
+    heapParser.ParseBuffer( buffer, false );
+
+    // An object removed from the arena document outlives the arena
+    std::unique_ptr<PoDoFo::PdfObject> pRemoved;
+    std::string expected;
+    {
+        PoDoFo::PdfMemDocument arenaDoc( true );
+        arenaDoc.GetObjects().SetUseMemoryArena( true );
+        PoDoFo::PdfParser arenaParser( arenaDoc.GetObjects() );
+        arenaParser.SetLoadThreadCount( 4 );
+        arenaParser.ParseBuffer( buffer, false );
+
+        for ( int i = 1; i < nObjects; i++ )
+        {
+            PoDoFo::PdfReference ref( i, 0 );
+            PoDoFo::PdfObject* pHeap = heapDoc.GetObjects().GetObject( ref );
+            PoDoFo::PdfObject* pArena = arenaDoc.GetObjects().GetObject( ref );
+            CPPUNIT_ASSERT( pHeap != nullptr );
+            CPPUNIT_ASSERT( pArena != nullptr );
+
+            std::string heapStr;
+            std::string arenaStr;
+            pHeap->ToString( heapStr );
+            pArena->ToString( arenaStr );
+            CPPUNIT_ASSERT_EQUAL( heapStr, arenaStr );
+        }
+
+        arenaDoc.GetObjects().GetObject( PoDoFo::PdfReference( 1, 0 ) )->ToString( expected );
+        pRemoved = arenaDoc.GetObjects().RemoveObject( PoDoFo::PdfReference( 1, 0 ) );
+        CPPUNIT_ASSERT( arenaDoc.GetObjects().GetObject( PoDoFo::PdfReference( 1, 0 ) ) == nullptr );
+        CPPUNIT_ASSERT( pRemoved->GetIndirectReference() == PoDoFo::PdfReference( 1, 0 ) );
+    }
+
+    std::string removed;
+    pRemoved->ToString( removed );
+    CPPUNIT_ASSERT_EQUAL( expected, removed );
+}
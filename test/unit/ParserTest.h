@@ -42,6 +42,12 @@ class ParserTest : public CppUnit::TestFixture
     CPPUNIT_TEST( testReadObjects );
     CPPUNIT_TEST( testIsPdfFile );
     CPPUNIT_TEST( testRoundTripIndirectTrailerID );
+    CPPUNIT_TEST( testParallelReadObjects );
+    CPPUNIT_TEST( testDelayedObjectStream );
+    CPPUNIT_TEST( testWriteObjectStreams );
+    CPPUNIT_TEST( testWriteParallelCompression );
+    CPPUNIT_TEST( testObjectLookup );
+    CPPUNIT_TEST( testMemoryArena );
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -79,6 +85,12 @@ public:
     //void testCheckEOFMarker();
 
     void testRoundTripIndirectTrailerID();
+    void testParallelReadObjects();
+    void testDelayedObjectStream();
+    void testWriteObjectStreams();
+    void testWriteParallelCompression();
+    void testObjectLookup();
+    void testMemoryArena();
 
 private:
     std::string generateXRefEntries( size_t count );
@@ -391,4 +391,44 @@ void StringTest::testInitFromUtf8()
     
 }
 
+void StringTest::testShortAndLongStrings()
+{
+    // Short strings are stored inline, long ones in a shared buffer
+    const PdfString shortStr( "Short" );
+    const PdfString longStr( "A string which is too long to be stored inline" );
+
+    // Copies share the buffer in both cases, and the original
+    // keeps pointing to its own data
+    const char* pszShort = shortStr.GetString();
+    PdfString shortCopy( shortStr );
+    PdfString longCopy( longStr );
+    CPPUNIT_ASSERT( shortCopy == shortStr );
+    CPPUNIT_ASSERT( longCopy == longStr );
+    CPPUNIT_ASSERT( shortStr.GetString() == pszShort );
+    CPPUNIT_ASSERT( shortCopy.GetString() == PdfString( shortCopy ).GetString() );
+    CPPUNIT_ASSERT( longCopy.GetString() == longStr.GetString() );
+    CPPUNIT_ASSERT( longStr < shortStr );
+    CPPUNIT_ASSERT( shortStr > longStr );
+
+    // Pointers taken from a temporary copy live as long as the original
+    const char* pszTemporary = PdfString( shortStr ).GetString();
+    CPPUNIT_ASSERT_EQUAL( std::string( "Short" ), std::string( pszTemporary ) );
+
+    shortCopy = longStr;
+    CPPUNIT_ASSERT( shortCopy == longStr );
+    longCopy = shortStr;
+    CPPUNIT_ASSERT( longCopy == shortStr );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Short" ), longCopy.GetStringUtf8() );
+
+    // Moved strings keep their contents
+    PdfString moved( PdfString( "Moved" ) );
+    CPPUNIT_ASSERT( moved == PdfString( "Moved" ) );
+    moved = PdfString( "A moved string which is too long to be stored inline" );
+    CPPUNIT_ASSERT_EQUAL( std::string( "A moved string which is too long to be stored inline" ),
+                          moved.GetStringUtf8() );
+
+    // Unicode and non unicode strings still compare by contents
+    CPPUNIT_ASSERT( PdfString( reinterpret_cast<const pdf_utf8*>( "Short" ) ) == shortStr );
+}
+
 #endif // __clang__
@@ -39,6 +39,7 @@ class StringTest : public CppUnit::TestFixture
     CPPUNIT_TEST( testWriteEscapeSequences );
     CPPUNIT_TEST( testEmptyString );
     CPPUNIT_TEST( testInitFromUtf8 );
+    CPPUNIT_TEST( testShortAndLongStrings );
     CPPUNIT_TEST_SUITE_END();
 
 
@@ -55,6 +56,7 @@ class StringTest : public CppUnit::TestFixture
     void testWriteEscapeSequences();
     void testEmptyString();
     void testInitFromUtf8();
+    void testShortAndLongStrings();
     
  private:
     void TestWriteEscapeSequences(const char* pszSource, const char* pszExpected);
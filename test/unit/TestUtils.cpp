@@ -23,6 +23,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <sstream>
+#include <vector>
+
 #if defined(_WIN32) || defined(_WIN64)
 #include <windows.h>
 
@@ -80,4 +83,29 @@ char* TestUtils::readDataFile( const char* pszFilename )
     return pBuffer;
 }
 
+std::string TestUtils::createObjectsPdf( int nObjects )
+{
+    std::ostringstream oss;
+    oss << "%PDF-1.4\n";
+    std::vector<size_t> objPos;
+    for ( int i = 1; i < nObjects; i++ )
+    {
+        objPos.push_back( static_cast<size_t>(oss.tellp()) );
+        oss << i << " 0 obj\n";
+        oss << "<< /Index " << i << " /Name /Obj" << i << " /Values [ " << (i % 7) << " 0 R (str" << i << ") 1.5 ] >>\n";
+        oss << "endobj\n";
+    }
 
+    size_t nXrefPos = static_cast<size_t>(oss.tellp());
+    oss << "xref\n0 " << nObjects << "\n";
+    oss << "0000000000 65535 f \n";
+    char objRec[21];
+    for ( size_t pos : objPos )
+    {
+        snprintf( objRec, 21, "%010d 00000 n \n", static_cast<int>(pos) );
+        oss << objRec;
+    }
+    oss << "trailer << /Size " << nObjects << " /Root 1 0 R >>\n";
+    oss << "startxref\n" << nXrefPos << "\n%%EOF\n";
+    return oss.str();
+}
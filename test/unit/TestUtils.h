@@ -39,6 +39,14 @@ public:
      * @param pszFilename filename of the data file. The path will be determined automatically.
      */
     static char* readDataFile( const char* pszFilename );
+
+    /**
+     * Create a PDF with a classic xref table and nObjects - 1 small
+     * dictionaries referencing each other, to test object parsing.
+     *
+     * @param nObjects the size of the xref table
+     */
+    static std::string createObjectsPdf( int nObjects );
 };
 
 #endif // _TEST_UTILS_H_
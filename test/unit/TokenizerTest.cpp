@@ -262,3 +262,188 @@ void TokenizerTest::testLocale()
 
     setlocale( LC_ALL, old );
 }
+
+void TokenizerTest::testSpanTokens()
+{
+    // Span devices must produce the same tokens of stream devices
+    const std::string buffer = "613 0 obj% A comment after a token\r\n"
+        "<< /Length 141 /Ref 12 0 R /Filter\n% A comment in a dictionary\n[ /ASCII85Decode /FlateDecode ] >>"
+        "endobj";
+
+    std::istringstream stream(buffer);
+    PdfRefCountedInputDevice streamDevice(new PdfInputDevice(&stream));
+    PdfRefCountedInputDevice spanDevice(buffer.data(), buffer.length());
+    CPPUNIT_ASSERT(spanDevice.Device()->HasSpan());
+
+    PdfTokenizer streamTokenizer;
+    PdfTokenizer spanTokenizer;
+    std::string_view streamToken;
+    std::string_view spanToken;
+    EPdfTokenType streamType;
+    EPdfTokenType spanType;
+    for (;;)
+    {
+        bool gotStreamToken = streamTokenizer.TryReadNextToken(streamDevice, streamToken, &streamType);
+        bool gotSpanToken = spanTokenizer.TryReadNextToken(spanDevice, spanToken, &spanType);
+        CPPUNIT_ASSERT_EQUAL(gotStreamToken, gotSpanToken);
+        if (!gotStreamToken)
+            break;
+
+        CPPUNIT_ASSERT(streamToken == spanToken);
+        CPPUNIT_ASSERT(streamType == spanType);
+        CPPUNIT_ASSERT_EQUAL(streamDevice.Device()->Tell(), spanDevice.Device()->Tell());
+    }
+
+    // Numbers are parsed without a null terminator
+    const std::string numbers = "12 -7 +5 R";
+    PdfRefCountedInputDevice numbersDevice(numbers.data(), numbers.length() - 2);
+    PdfTokenizer tokenizer;
+    CPPUNIT_ASSERT_EQUAL(tokenizer.ReadNextNumber(numbersDevice), (int64_t)12);
+    CPPUNIT_ASSERT_EQUAL(tokenizer.ReadNextNumber(numbersDevice), (int64_t)-7);
+    CPPUNIT_ASSERT_EQUAL(tokenizer.ReadNextNumber(numbersDevice), (int64_t)5);
+}
+
+void TokenizerTest::testStreamingContents()
+{
+    // Contents larger than the buffers of the streaming device,
+    // split in two streams and with inline image data at the end
+    std::string contents1;
+    for (int i = 0; i < 5000; i++)
+        contents1 += "1 0 0 1 " + std::to_string(i) + " 20 cm (a string) Tj [1 (b) 2] TJ\n";
+    const std::string contents2 = "BI /W 2 /H 2 /BPC 8 /CS /G ID \x01\x02EIx\x04 EI Q\n";
+
+    std::string pdf;
+    {
+        PdfMemDocument doc;
+        PdfPage* pPage = doc.CreatePage(PdfPage::CreateStandardPageSize(EPdfPageSize::A4));
+        PdfArray contents;
+        for (const std::string& rContents : std::vector<std::string>{ contents1, contents2 })
+        {
+            PdfObject* pStream = doc.GetObjects().CreateDictionaryObject();
+            pStream->GetOrCreateStream().Set(rContents);
+            contents.push_back(pStream->GetIndirectReference());
+        }
+        pPage->GetObject()->GetDictionary().AddKey("Contents", contents);
+
+        PdfRefCountedBuffer buffer;
+        PdfOutputDevice device(&buffer);
+        doc.Write(device);
+        pdf.assign(buffer.GetBuffer(), buffer.GetSize());
+    }
+
+    PdfMemDocument doc;
+    doc.LoadFromBuffer(pdf);
+    PdfContentsTokenizer streamingTokenizer(*doc.GetPage(0));
+
+    // The same contents read from one memory buffer
+    const std::string buffer = contents1 + contents2;
+    PdfContentsTokenizer bufferTokenizer(PdfRefCountedInputDevice(buffer.data(), buffer.length()));
+
+    EPdfContentsType streamingType;
+    EPdfContentsType bufferType;
+    std::string_view streamingKeyword;
+    std::string_view bufferKeyword;
+    PdfVariant streamingVariant;
+    PdfVariant bufferVariant;
+    size_t lCount = 0;
+    for (;;)
+    {
+        bool gotStreaming = streamingTokenizer.TryReadNext(streamingType, streamingKeyword, streamingVariant);
+        bool gotBuffer = bufferTokenizer.TryReadNext(bufferType, bufferKeyword, bufferVariant);
+        CPPUNIT_ASSERT_EQUAL(gotBuffer, gotStreaming);
+        if (!gotBuffer)
+            break;
+
+        CPPUNIT_ASSERT(streamingType == bufferType);
+        if (bufferType == EPdfContentsType::Keyword)
+        {
+            CPPUNIT_ASSERT(streamingKeyword == bufferKeyword);
+        }
+        else
+        {
+            std::string streamingData;
+            std::string bufferData;
+            streamingVariant.ToString(streamingData);
+            bufferVariant.ToString(bufferData);
+            CPPUNIT_ASSERT_EQUAL(bufferData, streamingData);
+        }
+
+        lCount++;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5000 * 11 + 13), lCount);
+}
+
+void TokenizerTest::testContentsOperations()
+{
+    const std::string buffer = "q 1 0 0 1 10.5 -20 cm /F#311 12 Tf [(a\\051b) -120 <414243>] TJ "
+        "/P <</MCID 0>> BDC EMC BI /W 1 ID \x01 EI true null foo Q";
+    PdfContentsTokenizer tokenizer(PdfRefCountedInputDevice(buffer.data(), buffer.length()));
+    PdfContentsOperation op;
+
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::q);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), op.OperandCount);
+
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::cm);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), op.OperandCount);
+    CPPUNIT_ASSERT(op.Operands[0].Type == EPdfContentsOperandType::Number);
+    CPPUNIT_ASSERT_EQUAL(1.0, op.Operands[0].Number);
+    CPPUNIT_ASSERT_EQUAL(10.5, op.Operands[4].Number);
+    CPPUNIT_ASSERT_EQUAL(-20.0, op.Operands[5].Number);
+
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::Tf);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), op.OperandCount);
+    CPPUNIT_ASSERT(op.Operands[0].Type == EPdfContentsOperandType::Name);
+    CPPUNIT_ASSERT(op.Operands[0].Data == "F11");
+    CPPUNIT_ASSERT_EQUAL(12.0, op.Operands[1].Number);
+
+    // Arrays are flattened
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::TJ);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), op.OperandCount);
+    CPPUNIT_ASSERT(op.Operands[0].Type == EPdfContentsOperandType::ArrayStart);
+    CPPUNIT_ASSERT(op.Operands[1].Type == EPdfContentsOperandType::String);
+    CPPUNIT_ASSERT(op.Operands[1].Data == "a)b");
+    CPPUNIT_ASSERT_EQUAL(-120.0, op.Operands[2].Number);
+    CPPUNIT_ASSERT(op.Operands[3].Type == EPdfContentsOperandType::HexString);
+    CPPUNIT_ASSERT(op.Operands[3].Data == "ABC");
+    CPPUNIT_ASSERT(op.Operands[4].Type == EPdfContentsOperandType::ArrayEnd);
+
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::BDC);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), op.OperandCount);
+    CPPUNIT_ASSERT(op.Operands[0].Data == "P");
+    CPPUNIT_ASSERT(op.Operands[1].Type == EPdfContentsOperandType::DictionaryStart);
+    CPPUNIT_ASSERT(op.Operands[2].Data == "MCID");
+    CPPUNIT_ASSERT(op.Operands[4].Type == EPdfContentsOperandType::DictionaryEnd);
+
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::EMC);
+
+    // Inline images
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::BI);
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::ID);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), op.OperandCount);
+    // The data keeps the whitespace before EI, as in TryReadNext()
+    CPPUNIT_ASSERT(op.ImageData == "\x01 ");
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::EI);
+
+    // Unknown operators are returned as well
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::Unknown);
+    CPPUNIT_ASSERT(op.Keyword == "foo");
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), op.OperandCount);
+    CPPUNIT_ASSERT(op.Operands[0].Type == EPdfContentsOperandType::Bool);
+    CPPUNIT_ASSERT_EQUAL(1.0, op.Operands[0].Number);
+    CPPUNIT_ASSERT(op.Operands[1].Type == EPdfContentsOperandType::Null);
+
+    CPPUNIT_ASSERT(tokenizer.TryReadNextOperation(op));
+    CPPUNIT_ASSERT(op.Operator == EPdfContentsOperator::Q);
+    CPPUNIT_ASSERT(!tokenizer.TryReadNextOperation(op));
+}
@@ -47,6 +47,9 @@ class TokenizerTest : public CppUnit::TestFixture
   CPPUNIT_TEST( testComments );
   CPPUNIT_TEST( testDictionary );
   CPPUNIT_TEST( testLocale );
+  CPPUNIT_TEST( testSpanTokens );
+  CPPUNIT_TEST( testStreamingContents );
+  CPPUNIT_TEST( testContentsOperations );
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -68,6 +71,12 @@ class TokenizerTest : public CppUnit::TestFixture
 
   void testLocale();
 
+  void testSpanTokens();
+
+  void testStreamingContents();
+
+  void testContentsOperations();
+
  private:
   void Test( const char* pszString, PoDoFo::EPdfDataType eDataType, const char* pszExpected = NULL );
 
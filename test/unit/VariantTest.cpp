@@ -253,3 +253,86 @@ void VariantTest::testIsDirtyFalse()
     CPPUNIT_ASSERT_EQUAL( static_cast<long>(pStream->GetLength()), 9381L );
     CPPUNIT_ASSERT_EQUAL_MESSAGE( "STREAM    IsDirty() == false", false, parser.IsDirty() );
 }
+
+void VariantTest::testDictionaryKeys()
+{
+    PdfObject obj;
+    PdfDictionary& dict = obj.GetDictionary();
+    PdfObject* pInnerObj = &dict.AddKey( "M", PdfDictionary() );
+    PdfDictionary& inner = pInnerObj->GetDictionary();
+    inner.AddKey( "Key", PdfName( "Value" ) );
+
+    // Add enough keys, in no particular order, to force the storage to grow
+    const char* keys[] = { "Z", "A", "Type", "K", "B", "Y", "C", "X", "D", "W" };
+    for ( const char* key : keys )
+        dict.AddKey( key, PdfObject( static_cast<int64_t>( key[0] ) ) );
+
+    CPPUNIT_ASSERT_EQUAL( dict.GetSize(), static_cast<size_t>( 11 ) );
+
+    // Keys are iterated in sorted order and keep ownership
+    const PdfName* prev = nullptr;
+    for ( auto& pair : dict )
+    {
+        if ( prev != nullptr )
+            CPPUNIT_ASSERT( *prev < pair.first );
+
+        CPPUNIT_ASSERT( pair.second->GetParent() == &dict );
+        prev = &pair.first;
+    }
+
+    // Values keep their address when keys are added or removed
+    CPPUNIT_ASSERT( dict.GetKey( "M" ) == pInnerObj );
+    CPPUNIT_ASSERT( &dict.MustGetKey( "M" ).GetDictionary() == &inner );
+    CPPUNIT_ASSERT( inner.GetKey( "Key" )->GetName() == PdfName( "Value" ) );
+    CPPUNIT_ASSERT( dict.MustGetKey( "M" ).GetDictionary().GetOwner() == dict.GetKey( "M" ) );
+
+    // Replacing a key doesn't change the size
+    dict.AddKey( "K", PdfName( "Replaced" ) );
+    CPPUNIT_ASSERT_EQUAL( dict.GetSize(), static_cast<size_t>( 11 ) );
+    CPPUNIT_ASSERT( dict.GetKey( "K" )->GetName() == PdfName( "Replaced" ) );
+
+    CPPUNIT_ASSERT( dict.RemoveKey( "A" ) );
+    CPPUNIT_ASSERT( !dict.RemoveKey( "A" ) );
+    CPPUNIT_ASSERT( !dict.HasKey( "A" ) );
+    CPPUNIT_ASSERT( dict.HasKey( "B" ) );
+    CPPUNIT_ASSERT( dict.GetKey( "M" ) == pInnerObj );
+    CPPUNIT_ASSERT( dict.GetKey( "Missing" ) == nullptr );
+
+    // Type is still written first
+    std::string str;
+    obj.ToString( str, EPdfWriteMode::Compact );
+    CPPUNIT_ASSERT_EQUAL( str.find( "<</Type" ), static_cast<size_t>( 0 ) );
+}
+
+void VariantTest::testWriteNumbers()
+{
+    std::string str;
+    PdfVariant( static_cast<int64_t>(-1234567890123LL) ).ToString( str );
+    CPPUNIT_ASSERT_EQUAL( std::string("-1234567890123"), str );
+
+    PdfVariant( 3.14159265 ).ToString( str );
+    CPPUNIT_ASSERT_EQUAL( std::string("3.141593"), str );
+    PdfVariant( 3.14159265 ).ToString( str, EPdfWriteMode::Compact );
+    CPPUNIT_ASSERT_EQUAL( std::string(" 3.141593"), str );
+    PdfVariant( 2.5 ).ToString( str, EPdfWriteMode::Compact );
+    CPPUNIT_ASSERT_EQUAL( std::string(" 2.5"), str );
+    PdfVariant( 2.0 ).ToString( str, EPdfWriteMode::Compact );
+    CPPUNIT_ASSERT_EQUAL( std::string(" 2"), str );
+
+    // The precision is a setting of the output device
+    PdfRefCountedBuffer buffer;
+    PdfOutputDevice device( &buffer );
+    device.SetRealPrecision( 2 );
+    PdfVariant( 3.14159265 ).Write( device, EPdfWriteMode::Clean, nullptr );
+    CPPUNIT_ASSERT_EQUAL( std::string("3.14"), std::string( buffer.GetBuffer(), device.GetLength() ) );
+    CPPUNIT_ASSERT_THROW( device.SetRealPrecision( 21 ), PdfError );
+
+    // Writing a document must not change the precision of the device
+    PdfMemDocument doc;
+    doc.SetRealPrecision( 4 );
+    doc.Write( device );
+    CPPUNIT_ASSERT_EQUAL( static_cast<unsigned short>(2), device.GetRealPrecision() );
+
+    PdfVariant( PdfReference( 12, 3 ) ).ToString( str );
+    CPPUNIT_ASSERT_EQUAL( std::string("12 3 R"), str );
+}
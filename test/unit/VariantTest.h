@@ -33,6 +33,8 @@ class VariantTest : public CppUnit::TestFixture
   CPPUNIT_TEST( testNameObject );
   CPPUNIT_TEST( testIsDirtyTrue );
   CPPUNIT_TEST( testIsDirtyFalse );
+  CPPUNIT_TEST( testDictionaryKeys );
+  CPPUNIT_TEST( testWriteNumbers );
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -46,6 +48,10 @@ class VariantTest : public CppUnit::TestFixture
   void testIsDirtyTrue();
   void testIsDirtyFalse();
 
+  void testDictionaryKeys();
+
+  void testWriteNumbers();
+
  private:
 };
 